@@ -6,6 +6,25 @@
 extern "C" {
 #endif
 
+/* Inline cache of a LOAD_ATTR or STORE_ATTR instruction, see ceval.c */
+typedef struct {
+    int ac_kind;		/* how the attribute was found, 0 if unused */
+    unsigned int ac_version;	/* tp_version_tag of the object's type */
+    Py_ssize_t ac_hint;		/* slot in the instance dict or offset of
+				   the __slots__ member */
+    PyObject *ac_descr;		/* borrowed, the attribute on the type */
+    struct _typeobject *ac_descr_type;	/* type of ac_descr if it is a
+					   heap type, else NULL */
+    unsigned int ac_descr_version;	/* tp_version_tag of ac_descr_type */
+} PyAttrCacheEntry;
+
+typedef struct {
+    unsigned int ac_epoch;	/* _PyType_VersionTagEpoch when filled */
+    int ac_size;		/* number of entries */
+    unsigned short *ac_index;	/* entry for each instruction offset */
+    PyAttrCacheEntry ac_entries[1];
+} PyAttrCache;
+
 /* Bytecode object */
 typedef struct {
     PyObject_HEAD
@@ -27,6 +46,9 @@ typedef struct {
 				   Objects/lnotab_notes.txt for details. */
     void *co_zombieframe;     /* for optimization only (see frameobject.c) */
     PyObject *co_weakreflist;   /* to support weakrefs to code objects */
+    unsigned long *co_opcounts; /* executions per instruction offset, only
+                                   while sys.setopcodeprofile() is on */
+    PyAttrCache *co_attrcache;  /* LOAD_ATTR and STORE_ATTR caches */
 } PyCodeObject;
 
 /* Masks for co_flags above */
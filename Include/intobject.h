@@ -61,6 +61,8 @@ PyAPI_FUNC(long) PyOS_strtol(char *, char **, int);
 
 /* free list api */
 PyAPI_FUNC(int) PyInt_ClearFreeList(void);
+PyAPI_FUNC(Py_ssize_t) _PyInt_ReclaimBlocks(void);
+PyAPI_FUNC(PyObject *) _PyInt_BlockStats(void);
 
 /* Convert an integer to the given base.  Returns a string.
    If base is 2, 8 or 16, add the proper prefix '0b', '0o' or '0x'.
@@ -19,6 +19,8 @@ typedef PyObject *(*PyCFunction)(PyObject *, PyObject *);
 typedef PyObject *(*PyCFunctionWithKeywords)(PyObject *, PyObject *,
 					     PyObject *);
 typedef PyObject *(*PyNoArgsFunction)(PyObject *);
+typedef PyObject *(*_PyCFunctionFast)(PyObject *, PyObject **, Py_ssize_t,
+                                     PyObject *);
 
 PyAPI_FUNC(PyCFunction) PyCFunction_GetFunction(PyObject *);
 PyAPI_FUNC(PyObject *) PyCFunction_GetSelf(PyObject *);
@@ -70,6 +72,14 @@ PyAPI_FUNC(PyObject *) PyCFunction_NewEx(PyMethodDef *, PyObject *,
 
 #define METH_COEXIST   0x0040
 
+/* METH_FASTCALL functions are called as func(self, args, nargs, kwnames)
+   with the nargs positional arguments in the C array args, usually the
+   caller's value stack, so no argument tuple has to be built.  kwnames
+   is NULL or a tuple of keyword names whose values follow the positional
+   arguments in args.  It must not be combined with the flags above
+   except METH_CLASS, METH_STATIC and METH_COEXIST. */
+#define METH_FASTCALL  0x0080
+
 typedef struct PyMethodChain {
     PyMethodDef *methods;		/* Methods of this type */
     struct PyMethodChain *link;	/* NULL or base type */
@@ -17,6 +17,9 @@ extern "C" {
 #define PyArg_ParseTupleAndKeywords	_PyArg_ParseTupleAndKeywords_SizeT
 #define PyArg_VaParse			_PyArg_VaParse_SizeT
 #define PyArg_VaParseTupleAndKeywords	_PyArg_VaParseTupleAndKeywords_SizeT
+#define _PyArg_ParseStack		_PyArg_ParseStack_SizeT
+#define _PyArg_ParseTupleAndKeywordsFast	_PyArg_ParseTupleAndKeywordsFast_SizeT
+#define _PyArg_ParseStackAndKeywords	_PyArg_ParseStackAndKeywords_SizeT
 #define Py_BuildValue			_Py_BuildValue_SizeT
 #define Py_VaBuildValue			_Py_VaBuildValue_SizeT
 #else
@@ -32,6 +35,39 @@ PyAPI_FUNC(PyObject *) Py_BuildValue(const char *, ...);
 PyAPI_FUNC(PyObject *) _Py_BuildValue_SizeT(const char *, ...);
 PyAPI_FUNC(int) _PyArg_NoKeywords(const char *funcname, PyObject *kw);
 
+/* Argument parsing for METH_FASTCALL functions */
+PyAPI_FUNC(int) _PyArg_ParseStack(PyObject **, Py_ssize_t, const char *, ...);
+PyAPI_FUNC(int) _PyArg_UnpackStack(PyObject **, Py_ssize_t, const char *,
+                                   Py_ssize_t, Py_ssize_t, ...);
+PyAPI_FUNC(int) _PyArg_NoStackKeywords(const char *funcname,
+                                       PyObject *kwnames);
+
+/* Precompiled keyword argument parser.  The caller only fills in format
+   and keywords, as in
+
+       static const char * const _keywords[] = {"a", "b", NULL};
+       static _PyArg_Parser _parser = {"O|i:func", _keywords, 0};
+
+   The format is checked against the keywords and the keyword names are
+   interned on first use, so later calls neither re-scan the format nor
+   build temporary strings to look the keywords up. */
+typedef struct _PyArg_Parser {
+    const char *format;
+    const char * const *keywords;
+    const char *fname;
+    const char *custom_msg;
+    int min;                /* number of required arguments */
+    int max;                /* number of keywords */
+    PyObject *kwtuple;      /* tuple of the interned keyword names */
+    struct _PyArg_Parser *next;
+} _PyArg_Parser;
+
+PyAPI_FUNC(int) _PyArg_ParseTupleAndKeywordsFast(PyObject *, PyObject *,
+                                                 struct _PyArg_Parser *, ...);
+PyAPI_FUNC(int) _PyArg_ParseStackAndKeywords(PyObject **, Py_ssize_t,
+                                             PyObject *,
+                                             struct _PyArg_Parser *, ...);
+
 PyAPI_FUNC(int) PyArg_VaParse(PyObject *, const char *, va_list);
 PyAPI_FUNC(int) PyArg_VaParseTupleAndKeywords(PyObject *, PyObject *,
                                                   const char *, char **, va_list);
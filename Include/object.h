@@ -87,6 +87,32 @@ whose size is determined when the object is allocated.
 #define PyVarObject_HEAD_INIT(type, size)       \
     PyObject_HEAD_INIT(type) size,
 
+/* Immortal objects have a reference count so large that it never drops
+ * to zero:  Py_INCREF and Py_DECREF leave it alone and the object is never
+ * deallocated.  Shared singletons such as None and the small ints are
+ * immortal, so their headers are never written, caches aren't bounced
+ * between CPUs and forked processes keep sharing the pages that hold them.
+ * Code compiled without the check still works, it just moves the count
+ * around a value far away from zero.  Build with Py_IMMORTAL_OBJECTS=0 to
+ * count references to these objects like to any other.
+ */
+#ifndef Py_IMMORTAL_OBJECTS
+#define Py_IMMORTAL_OBJECTS 1
+#endif
+#if Py_IMMORTAL_OBJECTS
+#define _Py_IMMORTAL_REFCNT ((Py_ssize_t)1 << (8 * SIZEOF_SIZE_T - 2))
+#define _Py_IsImmortal(op) \
+    (((PyObject *)(op))->ob_refcnt >= (_Py_IMMORTAL_REFCNT >> 1))
+#else
+#define _Py_IMMORTAL_REFCNT 1
+#define _Py_IsImmortal(op) 0
+#endif
+
+/* For statically allocated singletons */
+#define PyObject_HEAD_IMMORTAL_INIT(type)       \
+    _PyObject_EXTRA_INIT                        \
+    _Py_IMMORTAL_REFCNT, type,
+
 /* PyObject_VAR_HEAD defines the initial segment of all variable-size
  * container objects.  These end with a declaration of an array with 1
  * element, but enough space is malloc'ed so that the array actually
@@ -454,6 +480,8 @@ PyAPI_FUNC(PyObject *) _PyType_Lookup(PyTypeObject *, PyObject *);
 PyAPI_FUNC(PyObject *) _PyObject_LookupSpecial(PyObject *, char *, PyObject **);
 PyAPI_FUNC(unsigned int) PyType_ClearCache(void);
 PyAPI_FUNC(void) PyType_Modified(PyTypeObject *);
+PyAPI_FUNC(int) _PyType_AssignVersionTag(PyTypeObject *);
+PyAPI_DATA(unsigned int) _PyType_VersionTagEpoch;
 
 /* Generic operations on objects */
 PyAPI_FUNC(int) PyObject_Print(PyObject *, FILE *, int);
@@ -523,6 +551,16 @@ typedef struct {
 } _Py_HashSecret_t;
 PyAPI_DATA(_Py_HashSecret_t) _Py_HashSecret;
 
+#ifdef TABULATION_SEEDED
+/* Tabulation hash tables generated by _PyRandom_Init() */
+#ifndef TABLE_MASK
+#define TABLE_MASK 7
+#endif
+#define _Py_TABULATION_SIZE ((TABLE_MASK + 1) << 8)
+PyAPI_DATA(long *) randlongtable;
+PyAPI_DATA(int *) randinttable;
+#endif
+
 #ifdef Py_DEBUG
 PyAPI_DATA(int) _Py_HashSecret_Initialized;
 #endif
@@ -762,19 +800,33 @@ PyAPI_FUNC(void) _Py_AddToAllObjects(PyObject *, int force);
     (*Py_TYPE(op)->tp_dealloc)((PyObject *)(op)))
 #endif /* !Py_TRACE_REFS */
 
-#define Py_INCREF(op) (                         \
-    _Py_INC_REFTOTAL  _Py_REF_DEBUG_COMMA       \
-    ((PyObject*)(op))->ob_refcnt++)
+/* A function rather than a macro, so that op is evaluated exactly once even
+   with the immortality check in front of the increment. */
+Py_LOCAL_INLINE(void)
+_Py_IncRefInline(PyObject *op)
+{
+    if (!_Py_IsImmortal(op)) {
+        _Py_INC_REFTOTAL  _Py_REF_DEBUG_COMMA
+        op->ob_refcnt++;
+    }
+}
+
+#define Py_INCREF(op) _Py_IncRefInline((PyObject *)(op))
 
 #define Py_DECREF(op)                                   \
     do {                                                \
-        if (_Py_DEC_REFTOTAL  _Py_REF_DEBUG_COMMA       \
+        if (_Py_IsImmortal(op))                         \
+            ;                                           \
+        else if (_Py_DEC_REFTOTAL  _Py_REF_DEBUG_COMMA  \
         --((PyObject*)(op))->ob_refcnt != 0)            \
             _Py_CHECK_REFCNT(op)                        \
         else                                            \
         _Py_Dealloc((PyObject *)(op));                  \
     } while (0)
 
+/* Make op immortal; this can't be undone. */
+PyAPI_FUNC(void) _Py_SetImmortal(PyObject *op);
+
 /* Safely decref `op` and set `op` to NULL, especially useful in tp_clear
  * and tp_dealloc implementatons.
  *
@@ -101,6 +101,44 @@ PyAPI_FUNC(void) PyObject_Free(void *);
 
 /* Macros */
 #ifdef WITH_PYMALLOC
+/* State of the small object allocator, see sys._arenastats() */
+#define _PY_ARENASTATS_MAXCLASSES 64
+typedef struct {
+    size_t arena_size;
+    size_t pool_size;
+    int mmap;                   /* arenas come from mmap() */
+    int huge_pages;             /* and are huge page aligned */
+    size_t narenas;
+    size_t cached_pools;        /* free pools waiting for reuse */
+    size_t released_pools;      /* free pools given back to the system */
+    size_t untouched_pools;     /* never used so far */
+    size_t ntimes_pool_released;
+    int nclasses;
+    size_t class_size[_PY_ARENASTATS_MAXCLASSES];
+    size_t class_pools[_PY_ARENASTATS_MAXCLASSES];
+    size_t class_blocks[_PY_ARENASTATS_MAXCLASSES];
+} _PyArenaStats;
+PyAPI_FUNC(void) _PyObject_GetArenaStats(_PyArenaStats *);
+/* Counters of the small object allocator, see sys._mallocstats() */
+typedef struct {
+    size_t small_request_threshold;
+    size_t arena_size;
+    size_t pool_size;
+    size_t narenas;             /* arenas currently allocated */
+    size_t narenas_allocated;   /* arenas ever allocated */
+    size_t narenas_highwater;
+    size_t npools_initialized;  /* pools set up for a size class */
+    size_t npools_emptied;      /* pools whose last block was freed */
+    size_t system_mallocs;      /* requests passed to the system malloc */
+    size_t system_reallocs;
+    size_t system_frees;
+    size_t system_bytes;        /* bytes the requests above asked for */
+    int nclasses;
+    size_t class_size[_PY_ARENASTATS_MAXCLASSES];
+    size_t class_mallocs[_PY_ARENASTATS_MAXCLASSES];
+    size_t class_frees[_PY_ARENASTATS_MAXCLASSES];
+} _PyMallocStats;
+PyAPI_FUNC(void) _PyObject_GetMallocStats(_PyMallocStats *);
 #ifdef PYMALLOC_DEBUG   /* WITH_PYMALLOC && PYMALLOC_DEBUG */
 PyAPI_FUNC(void *) _PyObject_DebugMalloc(size_t nbytes);
 PyAPI_FUNC(void *) _PyObject_DebugRealloc(void *p, size_t nbytes);
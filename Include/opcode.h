@@ -37,12 +37,21 @@ extern "C" {
 
 #define SLICE		30
 /* Also uses 31-33 */
+#define SLICE_1	31
+#define SLICE_2	32
+#define SLICE_3	33
 
 #define STORE_SLICE	40
 /* Also uses 41-43 */
+#define STORE_SLICE_1	41
+#define STORE_SLICE_2	42
+#define STORE_SLICE_3	43
 
 #define DELETE_SLICE	50
 /* Also uses 51-53 */
+#define DELETE_SLICE_1	51
+#define DELETE_SLICE_2	52
+#define DELETE_SLICE_3	53
 
 #define STORE_MAP	54
 #define INPLACE_ADD	55
@@ -150,6 +159,14 @@ extern "C" {
 #define SET_ADD         146
 #define MAP_ADD         147
 
+/* Superinstructions, see Python/peephole.c.  The argument is the one of
+   the first instruction; the second instruction follows unchanged. */
+#define LOAD_FAST_LOAD_FAST     148
+#define LOAD_FAST_LOAD_ATTR     149
+#define LOAD_CONST_RETURN_VALUE 150
+#define COMPARE_OP_POP_JUMP_IF_FALSE 151
+#define LOAD_GLOBAL_CALL_FUNCTION 152
+
 
 enum cmp_op {PyCmp_LT=Py_LT, PyCmp_LE=Py_LE, PyCmp_EQ=Py_EQ, PyCmp_NE=Py_NE, PyCmp_GT=Py_GT, PyCmp_GE=Py_GE,
 	     PyCmp_IN, PyCmp_NOT_IN, PyCmp_IS, PyCmp_IS_NOT, PyCmp_EXC_MATCH, PyCmp_BAD};
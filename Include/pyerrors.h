@@ -81,6 +81,14 @@ PyAPI_FUNC(void) PyErr_Clear(void);
 PyAPI_FUNC(void) PyErr_Fetch(PyObject **, PyObject **, PyObject **);
 PyAPI_FUNC(void) PyErr_Restore(PyObject *, PyObject *, PyObject *);
 
+/* Set an exception of the given type whose value is only built, by calling
+   build(a, b), once PyErr_Fetch() hands it out.  Errors that are tested
+   with PyErr_ExceptionMatches() and cleared never get a value. */
+PyAPI_FUNC(void) _PyErr_SetDeferred(PyObject *,
+                                    PyObject *(*)(PyObject *, PyObject *),
+                                    PyObject *, PyObject *);
+PyAPI_FUNC(void) _PyErr_SetKeyError(PyObject *);
+
 #ifdef Py_DEBUG
 #define _PyErr_OCCURRED() PyErr_Occurred()
 #else
@@ -56,6 +56,32 @@ PyAPI_FUNC(void) PyMem_Free(void *);
 /* Starting from Python 1.6, the wrappers Py_{Malloc,Realloc,Free} are
    no longer supported. They used to call PyErr_NoMemory() on failure. */
 
+/* Allocation tracing.
+
+   When _PyMem_Tracer is set, every block handed out by the PyMem_ and
+   PyObject_ allocators is reported to its alloc() hook, every block given
+   back to its free() hook, and a resize to realloc() with the address the
+   block had (which may already be freed) and its new address.  The
+   tracemalloc module installs it.  The hooks are called with or without
+   the GIL and must not allocate through these allocators.
+
+   Build with Py_TRACEMALLOC=0 to compile the hooks out and to let the
+   PyMem_ macros below call the platform malloc directly again.
+*/
+#ifndef Py_TRACEMALLOC
+#define Py_TRACEMALLOC 1
+#endif
+
+#if Py_TRACEMALLOC
+typedef struct {
+    void (*alloc)(void *ptr, size_t size);
+    void (*realloc)(Py_uintptr_t oldaddr, void *newptr, size_t size);
+    void (*free)(void *ptr);
+} _PyMem_TracerHooks;
+
+PyAPI_DATA(_PyMem_TracerHooks *) _PyMem_Tracer;
+#endif
+
 /* Macros. */
 #ifdef PYMALLOC_DEBUG
 /* Redirect all memory operations to Python's debugging allocator. */
@@ -63,7 +89,13 @@ PyAPI_FUNC(void) PyMem_Free(void *);
 #define PyMem_REALLOC		_PyMem_DebugRealloc
 #define PyMem_FREE		_PyMem_DebugFree
 
-#else	/* ! PYMALLOC_DEBUG */
+#elif Py_TRACEMALLOC
+/* Go through the functions, which report to the allocation tracer. */
+#define PyMem_MALLOC		PyMem_Malloc
+#define PyMem_REALLOC		PyMem_Realloc
+#define PyMem_FREE		PyMem_Free
+
+#else	/* ! PYMALLOC_DEBUG && ! Py_TRACEMALLOC */
 
 /* PyMem_MALLOC(0) means malloc(1). Some systems would return NULL
    for malloc(0), which would be treated as an error. Some platforms
@@ -115,6 +147,24 @@ PyAPI_FUNC(void) PyMem_Free(void *);
 #define PyMem_Del		PyMem_Free
 #define PyMem_DEL		PyMem_FREE
 
+/* Hash tables of dicts and sets.  _PyMem_TableFree() keeps a bounded number
+   of freed tables per byte size, and _PyMem_TableAlloc() hands them out
+   again before asking PyMem_MALLOC.  The table must be freed with the size
+   it was allocated with.  Call with the GIL held.  gc empties the cache
+   when it collects the oldest generation, see sys._tablecachestats(). */
+PyAPI_FUNC(void *) _PyMem_TableAlloc(size_t nbytes);
+PyAPI_FUNC(void) _PyMem_TableFree(void *table, size_t nbytes);
+PyAPI_FUNC(int) _PyMem_ClearTableCache(void);
+typedef struct {
+    size_t hits;                /* allocations served from the cache */
+    size_t misses;              /* and from PyMem_MALLOC */
+    size_t discards;            /* tables freed because the cache was full */
+    size_t ntables;             /* tables cached now */
+    size_t nbytes;
+    size_t max_bytes;
+} _PyTableCacheStats;
+PyAPI_FUNC(void) _PyMem_GetTableCacheStats(_PyTableCacheStats *);
+
 #ifdef __cplusplus
 }
 #endif
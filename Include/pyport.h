@@ -277,6 +277,11 @@ typedef Py_intptr_t     Py_ssize_t;
 #elif defined(USE_INLINE)
 #define Py_LOCAL(type) static type
 #define Py_LOCAL_INLINE(type) static inline type
+#elif defined(__GNUC__)
+/* __inline__ is accepted in every language mode, and an unused inline
+   function in a header draws no warning */
+#define Py_LOCAL(type) static type
+#define Py_LOCAL_INLINE(type) static __inline__ type
 #else
 #define Py_LOCAL(type) static type
 #define Py_LOCAL_INLINE(type) static type
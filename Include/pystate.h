@@ -95,6 +95,10 @@ typedef struct _ts {
     PyObject *async_exc; /* Asynchronous exception to raise */
     long thread_id; /* Thread id where this tstate was created */
 
+    /* Builds curexc_value from curexc_args, see _PyErr_SetDeferred() */
+    PyObject *(*curexc_build)(PyObject *, PyObject *);
+    PyObject *curexc_args[2];
+
     /* XXX signal handlers should also be here */
 
 } PyThreadState;
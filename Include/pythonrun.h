@@ -67,6 +67,12 @@ PyAPI_FUNC(PyObject *) Py_CompileStringFlags(const char *, const char *, int,
                                              PyCompilerFlags *);
 PyAPI_FUNC(struct symtable *) Py_SymtableString(const char *, const char *, int);
 
+/* Cache of the code compiled by Py_CompileStringFlags() and
+   PyRun_StringFlags() */
+PyAPI_FUNC(void) _PyCodeCache_Clear(void);
+PyAPI_FUNC(void) _PyCodeCache_SetLimits(Py_ssize_t, Py_ssize_t);
+PyAPI_FUNC(PyObject *) _PyCodeCache_Stats(void);
+
 PyAPI_FUNC(void) PyErr_Print(void);
 PyAPI_FUNC(void) PyErr_PrintEx(int);
 PyAPI_FUNC(void) PyErr_Display(PyObject *, PyObject *, PyObject *);
@@ -133,6 +139,7 @@ PyAPI_FUNC(void) _PyRandom_Init(void);
 /* Various internal finalizers */
 PyAPI_FUNC(void) _PyExc_Fini(void);
 PyAPI_FUNC(void) _PyImport_Fini(void);
+PyAPI_FUNC(void) _PyArg_Fini(void);
 PyAPI_FUNC(void) PyMethod_Fini(void);
 PyAPI_FUNC(void) PyFrame_Fini(void);
 PyAPI_FUNC(void) PyCFunction_Fini(void);
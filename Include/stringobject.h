@@ -82,7 +82,9 @@ PyAPI_FUNC(PyObject *) PyString_DecodeEscape(const char *, Py_ssize_t,
 PyAPI_FUNC(void) PyString_InternInPlace(PyObject **);
 PyAPI_FUNC(void) PyString_InternImmortal(PyObject **);
 PyAPI_FUNC(PyObject *) PyString_InternFromString(const char *);
+PyAPI_FUNC(PyObject *) _PyString_InternImmortalFromString(const char *);
 PyAPI_FUNC(void) _Py_ReleaseInternedStrings(void);
+PyAPI_FUNC(void) _PyString_ImmortalizeInterned(void);
 
 /* Use only if you know it's a string */
 #define PyString_CHECK_INTERNED(op) (((PyStringObject *)(op))->ob_sstate)
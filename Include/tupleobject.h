@@ -25,7 +25,8 @@ typedef struct {
     PyObject_VAR_HEAD
     PyObject *ob_item[1];
 
-    /* ob_item contains space for 'ob_size' elements.
+    /* ob_item contains space for 'ob_size' elements, plus one slot after
+     * them where tuplehash() caches the hash.
      * Items must normally not be NULL, except during construction when
      * the tuple is not yet visible outside the function that builds it.
      */
@@ -53,6 +54,11 @@ PyAPI_FUNC(void) _PyTuple_MaybeUntrack(PyObject *);
 /* Macro, *only* to be used to fill in brand new tuples */
 #define PyTuple_SET_ITEM(op, i, v) (((PyTupleObject *)(op))->ob_item[i] = v)
 
+/* Forget the cached hash; for the iterators that recycle their result
+   tuple, before they fill it in again */
+#define _PyTuple_FORGET_HASH(op) \
+    (((PyTupleObject *)(op))->ob_item[Py_SIZE(op)] = NULL)
+
 PyAPI_FUNC(int) PyTuple_ClearFreeList(void);
 
 #ifdef __cplusplus
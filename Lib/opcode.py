@@ -189,4 +189,16 @@ EXTENDED_ARG = 145
 def_op('SET_ADD', 146)
 def_op('MAP_ADD', 147)
 
+# Superinstructions emitted by the peephole optimizer; the argument is the
+# one of the first instruction, the second instruction follows unchanged.
+def_op('LOAD_FAST_LOAD_FAST', 148)
+haslocal.append(148)
+def_op('LOAD_FAST_LOAD_ATTR', 149)
+haslocal.append(149)
+def_op('LOAD_CONST_RETURN_VALUE', 150)
+hasconst.append(150)
+def_op('COMPARE_OP_POP_JUMP_IF_FALSE', 151)
+hascompare.append(151)
+name_op('LOAD_GLOBAL_CALL_FUNCTION', 152)
+
 del def_op, name_op, jrel_op, jabs_op
@@ -2,6 +2,7 @@
 Various tests for synchronization primitives.
 """
 
+import signal
 import sys
 import time
 from thread import start_new_thread, get_ident
@@ -144,7 +145,58 @@ class BaseLockTests(BaseTestCase):
         self.assertEqual(n, len(threading.enumerate()))
 
 
-class LockTests(BaseLockTests):
+class TimeoutLockTests(BaseTestCase):
+    """
+    Tests for locks whose acquire() takes a timeout.
+    """
+
+    def test_timeout(self):
+        lock = self.locktype()
+        # Can't set timeout if not blocking
+        self.assertRaises(ValueError, lock.acquire, 0, 1)
+        # Invalid timeout values
+        self.assertRaises(ValueError, lock.acquire, timeout=-100)
+        self.assertRaises(OverflowError, lock.acquire, timeout=1e100)
+        self.assertRaises(OverflowError, lock.acquire,
+                          timeout=threading.TIMEOUT_MAX * 2)
+        # TIMEOUT_MAX is ok
+        lock.acquire(timeout=threading.TIMEOUT_MAX)
+        lock.release()
+        t1 = time.time()
+        self.assertTrue(lock.acquire(timeout=5))
+        t2 = time.time()
+        # Just a sanity test that it didn't actually wait for the timeout.
+        self.assertLess(t2 - t1, 5)
+        results = []
+        def f():
+            t1 = time.time()
+            results.append(lock.acquire(timeout=0.5))
+            t2 = time.time()
+            results.append(t2 - t1)
+        Bunch(f, 1).wait_for_finished()
+        self.assertFalse(results[0])
+        self.assertGreaterEqual(results[1], 0.5)
+        self.assertLess(results[1], 5)
+        lock.release()
+
+    def test_timeout_released(self):
+        # A thread waiting with a timeout gets the lock as soon as it
+        # is released
+        lock = self.locktype()
+        lock.acquire()
+        results = []
+        def f():
+            results.append(lock.acquire(timeout=30))
+            lock.release()
+        b = Bunch(f, 1)
+        b.wait_for_started()
+        _wait()
+        lock.release()
+        b.wait_for_finished()
+        self.assertEqual(results, [True])
+
+
+class LockTests(BaseLockTests, TimeoutLockTests):
     """
     Tests for non-recursive, weak locks
     (which can be acquired and released from different threads).
@@ -406,6 +458,36 @@ class ConditionTests(BaseTestCase):
         for dt in results:
             self.assertTrue(dt >= 0.2, dt)
 
+    @unittest.skipUnless(hasattr(signal, 'setitimer'), 'needs setitimer()')
+    def test_wait_interrupted(self):
+        # A signal handler runs during a timed wait; when it raises, the
+        # exception comes out of wait() with the lock held again, and when
+        # it doesn't, wait() goes on until the timeout.
+        class Interrupted(Exception):
+            pass
+        def raising(signum, frame):
+            raise Interrupted
+        cond = self.condtype(threading.Lock())
+        old_handler = signal.signal(signal.SIGALRM, raising)
+        try:
+            with cond:
+                signal.setitimer(signal.ITIMER_REAL, 0.1)
+                t1 = time.time()
+                self.assertRaises(Interrupted, cond.wait, 10.0)
+                dt = time.time() - t1
+                self.assertTrue(cond._is_owned())
+            self.assertLess(dt, 5.0)
+            signal.signal(signal.SIGALRM, lambda signum, frame: None)
+            with cond:
+                signal.setitimer(signal.ITIMER_REAL, 0.1)
+                t1 = time.time()
+                cond.wait(0.5)
+                dt = time.time() - t1
+            self.assertGreaterEqual(dt, 0.5)
+        finally:
+            signal.setitimer(signal.ITIMER_REAL, 0)
+            signal.signal(signal.SIGALRM, old_handler)
+
 
 class BaseSemaphoreTests(BaseTestCase):
     """
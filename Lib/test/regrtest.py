@@ -1009,14 +1009,18 @@ def dash_R(the_module, test, indirect_test, huntrleaks):
     print >> sys.stderr, "beginning", repcount, "repetitions"
     print >> sys.stderr, ("1234567890"*(repcount//10 + 1))[:repcount]
     dash_R_cleanup(fs, ps, pic, zdc, abcs)
+    # Take every count right after a cleanup: the cleanup empties the type
+    # method cache, and a name cached in between (deltas.append, say)
+    # would otherwise count as a reference.
+    rc_before = sys.gettotalrefcount()
     for i in range(repcount):
-        rc_before = sys.gettotalrefcount()
         run_the_test()
         sys.stderr.write('.')
         dash_R_cleanup(fs, ps, pic, zdc, abcs)
         rc_after = sys.gettotalrefcount()
         if i >= nwarmup:
             deltas.append(rc_after - rc_before)
+        rc_before = rc_after
     print >> sys.stderr
     if any(deltas):
         msg = '%s leaked %s references, sum=%s' % (test, deltas, sum(deltas))
@@ -1057,6 +1061,9 @@ def dash_R_cleanup(fs, ps, pic, zdc, abcs):
     # clear type cache
     sys._clear_type_cache()
 
+    # clear the cache of code compiled from strings
+    sys._clear_code_cache()
+
     # Clear ABC registries, restoring previously saved ABC registries.
     for abc, registry in abcs.items():
         abc._abc_registry = registry.copy()
@@ -1,3 +1,4 @@
+import sys
 import unittest
 from test import test_support
 
@@ -126,8 +127,99 @@ class CFunctionCalls(unittest.TestCase):
         self.assertRaises(TypeError, [].count, x=2, y=2)
 
 
+class FastCallTests(unittest.TestCase):
+    # METH_FASTCALL functions get the arguments from the value stack when
+    # called from bytecode and from a tuple and a dict otherwise.
+
+    def setUp(self):
+        _testcapi = test_support.import_module('_testcapi')
+        self.fastcall_args = _testcapi.fastcall_args
+
+    def test_positional(self):
+        f = self.fastcall_args
+        self.assertEqual(f(), ((), None, ()))
+        self.assertEqual(f(1), ((1,), None, ()))
+        self.assertEqual(f(*range(20)), (tuple(range(20)), None, ()))
+        self.assertEqual(apply(f, (1, 2)), ((1, 2), None, ()))
+
+    def test_keywords(self):
+        f = self.fastcall_args
+        self.assertEqual(f(1, a=2), ((1,), ('a',), (2,)))
+        self.assertEqual(f(a=1, b=2), ((), ('a', 'b'), (1, 2)))
+        args, names, values = f(*range(5), **dict(a=5, b=6))
+        self.assertEqual(args, tuple(range(5)))
+        self.assertEqual(dict(zip(names, values)), dict(a=5, b=6))
+        # More arguments than fit in the small stack of fast_cfunction()
+        self.assertEqual(f(0, 1, 2, 3, 4, 5, a=6, b=7, c=8, d=9),
+                         ((0, 1, 2, 3, 4, 5), ('a', 'b', 'c', 'd'),
+                          (6, 7, 8, 9)))
+        kw = dict(('k%d' % i, i) for i in range(20))
+        args, names, values = f(1, **kw)
+        self.assertEqual(args, (1,))
+        self.assertEqual(dict(zip(names, values)), kw)
+        self.assertEqual(f(**{}), ((), None, ()))
+
+    def test_builtins(self):
+        class C(object):
+            pass
+        c = C()
+        setattr(c, 'x', 1)
+        self.assertEqual(getattr(c, 'x'), 1)
+        self.assertEqual(getattr(c, 'y', 2), 2)
+        self.assertTrue(hasattr(c, 'x'))
+        delattr(c, 'x')
+        self.assertFalse(hasattr(c, 'x'))
+        self.assertTrue(isinstance(c, C))
+        self.assertTrue(issubclass(C, object))
+        self.assertEqual(next(iter([]), 3), 3)
+        self.assertEqual({1: 2}.get(1), 2)
+        self.assertEqual(dict.get({}, 1, 3), 3)
+        self.assertEqual([1, 2].pop(), 2)
+        self.assertEqual('a-b'.split('-'), ['a', 'b'])
+        self.assertEqual('aaa'.replace('a', 'b', 2), 'bba')
+
+    def test_errors(self):
+        for call in [lambda: getattr(1),
+                     lambda: getattr(1, 'real', 2, 3),
+                     lambda: getattr(*(1,)),
+                     lambda: getattr(1, 'real', x=1),
+                     lambda: getattr(1, 'real', **{'x': 1}),
+                     lambda: isinstance(1, int, x=1),
+                     lambda: {}.get(),
+                     lambda: {}.get(1, x=2),
+                     lambda: [].insert(0),
+                     lambda: [].insert('0', 1),
+                     lambda: [].pop(x=0)]:
+            self.assertRaises(TypeError, call)
+        try:
+            getattr(1, 'real', default=2)
+        except TypeError, e:
+            self.assertEqual(str(e), 'getattr() takes no keyword arguments')
+        try:
+            [].insert(0)
+        except TypeError, e:
+            self.assertEqual(str(e),
+                             'insert() takes exactly 2 arguments (1 given)')
+
+    def test_profile(self):
+        events = []
+        def profile(frame, event, arg):
+            if event.startswith('c_'):
+                events.append((event, arg.__name__))
+        sys.setprofile(profile)
+        try:
+            getattr(1, 'real')
+            self.fastcall_args(a=1)
+        finally:
+            sys.setprofile(None)
+        self.assertEqual(events[:4], [('c_call', 'getattr'),
+                                      ('c_return', 'getattr'),
+                                      ('c_call', 'fastcall_args'),
+                                      ('c_return', 'fastcall_args')])
+
+
 def test_main():
-    test_support.run_unittest(CFunctionCalls)
+    test_support.run_unittest(CFunctionCalls, FastCallTests)
 
 
 if __name__ == "__main__":
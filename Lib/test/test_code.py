@@ -80,6 +80,7 @@ consts: ("'doc string'", 'None')
 
 """
 
+import sys
 import unittest
 import weakref
 import _testcapi
@@ -120,6 +121,9 @@ class CodeWeakRefTest(unittest.TestCase):
         exec "def f(): pass" in globals(), namespace
         f = namespace["f"]
         del namespace
+        # The code cache holds the code exec'd above, f's code among its
+        # constants.
+        sys._clear_code_cache()
 
         self.called = False
         def callback(code):
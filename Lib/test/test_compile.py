@@ -491,8 +491,91 @@ if 1:
         self.assertRaises(TypeError, compile, ast, '<ast>', 'exec')
 
 
+class TestCodeCache(unittest.TestCase):
+
+    def setUp(self):
+        stats = sys._codecachestats()
+        self.addCleanup(sys._setcodecachelimits,
+                        stats['max_entries'], stats['max_bytes'])
+        sys._clear_code_cache()
+
+    def test_hit(self):
+        before = sys._codecachestats()
+        co = compile('x = 1', '<cache>', 'exec')
+        self.assertIs(compile('x = 1', '<cache>', 'exec'), co)
+        # unicode source is compiled with other flags
+        self.assertIsNot(compile(u'x = 1', '<cache>', 'exec'), co)
+        after = sys._codecachestats()
+        self.assertEqual(after['hits'], before['hits'] + 1)
+        self.assertEqual(after['misses'], before['misses'] + 2)
+        self.assertEqual(after['entries'], 2)
+
+    def test_key(self):
+        co = compile('1', '<cache>', 'eval')
+        self.assertIsNot(compile('1', '<other>', 'eval'), co)
+        self.assertIsNot(compile('1', '<cache>', 'exec'), co)
+        self.assertIsNot(compile('1', '<cache>', 'eval', 0x2000), co)
+        self.assertIsNot(compile('1 ', '<cache>', 'eval'), co)
+        self.assertIs(compile('1', '<cache>', 'eval'), co)
+
+    def test_exec_and_eval(self):
+        before = sys._codecachestats()
+        ns = {'n': 0}
+        for i in range(3):
+            exec 'n += 1' in ns
+            self.assertEqual(eval('n * 2', ns), ns['n'] * 2)
+        after = sys._codecachestats()
+        self.assertEqual(after['entries'], 2)
+        self.assertEqual(after['misses'], before['misses'] + 2)
+        self.assertEqual(after['hits'], before['hits'] + 4)
+
+    def test_future_flags(self):
+        src = 'from __future__ import division\nx = 1 / 2'
+        for i in range(2):
+            ns = {}
+            exec compile(src, '<cache>', 'exec') in ns
+            self.assertEqual(ns['x'], 0.5)
+        # the features of the cached code still reach the interpreter
+        # that follows, as with a fresh compilation
+        co = compile('1 / 2', '<cache>', 'eval')
+        self.assertEqual(eval(co), 0)
+
+    def test_not_cached(self):
+        for i in range(2):
+            self.assertRaises(SyntaxError, compile, 'x = ', '<cache>', 'exec')
+        src = 'def f():\n    from sys import *\n'
+        for i in range(2):
+            with test_support.check_warnings(('', SyntaxWarning)):
+                compile(src, '<cache>', 'exec')
+        self.assertEqual(sys._codecachestats()['entries'], 0)
+        ast = compile('1', '<cache>', 'eval', _ast.PyCF_ONLY_AST)
+        self.assertIsNot(compile('1', '<cache>', 'eval', _ast.PyCF_ONLY_AST),
+                         ast)
+
+    def test_limits(self):
+        self.assertRaises(ValueError, sys._setcodecachelimits, -1, 100)
+        sys._setcodecachelimits(2, 100)
+        before = sys._codecachestats()
+        a = compile('a', '<cache>', 'eval')
+        b = compile('b', '<cache>', 'eval')
+        self.assertIs(compile('a', '<cache>', 'eval'), a)
+        compile('c', '<cache>', 'eval')
+        stats = sys._codecachestats()
+        self.assertEqual(stats['entries'], 2)
+        self.assertEqual(stats['evictions'], before['evictions'] + 1)
+        self.assertIs(compile('a', '<cache>', 'eval'), a)
+        self.assertIsNot(compile('b', '<cache>', 'eval'), b)
+        compile('x' * 101, '<cache>', 'eval')
+        self.assertEqual(sys._codecachestats()['bytes'], 2)
+        sys._clear_code_cache()
+        self.assertEqual(sys._codecachestats()['entries'], 0)
+        sys._setcodecachelimits(0, 100)
+        self.assertIsNot(compile('a', '<cache>', 'eval'),
+                         compile('a', '<cache>', 'eval'))
+
+
 def test_main():
-    test_support.run_unittest(TestSpecifics)
+    test_support.run_unittest(TestSpecifics, TestCodeCache)
 
 if __name__ == "__main__":
     test_main()
@@ -1,4 +1,5 @@
 import __builtin__
+import gc
 import sys
 import types
 import unittest
@@ -4632,6 +4633,239 @@ class DictProxyTests(unittest.TestCase):
         self.assertEqual(type(C.__dict__), type(B.__dict__))
 
 
+class AttributeCacheTests(unittest.TestCase):
+    # LOAD_ATTR and STORE_ATTR cache how an attribute was found for the
+    # type last seen at each instruction.  Every test runs the same
+    # instructions several times, with the class changing in between.
+
+    def test_class_attribute_changes(self):
+        class C(object):
+            x = 1
+            def meth(self):
+                return 'meth'
+        def get(obj):
+            return obj.x, obj.meth()
+        c = C()
+        for i in range(3):
+            self.assertEqual(get(c), (1, 'meth'))
+        C.x = 2
+        C.meth = lambda self: 'new'
+        self.assertEqual(get(c), (2, 'new'))
+        del C.x
+        self.assertRaises(AttributeError, get, c)
+        C.x = 3
+        self.assertEqual(get(c), (3, 'new'))
+
+    def test_base_class_changes(self):
+        class A(object):
+            x = 'A'
+        class B(A):
+            pass
+        def get(obj):
+            return obj.x
+        b = B()
+        for i in range(3):
+            self.assertEqual(get(b), 'A')
+        A.x = 'A2'
+        self.assertEqual(get(b), 'A2')
+        B.x = 'B'
+        self.assertEqual(get(b), 'B')
+        class Other(object):
+            pass
+        B.__bases__ = (Other,)
+        self.assertEqual(get(b), 'B')
+        del B.x
+        self.assertRaises(AttributeError, get, b)
+
+    def test_instance_dict(self):
+        class C(object):
+            x = 'class'
+            def meth(self):
+                return 'meth'
+        def get(obj):
+            return obj.x, obj.meth
+        def put(obj, value):
+            obj.x = value
+        c = C()
+        for i in range(3):
+            self.assertEqual(get(c)[0], 'class')
+        c.meth = 'shadowed'
+        self.assertEqual(get(c), ('class', 'shadowed'))
+        for i in range(3):
+            put(c, i)
+            self.assertEqual(get(c), (i, 'shadowed'))
+        # Many keys move the entry to another slot of the table
+        for i in range(100):
+            setattr(c, 'attr%d' % i, i)
+        put(c, 'resized')
+        self.assertEqual(get(c), ('resized', 'shadowed'))
+        del c.x, c.meth
+        self.assertEqual(get(c)[0], 'class')
+        c.__dict__ = {'x': 'new dict'}
+        self.assertEqual(get(c)[0], 'new dict')
+        put(c, 'put')
+        self.assertEqual(c.__dict__, {'x': 'put'})
+        # Replacing a value in place must still make the dict tracked
+        d = {}
+        c.__dict__ = {'x': 0}
+        gc.collect()
+        put(c, d)
+        d['c'] = c
+        self.assertTrue(gc.is_tracked(c.__dict__))
+
+    def test_data_descriptors(self):
+        log = []
+        class C(object):
+            @property
+            def x(self):
+                return 'property'
+            @x.setter
+            def x(self, value):
+                log.append(value)
+        def get(obj):
+            return obj.x
+        def put(obj, value):
+            obj.x = value
+        c = C()
+        c.__dict__['x'] = 'shadowed by the property'
+        for i in range(3):
+            self.assertEqual(get(c), 'property')
+            put(c, i)
+        self.assertEqual(log, [0, 1, 2])
+        C.x = 'plain'
+        self.assertEqual(get(c), 'shadowed by the property')
+        put(c, 'dict')
+        self.assertEqual(c.__dict__['x'], 'dict')
+
+    def test_descriptor_type_changes(self):
+        class Descr(object):
+            pass
+        class C(object):
+            x = Descr()
+        def get(obj):
+            return obj.x
+        def put(obj, value):
+            obj.x = value
+        c = C()
+        for i in range(3):
+            self.assertIs(get(c), C.__dict__['x'])
+        Descr.__get__ = lambda self, obj, tp: 'get'
+        self.assertEqual(get(c), 'get')
+        c.x = 'dict'
+        self.assertEqual(get(c), 'dict')
+        log = []
+        Descr.__set__ = lambda self, obj, value: log.append(value)
+        self.assertEqual(get(c), 'get')
+        put(c, 'set')
+        self.assertEqual(log, ['set'])
+        class Other(object):
+            def __get__(self, obj, tp):
+                return 'other'
+        C.__dict__['x'].__class__ = Other
+        self.assertEqual(get(c), 'dict')
+
+    def test_slots(self):
+        class C(object):
+            __slots__ = ('a', 'b')
+        def get(obj):
+            return obj.a
+        def put(obj, value):
+            obj.a = value
+        c = C()
+        self.assertRaises(AttributeError, get, c)
+        for i in range(3):
+            put(c, i)
+            self.assertEqual(get(c), i)
+        del c.a
+        self.assertRaises(AttributeError, get, c)
+        self.assertRaises(AttributeError, put, object(), 1)
+        # A member descriptor of another class doesn't apply
+        class D(object):
+            __slots__ = ('c',)
+        D.a = C.__dict__['a']
+        self.assertRaises(TypeError, get, D())
+        self.assertRaises(TypeError, put, D(), 1)
+
+    def test_polymorphic_site(self):
+        class A(object):
+            x = 'A'
+        class B(object):
+            __slots__ = ('x',)
+        class C(object):
+            @property
+            def x(self):
+                return 'C'
+        class Old:
+            x = 'Old'
+        def get(obj):
+            return obj.x
+        b = B()
+        b.x = 'B'
+        objects = [A(), b, C(), Old(), A()]
+        for i in range(3):
+            self.assertEqual(map(get, objects), ['A', 'B', 'C', 'Old', 'A'])
+
+    def test_getattr_hooks(self):
+        class C(object):
+            x = 'class'
+        def get(obj):
+            return obj.x
+        def put(obj, value):
+            obj.x = value
+        c = C()
+        for i in range(3):
+            self.assertEqual(get(c), 'class')
+        C.__getattribute__ = lambda self, name: 'getattribute'
+        self.assertEqual(get(c), 'getattribute')
+        del C.__getattribute__
+        log = []
+        C.__setattr__ = lambda self, name, value: log.append(value)
+        put(c, 1)
+        self.assertEqual(log, [1])
+        self.assertEqual(get(c), 'class')
+
+    def test_class_assignment(self):
+        class A(object):
+            x = 'A'
+        class B(object):
+            x = 'B'
+        def get(obj):
+            return obj.x
+        obj = A()
+        for i in range(3):
+            self.assertEqual(get(obj), 'A')
+        obj.__class__ = B
+        self.assertEqual(get(obj), 'B')
+
+    def test_clear_type_cache(self):
+        class C(object):
+            x = 'C'
+        def get(obj):
+            return obj.x
+        c = C()
+        for i in range(3):
+            self.assertEqual(get(c), 'C')
+        sys._clear_type_cache()
+        # Version tags start over, a new class may get C's old tag
+        for i in range(10):
+            class D(object):
+                x = 'D'
+            self.assertEqual(get(D()), 'D')
+            self.assertEqual(get(c), 'C')
+
+    def test_modules(self):
+        m = types.ModuleType('m')
+        def get(mod):
+            return mod.x
+        def put(mod, value):
+            mod.x = value
+        for i in range(3):
+            put(m, i)
+            self.assertEqual(get(m), i)
+        del m.x
+        self.assertRaises(AttributeError, get, m)
+
+
 class PTypesLongInitTest(unittest.TestCase):
     # This is in its own TestCase so that it can be run before any other tests.
     def test_pytype_long_ready(self):
@@ -4665,7 +4899,8 @@ def test_main():
     with test_support.check_warnings(*deprecations):
         # Run all local test cases, with PTypesLongInitTest first.
         test_support.run_unittest(PTypesLongInitTest, OperatorsTest,
-                                  ClassPropertiesAndMethods, DictProxyTests)
+                                  ClassPropertiesAndMethods, DictProxyTests,
+                                  AttributeCacheTests)
 
 if __name__ == "__main__":
     test_main()
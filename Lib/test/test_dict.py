@@ -2,7 +2,7 @@ import unittest
 from test import test_support
 
 import UserDict, random, string
-import gc, weakref
+import gc, weakref, sys
 
 
 class DictTest(unittest.TestCase):
@@ -650,6 +650,22 @@ class DictTest(unittest.TestCase):
             pass
         self._tracked(MyDict())
 
+    @test_support.cpython_only
+    def test_table_cache(self):
+        # The table of a dict that dies is handed to the next one
+        before = sys._tablecachestats()
+        for i in range(10):
+            d = dict.fromkeys(range(100))
+            del d
+        after = sys._tablecachestats()
+        self.assertGreater(after['hits'], before['hits'])
+        self.assertGreater(after['tables'], 0)
+        # a full collection empties the cache
+        gc.collect()
+        after = sys._tablecachestats()
+        self.assertEqual(after['tables'], 0)
+        self.assertEqual(after['bytes'], 0)
+
 
 from test import mapping_tests
 
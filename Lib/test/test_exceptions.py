@@ -479,6 +479,48 @@ class ExceptionTests(unittest.TestCase):
         except AssertionError as e:
             self.assertEqual(str(e), "(3,)")
 
+    def test_deferred_values(self):
+        # The values of these errors are only built when they are fetched
+        class Classic: pass
+        class New(object): pass
+        def lookup(obj):
+            return obj.spam
+        for obj, msg in [(Classic, "class Classic has no attribute 'spam'"),
+                         (Classic(), "Classic instance has no attribute "
+                                     "'spam'"),
+                         (New, "type object 'New' has no attribute 'spam'"),
+                         (New(), "'New' object has no attribute 'spam'")]:
+            self.assertFalse(hasattr(obj, 'spam'))
+            self.assertIs(getattr(obj, 'spam', None), None)
+            try:
+                lookup(obj)
+            except AttributeError as e:
+                self.assertEqual(str(e), msg)
+                self.assertEqual(e.args, (msg,))
+                tb = sys.exc_info()[2]
+                self.assertIs(tb.tb_next.tb_frame.f_code, lookup.func_code)
+            else:
+                self.fail("no AttributeError")
+        for key in 1, (), (1, 2):
+            with self.assertRaises(KeyError) as cm:
+                {}[key]
+            self.assertEqual(cm.exception.args, (key,))
+            with self.assertRaises(KeyError) as cm:
+                set().remove(key)
+            self.assertEqual(cm.exception.args, (key,))
+        # __getattr__ hooks see the missing attribute, and replacing
+        # the pending error drops it
+        class Hook(object):
+            def __getattr__(self, name):
+                raise ValueError(name)
+        with self.assertRaises(ValueError) as cm:
+            Hook().spam
+        self.assertEqual(cm.exception.args, ('spam',))
+        class ClassicHook:
+            def __getattr__(self, name):
+                return name
+        self.assertEqual(ClassicHook().spam, 'spam')
+
 
 # Helper class used by TestSameStrAndUnicodeMsg
 class ExcWithOverriddenStr(Exception):
@@ -1,5 +1,6 @@
 import unittest
 from test.test_support import verbose, run_unittest
+from test.script_helper import assert_python_ok
 import sys
 import gc
 import weakref
@@ -264,6 +265,145 @@ class GCTests(unittest.TestCase):
         gc.collect(2)
         assertEqual(gc.get_count(), (0, 0, 0))
 
+    def test_freeze(self):
+        gc.freeze()
+        try:
+            self.assertGreater(gc.get_freeze_count(), 0)
+        finally:
+            gc.unfreeze()
+        self.assertEqual(gc.get_freeze_count(), 0)
+
+    def test_freeze_ignores_cycles(self):
+        gc.collect()
+        c = C1055820(0)
+        c.loop = c
+        wr = weakref.ref(c)
+        gc.freeze()
+        try:
+            self.assertTrue(gc.is_tracked(c))
+            self.assertIn(c, gc.get_objects())
+            self.assertIn(c.__dict__, gc.get_referrers(c))
+            del c
+            gc.collect()
+            self.assertIsNotNone(wr())
+        finally:
+            gc.unfreeze()
+        gc.collect()
+        self.assertIsNone(wr())
+
+    @unittest.skipUnless(sys.getrefcount(None) > 2**28,
+                         "requires immortal objects")
+    def test_freeze_immortal(self):
+        # Run in a subprocess, immortal objects stay immortal
+        code = """if 1:
+            import gc, sys, weakref
+            class A(object):
+                pass
+            a = A()
+            a.x = ['spam']
+            wr = weakref.ref(a)
+            gc.freeze(True)
+            assert gc.get_freeze_count() > 0
+            c = sys.getrefcount(a.x)
+            l = [a.x] * 10
+            assert sys.getrefcount(a.x) == c
+            assert sys.getrefcount(a.x[0]) == c
+            # never deallocated
+            del a
+            gc.collect()
+            assert wr() is not None
+            # new objects are counted as usual
+            b = A()
+            c = sys.getrefcount(b)
+            l = [b] * 10
+            assert sys.getrefcount(b) == c + 10
+            gc.unfreeze()
+            gc.collect()
+            assert wr() is not None
+            """
+        assert_python_ok('-c', code)
+
+    def test_get_stats(self):
+        gc.get_stats(True)
+        gc.collect(0)
+        gc.collect()
+        stats = gc.get_stats()
+        self.assertEqual(len(stats), 3)
+        for generation, collections in enumerate([1, 0, 1]):
+            st = stats[generation]
+            self.assertEqual(st['collections'], collections)
+            self.assertEqual(sum(st['pause_histogram']), collections)
+            self.assertGreaterEqual(st['pause_total'], st['pause_max'])
+        self.assertIn('passes', stats[2]['incremental'])
+        gc.get_stats(True)
+        self.assertEqual(gc.get_stats()[2]['collections'], 0)
+
+    def test_incremental(self):
+        self.assertEqual(gc.get_incremental(), 0)
+        self.assertRaises(ValueError, gc.set_incremental, -1)
+        gc.collect()
+        c = C1055820(0)
+        c.loop = c
+        wr = weakref.ref(c)
+        gc.collect()
+        del c
+        # The cycle is in the oldest generation now; a few increments
+        # find it without a full collection.
+        threshold = gc.get_threshold()
+        gc.get_stats(True)
+        gc.set_incremental(1000)
+        # a high threshold2 keeps the full collections out of the way
+        gc.set_threshold(100, 1, 100000)
+        gc.enable()
+        try:
+            junk = []
+            for i in range(100000):
+                junk.append([])
+                if wr() is None:
+                    break
+        finally:
+            gc.disable()
+            gc.set_threshold(*threshold)
+            gc.set_incremental(0)
+        self.assertIsNone(wr())
+        stats = gc.get_stats()
+        self.assertEqual(stats[2]['collections'], 0)
+        self.assertGreater(stats[2]['incremental']['collections'], 0)
+        self.assertGreaterEqual(stats[1]['collections'],
+                                stats[2]['incremental']['collections'])
+
+    def test_incremental_big_cycle(self):
+        # A garbage cycle much bigger than an increment is still freed by
+        # the full collections that incremental mode falls back on.
+        class Node(object):
+            pass
+        def ring(n):
+            first = node = Node()
+            for i in range(n - 1):
+                node.next = Node()
+                node = node.next
+            node.next = first
+            return weakref.ref(first)
+        gc.collect()
+        threshold = gc.get_threshold()
+        gc.get_stats(True)
+        gc.set_incremental(100)
+        gc.set_threshold(100, 10, 10)
+        gc.enable()
+        try:
+            rings = []
+            for i in range(20):
+                rings.append(ring(5000))
+                junk = [[] for j in range(5000)]
+                del junk
+            alive = sum(wr() is not None for wr in rings)
+        finally:
+            gc.disable()
+            gc.set_threshold(*threshold)
+            gc.set_incremental(0)
+        self.assertLess(alive, 10)
+        self.assertGreater(gc.get_stats()[2]['collections'], 0)
+
     def test_trashcan(self):
         class Ouch:
             n = 0
@@ -470,6 +610,40 @@ class GCTests(unittest.TestCase):
             # would be damaged, with an empty __dict__.
             self.assertEqual(x, None)
 
+    def test_int_blocks_reclaimed(self):
+        ints = range(10**6, 10**6 + 500000)
+        during = sys._intblockstats()
+        del ints
+        # a young collection is enough to give the blocks back
+        gc.collect(0)
+        after = sys._intblockstats()
+        self.assertGreater(after['reclaimed_blocks'],
+                           during['reclaimed_blocks'])
+        self.assertLess(after['blocks'], during['blocks'] // 2)
+
+    def test_int_blocks_reclaimed_after_fragmentation(self):
+        # A pass over a fragmented heap can't give much back; one that
+        # follows once those ints are gone must still free the blocks.
+        # In a new interpreter, where these ints outnumber the others.
+        code = """if 1:
+            import gc, sys
+            ints = range(10**6, 10**6 + 500000)
+            kept = ints[::40]
+            del ints
+            gc.collect(0)
+            fragmented = sys._intblockstats()
+            for i in range(2):
+                ints = range(10**6, 10**6 + 500000)
+                del ints
+                gc.collect(0)
+            del kept
+            gc.collect(0)
+            after = sys._intblockstats()
+            assert after['passes'] > fragmented['passes']
+            assert after['blocks'] < fragmented['blocks'] // 2
+            """
+        assert_python_ok('-c', code)
+
 class GCTogglingTests(unittest.TestCase):
     def setUp(self):
         gc.enable()
@@ -1,6 +1,7 @@
 import unittest
 from test import test_support
-from _testcapi import getargs_keywords
+from _testcapi import getargs_keywords, getargs_keywords_fast, \
+     getargs_keywords_stack, getargs_keywords_badformat
 import warnings
 
 """
@@ -273,41 +274,43 @@ class Tuple_TestCase(unittest.TestCase):
         self.assertRaises(TypeError, getargs_tuple, 1, seq())
 
 class Keywords_TestCase(unittest.TestCase):
+    getargs_keywords = staticmethod(getargs_keywords)
+
     def test_positional_args(self):
         # using all positional args
         self.assertEqual(
-            getargs_keywords((1,2), 3, (4,(5,6)), (7,8,9), 10),
+            self.getargs_keywords((1,2), 3, (4,(5,6)), (7,8,9), 10),
             (1, 2, 3, 4, 5, 6, 7, 8, 9, 10)
             )
     def test_mixed_args(self):
         # positional and keyword args
         self.assertEqual(
-            getargs_keywords((1,2), 3, (4,(5,6)), arg4=(7,8,9), arg5=10),
+            self.getargs_keywords((1,2), 3, (4,(5,6)), arg4=(7,8,9), arg5=10),
             (1, 2, 3, 4, 5, 6, 7, 8, 9, 10)
             )
     def test_keyword_args(self):
         # all keywords
         self.assertEqual(
-            getargs_keywords(arg1=(1,2), arg2=3, arg3=(4,(5,6)), arg4=(7,8,9), arg5=10),
+            self.getargs_keywords(arg1=(1,2), arg2=3, arg3=(4,(5,6)), arg4=(7,8,9), arg5=10),
             (1, 2, 3, 4, 5, 6, 7, 8, 9, 10)
             )
     def test_optional_args(self):
         # missing optional keyword args, skipping tuples
         self.assertEqual(
-            getargs_keywords(arg1=(1,2), arg2=3, arg5=10),
+            self.getargs_keywords(arg1=(1,2), arg2=3, arg5=10),
             (1, 2, 3, -1, -1, -1, -1, -1, -1, 10)
             )
     def test_required_args(self):
         # required arg missing
         try:
-            getargs_keywords(arg1=(1,2))
+            self.getargs_keywords(arg1=(1,2))
         except TypeError, err:
             self.assertEqual(str(err), "Required argument 'arg2' (pos 2) not found")
         else:
             self.fail('TypeError should have been raised')
     def test_too_many_args(self):
         try:
-            getargs_keywords((1,2),3,(4,(5,6)),(7,8,9),10,111)
+            self.getargs_keywords((1,2),3,(4,(5,6)),(7,8,9),10,111)
         except TypeError, err:
             self.assertEqual(str(err), "function takes at most 5 arguments (6 given)")
         else:
@@ -315,14 +318,54 @@ class Keywords_TestCase(unittest.TestCase):
     def test_invalid_keyword(self):
         # extraneous keyword arg
         try:
-            getargs_keywords((1,2),3,arg5=10,arg666=666)
+            self.getargs_keywords((1,2),3,arg5=10,arg666=666)
         except TypeError, err:
             self.assertEqual(str(err), "'arg666' is an invalid keyword argument for this function")
         else:
             self.fail('TypeError should have been raised')
 
+class FastKeywords_TestCase(Keywords_TestCase):
+    # the same checks for a precompiled _PyArg_Parser
+    getargs_keywords = staticmethod(getargs_keywords_fast)
+
+    def test_repeated_calls(self):
+        # the parser is initialized by the first call only
+        for i in range(3):
+            self.assertEqual(
+                self.getargs_keywords((1,2), arg2=3, arg5=i),
+                (1, 2, 3, -1, -1, -1, -1, -1, -1, i))
+    def test_positional_and_keyword(self):
+        try:
+            self.getargs_keywords((1,2), 3, arg2=3)
+        except TypeError, err:
+            self.assertEqual(str(err), "Argument given by name ('arg2') "
+                                       "and position (2)")
+        else:
+            self.fail('TypeError should have been raised')
+    def test_non_interned_keyword(self):
+        # a keyword equal to, but not identical with, the interned name
+        name = ''.join(['arg', '5'])
+        self.assertEqual(
+            self.getargs_keywords((1,2), 3, **{name: 10}),
+            (1, 2, 3, -1, -1, -1, -1, -1, -1, 10))
+    def test_unicode_keyword(self):
+        self.assertEqual(
+            self.getargs_keywords((1,2), 3, **{u'arg5': 10}),
+            (1, 2, 3, -1, -1, -1, -1, -1, -1, 10))
+    def test_non_string_keyword(self):
+        self.assertRaises(TypeError, self.getargs_keywords, (1,2), 3,
+                          **{u'arg6': 1})
+    def test_bad_format(self):
+        for i in range(2):
+            self.assertRaises(RuntimeError, getargs_keywords_badformat, 1, 2)
+
+class StackKeywords_TestCase(FastKeywords_TestCase):
+    # the same checks for a METH_FASTCALL function
+    getargs_keywords = staticmethod(getargs_keywords_stack)
+
 def test_main():
-    tests = [Signed_TestCase, Unsigned_TestCase, Tuple_TestCase, Keywords_TestCase]
+    tests = [Signed_TestCase, Unsigned_TestCase, Tuple_TestCase, Keywords_TestCase,
+             FastKeywords_TestCase, StackKeywords_TestCase]
     try:
         from _testcapi import getargs_L, getargs_K
     except ImportError:
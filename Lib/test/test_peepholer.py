@@ -219,6 +219,78 @@ class TestTranforms(unittest.TestCase):
         self.assertEqual(asm.split().count('JUMP_ABSOLUTE'), 1)
         self.assertEqual(asm.split().count('RETURN_VALUE'), 2)
 
+    def test_superinstructions(self):
+        def f(a, b):
+            if a < b:
+                return len(a.x)
+            return 1
+        asm = disassemble(f)
+        for elem in ('LOAD_FAST_LOAD_FAST', 'LOAD_FAST_LOAD_ATTR',
+                     'COMPARE_OP_POP_JUMP_IF_FALSE',
+                     'LOAD_CONST_RETURN_VALUE'):
+            self.assertIn(elem, asm)
+        # The second instruction of each pair is kept
+        self.assertEqual(asm.split().count('LOAD_FAST'), 1)
+        self.assertEqual(asm.split().count('LOAD_ATTR'), 1)
+        self.assertEqual(asm.split().count('POP_JUMP_IF_FALSE'), 1)
+        class C:
+            x = [1, 2]
+        self.assertEqual(f(C(), 2), 2)
+        self.assertEqual(f(3, 1), 1)
+        self.assertRaises(AttributeError, f, 1, 2)
+
+        def g():
+            return dict()
+        self.assertIn('LOAD_GLOBAL_CALL_FUNCTION', disassemble(g))
+        self.assertEqual(g(), {})
+
+    def test_superinstruction_jump_target(self):
+        # The while loop jumps back to the second LOAD_FAST of a fused
+        # LOAD_FAST LOAD_FAST pair
+        def f(n, m):
+            x = n
+            while x < m:
+                x = x + 1
+            return x
+        self.assertIn('LOAD_FAST_LOAD_FAST', disassemble(f))
+        self.assertEqual(f(0, 10), 10)
+
+    def test_superinstruction_line_numbers(self):
+        # An error in the second half reports the line of the second
+        # instruction, also when the pair is fused
+        def f(a):
+            if 0:
+                b = 1
+            return max(a,
+                       b)
+        self.assertIn('LOAD_FAST_LOAD_FAST', disassemble(f))
+        try:
+            f(1)
+        except UnboundLocalError:
+            tb = sys.exc_info()[2]
+            while tb.tb_next:
+                tb = tb.tb_next
+            self.assertEqual(tb.tb_lineno, f.func_code.co_firstlineno + 4)
+        else:
+            self.fail('UnboundLocalError not raised')
+
+    def test_superinstruction_tracing(self):
+        def f(a, b):
+            return max(a,
+                       b)
+        self.assertIn('LOAD_FAST_LOAD_FAST', disassemble(f))
+        lines = []
+        def tracer(frame, event, arg):
+            if frame.f_code is f.func_code and event == 'line':
+                lines.append(frame.f_lineno - f.func_code.co_firstlineno)
+            return tracer
+        sys.settrace(tracer)
+        try:
+            f(1, 2)
+        finally:
+            sys.settrace(None)
+        self.assertEqual(lines, [1, 2])
+
 
 def test_main(verbose=None):
     import sys
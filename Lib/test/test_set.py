@@ -561,6 +561,17 @@ class TestSet(TestJointOps):
         s = None
         self.assertRaises(ReferenceError, str, p)
 
+    @test_support.cpython_only
+    def test_table_cache(self):
+        # The table of a set that dies is handed to the next one
+        before = sys._tablecachestats()
+        for i in range(10):
+            s = self.thetype(range(100))
+            del s
+        after = sys._tablecachestats()
+        self.assertGreater(after['hits'], before['hits'])
+        self.assertGreater(after['tables'], 0)
+
     # C API test only available in a debug build
     if hasattr(set, "test_c_api"):
         def test_c_api(self):
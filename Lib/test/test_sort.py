@@ -265,6 +265,93 @@ class TestDecorateSortUndecorate(unittest.TestCase):
         copy2.sort(key=lambda x: x[0], reverse=True)
         self.assertEqual(data, copy2)
 
+class TestOptimizedCompares(unittest.TestCase):
+    # Lists whose keys are all of one type are sorted with a comparison
+    # specialized for that type; check it against the generic one, which
+    # sorting by one-item lists gets.
+
+    def check_against_generic(self, data):
+        expected = sorted(data, key=lambda x: [x])
+        self.assertEqual(repr(sorted(data)), repr(expected))
+        self.assertEqual(repr(sorted(data, key=lambda x: x)), repr(expected))
+        self.assertEqual(repr(sorted(data, reverse=True)),
+                         repr(sorted(data, key=lambda x: [x], reverse=True)))
+
+    def test_homogeneous(self):
+        nan = float('nan')
+        r = random.random
+        for n in 2, 10, 100, 1000:
+            for data in ([random.randrange(-n, n) for i in xrange(n)],
+                         [sys.maxint - random.randrange(n)
+                          for i in xrange(n)],
+                         [random.randrange(n) * 10L**30 for i in xrange(n)],
+                         [random.choice([r(), -r(), 0.0, -0.0, nan])
+                          for i in xrange(n)],
+                         [str(r())[:random.randrange(5)] for i in xrange(n)],
+                         [chr(random.randrange(256)) * 2 for i in xrange(n)],
+                         [unicode(r()) for i in xrange(n)],
+                         [(random.randrange(3), r()) for i in xrange(n)],
+                         [(random.choice([1, 'a', 2.5]), random.randrange(3))
+                          for i in xrange(n)],
+                         [(r(),) * random.randrange(1, 3) for i in xrange(n)],
+                         [random.choice([(), (1,), (1, 2)])
+                          for i in xrange(n)],
+                         [((random.randrange(3),), i % 2)
+                          for i in xrange(n)]):
+                self.check_against_generic(data)
+
+    def test_mixed(self):
+        data = [1, 2L, 1.5, True, 'x', u'y', (), (1,), None] * 10
+        random.shuffle(data)
+        self.check_against_generic(data)
+        data = [(1, 2), (1, 2.0), (1,), [1], (1.0, 'a')] * 10
+        random.shuffle(data)
+        self.check_against_generic(data)
+
+    def test_rich_compare_types(self):
+        class Classic:
+            def __init__(self, v):
+                self.v = v
+            def __lt__(self, other):
+                return self.v < other.v
+        class Other:
+            def __init__(self, v):
+                self.v = v
+            def __cmp__(self, other):
+                return cmp(self.v, other.v)
+        data = [Classic(i) for i in range(50)] + [Other(i) for i in range(50)]
+        random.shuffle(data)
+        self.assertEqual([x.v for x in sorted(data)],
+                         sorted(range(50) * 2))
+
+        class OnlyEq(object):
+            def __init__(self, v):
+                self.v = v
+            def __eq__(self, other):
+                return self.v == other.v
+            def __cmp__(self, other):
+                return cmp(self.v, other.v)
+        data = [OnlyEq(i) for i in range(100)]
+        random.shuffle(data)
+        self.assertEqual([x.v for x in sorted(data)], range(100))
+
+    def test_class_changed_while_sorting(self):
+        class A(object):
+            def __init__(self, v):
+                self.v = v
+            def __lt__(self, other):
+                other.__class__ = B
+                return self.v < other.v
+        class B(object):
+            def __init__(self, v):
+                self.v = v
+            def __lt__(self, other):
+                return self.v > other.v
+        data = [A(i) for i in range(100)]
+        random.shuffle(data)
+        data.sort()
+        self.assertEqual(sorted(x.v for x in data), range(100))
+
 #==============================================================================
 
 def test_main(verbose=None):
@@ -272,6 +359,7 @@ def test_main(verbose=None):
         TestBase,
         TestDecorateSortUndecorate,
         TestBugs,
+        TestOptimizedCompares,
     )
 
     with test_support.check_py3k_warnings(
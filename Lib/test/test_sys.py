@@ -215,6 +215,111 @@ class SysModuleTest(unittest.TestCase):
             sys.setcheckinterval(n)
             self.assertEqual(sys.getcheckinterval(), n)
 
+    @unittest.skipUnless(hasattr(sys, "setswitchinterval"),
+                         "requires threads")
+    def test_switchinterval(self):
+        self.assertRaises(TypeError, sys.setswitchinterval)
+        self.assertRaises(TypeError, sys.setswitchinterval, "a")
+        self.assertRaises(ValueError, sys.setswitchinterval, -1.0)
+        self.assertRaises(ValueError, sys.setswitchinterval, 0.0)
+        orig = sys.getswitchinterval()
+        # sanity check
+        self.assertTrue(orig < 0.5, orig)
+        try:
+            for n in 0.00001, 0.05, 3.0, orig:
+                sys.setswitchinterval(n)
+                self.assertAlmostEqual(sys.getswitchinterval(), n)
+        finally:
+            sys.setswitchinterval(orig)
+
+    @unittest.skipUnless(hasattr(sys, "_arenastats"), "requires pymalloc")
+    def test_arenastats(self):
+        stats = sys._arenastats()
+        self.assertLessEqual(set(sys._mallocstats()), set(stats))
+        for c in stats['size_classes']:
+            self.assertLessEqual(c['used_bytes'], c['resident_bytes'])
+        def used(stats):
+            return sum([c['used_bytes'] for c in stats['size_classes']])
+        before = used(stats)
+        l = ['x%d' % i for i in range(100000)]
+        self.assertGreater(used(sys._arenastats()), before + 1000000)
+        del l
+
+    @unittest.skipUnless(hasattr(sys, "_arenastats"), "requires pymalloc")
+    def test_arenastats_release(self):
+        stats = sys._arenastats()
+        if (not stats['mmap'] or stats['huge_pages'] or
+            os.sysconf('SC_PAGE_SIZE') != stats['pool_size']):
+            self.skipTest("pools are only released from mmap()ed arenas "
+                          "of pages the size of a pool")
+        # Keep one string in 500 alive, so that the arenas stay but most
+        # of their pools become free when the others go.
+        l = ['x%d' % i for i in range(200000)]
+        kept = l[::500]
+        during = sys._arenastats()
+        del l
+        after = sys._arenastats()
+        self.assertGreater(after['pools_released'], during['pools_released'])
+        self.assertGreater(after['released_bytes'],
+                           during['released_bytes'] + 1000000)
+        self.assertLess(after['resident_bytes'], during['resident_bytes'])
+        del kept
+
+    @unittest.skipUnless(hasattr(sys, "_mallocstats"), "requires pymalloc")
+    def test_mallocstats(self):
+        stats = sys._mallocstats()
+        self.assertLessEqual(stats['arenas'], stats['arenas_highwater'])
+        def in_use(stats):
+            return sum([c['in_use'] for c in stats['size_classes']])
+        l = ['x%d' % i for i in range(100000)]
+        during = sys._mallocstats()
+        self.assertGreaterEqual(in_use(during), in_use(stats) + 100000)
+        del l
+        self.assertLess(in_use(sys._mallocstats()), in_use(during) - 90000)
+        big = 'x' * (stats['small_request_threshold'] * 10)
+        after = sys._mallocstats()
+        self.assertGreater(after['system_mallocs'], stats['system_mallocs'])
+        self.assertGreater(after['system_bytes'],
+                           stats['system_bytes'] + len(big))
+        del big
+        self.assertGreater(sys._mallocstats()['system_frees'],
+                           after['system_frees'])
+
+    def test_opcodeprofile(self):
+        import opcode
+        def f(n):
+            t = 0
+            for i in range(n):
+                t += i
+            return t
+        self.assertRaises(TypeError, sys.setopcodeprofile)
+        sys.getopcodeprofile(True)
+        sys.setopcodeprofile(True)
+        try:
+            f(50)
+        finally:
+            sys.setopcodeprofile(False)
+        f(50)
+        profile = sys.getopcodeprofile()
+        counts = profile['opcodes']
+        self.assertEqual(len(counts), 256)
+        self.assertEqual(counts[opcode.opmap['INPLACE_ADD']], 50)
+        self.assertEqual(counts[opcode.opmap['FOR_ITER']], 51)
+        pair = (opcode.opmap['FOR_ITER'], opcode.opmap['STORE_FAST'])
+        self.assertEqual(profile['pairs'][pair], 50)
+        offsets = profile['offsets'][f.func_code]
+        code = f.func_code.co_code
+        for offset, count in offsets.items():
+            if ord(code[offset]) == opcode.opmap['INPLACE_ADD']:
+                self.assertEqual(count, 50)
+        self.assertEqual(max(offsets.values()), 51)
+        # reading with reset clears the counts
+        sys.getopcodeprofile(True)
+        profile = sys.getopcodeprofile()
+        self.assertEqual(sum(profile['opcodes']), 0)
+        self.assertEqual(profile['pairs'], {})
+        self.assertEqual(profile['offsets'], {})
+
     def test_recursionlimit(self):
         self.assertRaises(TypeError, sys.getrecursionlimit, 42)
         oldlimit = sys.getrecursionlimit()
@@ -281,16 +386,46 @@ class SysModuleTest(unittest.TestCase):
         # tracing with a python function.  Tracing calls PyFrame_FastToLocals
         # which will add a copy of any locals to the frame object, causing
         # the reference count to increase by 2 instead of 1.
+        # None is immortal, see test_immortal.
         global n
         self.assertRaises(TypeError, sys.getrefcount)
-        c = sys.getrefcount(None)
-        n = None
-        self.assertEqual(sys.getrefcount(None), c+1)
+        o = object()
+        c = sys.getrefcount(o)
+        n = o
+        self.assertEqual(sys.getrefcount(o), c+1)
         del n
-        self.assertEqual(sys.getrefcount(None), c)
+        self.assertEqual(sys.getrefcount(o), c)
         if hasattr(sys, "gettotalrefcount"):
             self.assertIsInstance(sys.gettotalrefcount(), int)
 
+    @unittest.skipUnless(sys.getrefcount(None) > 2**28,
+                         "requires immortal objects")
+    def test_immortal(self):
+        for obj in (None, True, False, Ellipsis, NotImplemented, (), '',
+                    'a', u'', -5, 0, 256, frozenset(), '__init__'):
+            c = sys.getrefcount(obj)
+            l = [obj] * 100
+            self.assertEqual(sys.getrefcount(obj), c, repr(obj))
+            del l
+            self.assertEqual(sys.getrefcount(obj), c, repr(obj))
+        # Other ints and strings are counted as usual
+        for obj in (257, 'not an identifier'):
+            c = sys.getrefcount(obj)
+            l = [obj] * 100
+            self.assertEqual(sys.getrefcount(obj), c + 100)
+        # So are names that C code interns at run time, here through
+        # PyObject_GetAttrString() when cPickle saves a global
+        import cPickle
+        def f():
+            pass
+        f.__name__ = name = 'run_time_name_%d' % id(self)
+        globals()[name] = f
+        try:
+            cPickle.dumps(f)
+            self.assertLess(sys.getrefcount(intern(name)), 2**28)
+        finally:
+            del globals()[name]
+
     def test_getframe(self):
         self.assertRaises(TypeError, sys._getframe, 42, 42)
         self.assertRaises(ValueError, sys._getframe, 2000000000)
@@ -587,7 +722,7 @@ class SizeofTest(unittest.TestCase):
         # complex
         check(complex(0,1), size(h + '2d'))
         # code
-        check(get_cell().func_code, size(h + '4i8Pi3P'))
+        check(get_cell().func_code, size(h + '4i8Pi5P'))
         # BaseException
         check(BaseException(), size(h + '3P'))
         # UnicodeEncodeError
@@ -741,8 +876,8 @@ class SizeofTest(unittest.TestCase):
         # super
         check(super(int), size(h + '3P'))
         # tuple
-        check((), size(vh))
-        check((1,2,3), size(vh) + 3*self.P)
+        check((), size(vh + 'P'))
+        check((1,2,3), size(vh + 'P') + 3*self.P)
         # tupleiterator
         check(iter(()), size(h + 'lP'))
         # type
@@ -130,6 +130,38 @@ class ThreadRunningTests(BasicThreadTest):
             time.sleep(0.01)
         self.assertEqual(thread._count(), orig)
 
+    @unittest.skipUnless(hasattr(sys, "getgilstats"), "requires getgilstats")
+    def test_gil_stats(self):
+        # Two busy threads have to take turns with the GIL
+        self.assertRaises(TypeError, sys.getgilstats, 1, 2)
+        orig = thread._count()
+        def spin():
+            end = time.time() + 0.1
+            while time.time() < end:
+                pass
+            with self.running_mutex:
+                self.running -= 1
+                if self.running == 0:
+                    self.done_mutex.release()
+        interval = sys.getswitchinterval()
+        sys.setswitchinterval(0.001)
+        try:
+            sys.getgilstats(True)
+            self.running = 2
+            for i in range(2):
+                thread.start_new_thread(spin, ())
+            self.done_mutex.acquire()
+            while thread._count() > orig:
+                time.sleep(0.01)
+        finally:
+            sys.setswitchinterval(interval)
+        stats = sys.getgilstats(True)
+        self.assertGreater(stats['switches'], 0)
+        self.assertGreater(stats['waits'], 0)
+        self.assertGreater(stats['drop_requests'], 0)
+        self.assertGreater(stats['hold_time'], 0.0)
+        self.assertEqual(sys.getgilstats()['waits'], 0)
+
 
 class Barrier:
     def __init__(self, num_threads):
@@ -511,16 +511,13 @@ class ThreadJoinOnShutdown(BaseTestCase):
         # thread.  See http://bugs.python.org/issue6643.
 
         # The script takes the following steps:
-        # - The main thread in the parent process starts a new thread and then
-        #   tries to join it.
-        # - The join operation acquires the Lock inside the thread's _block
-        #   Condition.  (See threading.py:Thread.join().)
-        # - We stub out the acquire method on the condition to force it to wait
-        #   until the child thread forks.  (See LOCK ACQUIRED HERE)
-        # - The child thread forks.  (See LOCK HELD and WORKER THREAD FORKS
-        #   HERE)
-        # - The main thread of the parent process enters Condition.wait(),
-        #   which releases the lock on the child thread.
+        # - The main thread in the parent process starts a new thread and
+        #   acquires the lock of the thread's _block Condition, the one that
+        #   join() acquires.  (See LOCK ACQUIRED HERE)
+        # - The child thread forks while the main thread holds the lock.
+        #   (See LOCK HELD and WORKER THREAD FORKS HERE)
+        # - The main thread of the parent process releases the lock and
+        #   joins the child thread.
         # - The child process returns.  Without the necessary fix, when the
         #   main thread of the child process (which used to be the child thread
         #   in the parent process) attempts to exit, it will try to acquire the
@@ -548,30 +545,18 @@ class ThreadJoinOnShutdown(BaseTestCase):
                 # Child process should just return.
 
             w = threading.Thread(target=worker)
+            w.start()
 
-            # Stub out the private condition variable's lock acquire method.
-            # This acquires the lock and then waits until the child has forked
-            # before returning, which will release the lock soon after.  If
-            # someone else tries to fix this test case by acquiring this lock
-            # before forking instead of resetting it, the test case will
-            # deadlock when it shouldn't.
+            # Hold the lock until the worker has forked.  If someone else
+            # tries to fix this test case by acquiring this lock before
+            # forking instead of resetting it, the test case will deadlock
+            # when it shouldn't.
             condition = w._block
-            orig_acquire = condition.acquire
-            call_count_lock = threading.Lock()
-            call_count = 0
-            def my_acquire():
-                global call_count
-                global start_fork
-                orig_acquire()  # LOCK ACQUIRED HERE
-                start_fork = True
-                if call_count == 0:
-                    while not finish_join:
-                        time.sleep(0.01)  # WORKER THREAD FORKS HERE
-                with call_count_lock:
-                    call_count += 1
-            condition.acquire = my_acquire
-
-            w.start()
+            condition.acquire()  # LOCK ACQUIRED HERE
+            start_fork = True
+            while not finish_join:
+                time.sleep(0.01)  # WORKER THREAD FORKS HERE
+            condition.release()
             w.join()
             print('end of main')
             """
@@ -597,10 +582,14 @@ class ThreadJoinOnShutdown(BaseTestCase):
             start_fork = False
 
             def worker():
-                # Wait until the main thread has attempted to join this thread
-                # before continuing.
+                # Wait until the main thread waits on this thread's condition
+                # variable.  It only releases the condition's lock in wait(),
+                # once its waiter lock has been acquired and put onto the
+                # waiters list.
                 while not start_fork:
                     time.sleep(0.01)
+                condition.acquire()
+                condition.release()
                 childpid = os.fork()
                 if childpid != 0:
                     # Parent process just waits for child.
@@ -613,22 +602,14 @@ class ThreadJoinOnShutdown(BaseTestCase):
                     pass
 
             w = threading.Thread(target=worker)
-
-            # Stub out the private condition variable's _release_save method.
-            # This releases the condition's lock and flips the global that
-            # causes the worker to fork.  At this point, the problematic waiter
-            # lock has been acquired once by the waiter and has been put onto
-            # the waiters list.
             condition = w._block
-            orig_release_save = condition._release_save
-            def my_release_save():
-                global start_fork
-                orig_release_save()
-                # Waiter lock held here, condition lock released.
-                start_fork = True
-            condition._release_save = my_release_save
-
             w.start()
+
+            # Wait on the condition like join() does; the worker notifies it
+            # when it ends.
+            with condition:
+                start_fork = True
+                condition.wait()
             w.join()
             print('end of main thread')
             """
@@ -688,6 +669,12 @@ class LockTests(lock_tests.LockTests):
 class RLockTests(lock_tests.RLockTests):
     locktype = staticmethod(threading.RLock)
 
+class PyRLockTests(lock_tests.RLockTests):
+    locktype = staticmethod(threading._RLock)
+
+class CRLockTests(lock_tests.RLockTests, lock_tests.TimeoutLockTests):
+    locktype = staticmethod(threading._CRLock)
+
 class EventTests(lock_tests.EventTests):
     eventtype = staticmethod(threading.Event)
 
@@ -695,9 +682,25 @@ class ConditionAsRLockTests(lock_tests.RLockTests):
     # An Condition uses an RLock by default and exports its API.
     locktype = staticmethod(threading.Condition)
 
+class PyConditionAsRLockTests(lock_tests.RLockTests):
+    locktype = staticmethod(threading._Condition)
+
 class ConditionTests(lock_tests.ConditionTests):
     condtype = staticmethod(threading.Condition)
 
+class PyConditionTests(lock_tests.ConditionTests):
+    condtype = staticmethod(threading._Condition)
+
+def _condition_with_py_rlock(lock=None):
+    # The C condition operates on a lock of another type through its
+    # methods
+    if lock is None:
+        lock = threading._RLock()
+    return threading._CCondition(lock)
+
+class CConditionPyRLockTests(lock_tests.ConditionTests):
+    condtype = staticmethod(_condition_with_py_rlock)
+
 class SemaphoreTests(lock_tests.SemaphoreTests):
     semtype = staticmethod(threading.Semaphore)
 
@@ -737,8 +740,11 @@ class BoundedSemaphoreTests(lock_tests.BoundedSemaphoreTests):
         self.assertEqual(data, expected_output)
 
 def test_main():
-    test.test_support.run_unittest(LockTests, RLockTests, EventTests,
-                                   ConditionAsRLockTests, ConditionTests,
+    test.test_support.run_unittest(LockTests, RLockTests, PyRLockTests,
+                                   CRLockTests, EventTests,
+                                   ConditionAsRLockTests,
+                                   PyConditionAsRLockTests, ConditionTests,
+                                   PyConditionTests, CConditionPyRLockTests,
                                    SemaphoreTests, BoundedSemaphoreTests,
                                    ThreadTests,
                                    ThreadJoinOnShutdown,
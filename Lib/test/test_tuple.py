@@ -1,6 +1,7 @@
 from test import test_support, seq_tests
 
 import gc
+import itertools
 
 class TupleTest(seq_tests.CommonTest):
     type2test = tuple
@@ -73,6 +74,55 @@ class TupleTest(seq_tests.CommonTest):
         collisions = len(inps) - len(set(map(hash, inps)))
         self.assertTrue(collisions <= 15)
 
+    def test_hash_small_ints(self):
+        # Tuples of small ints must spread over the low bits too, or
+        # they cluster in a dict (especially with linear probing).
+        xp = [(i, j) for i in range(64) for j in range(64)]
+        low = set([hash(t) & 0xfff for t in xp])
+        self.assertGreater(len(low), 2000)
+
+    @test_support.cpython_only
+    def test_hash_cache(self):
+        class H(object):
+            calls = 0
+            def __init__(self, value):
+                self.value = value
+            def __hash__(self):
+                H.calls += 1
+                return self.value
+        # Tuples of ints, strings, ... cache their hash
+        t = (1, 'a', u'b', 2.5, None, (3L, frozenset([4])))
+        self.assertEqual(hash(t), hash(t))
+        self.assertEqual(hash(t), hash((1, 'a', u'b', 2.5, None,
+                                        (3L, frozenset([4])))))
+        # but not if an item may change its hash
+        h = H(1)
+        t = (1, (2, h))
+        first = hash(t)
+        self.assertEqual(H.calls, 1)
+        self.assertEqual(hash(t), first)
+        self.assertEqual(H.calls, 2)
+        h.value = 2
+        self.assertNotEqual(hash(t), first)
+        # Result tuples recycled by iterators forget their hash
+        hashes = [hash(p) for p in enumerate('ab')]
+        self.assertEqual(hashes, [hash((0, 'a')), hash((1, 'b'))])
+        hashes = [hash(p) for p in zip('ab', 'cd')]
+        self.assertEqual(hashes, [hash(('a', 'c')), hash(('b', 'd'))])
+        hashes = [hash(p) for p in itertools.izip('ab', 'cd')]
+        self.assertEqual(hashes, [hash(('a', 'c')), hash(('b', 'd'))])
+        hashes = [hash(p) for p in itertools.product('a', 'cd')]
+        self.assertEqual(hashes, [hash(('a', 'c')), hash(('a', 'd'))])
+        d = {'a': 1, 'b': 2}
+        hashes = [hash(p) for p in d.iteritems()]
+        self.assertEqual(hashes, [hash(p) for p in d.items()])
+        # Tuple subclasses too
+        class T(tuple):
+            pass
+        t = T((1, 2))
+        self.assertEqual(hash(t), hash((1, 2)))
+        self.assertEqual(hash(t), hash((1, 2)))
+
     def test_repr(self):
         l0 = tuple()
         l2 = (0, 1, 2)
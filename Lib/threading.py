@@ -34,6 +34,12 @@ _start_new_thread = thread.start_new_thread
 _allocate_lock = thread.allocate_lock
 _get_ident = thread.get_ident
 ThreadError = thread.error
+try:
+    _CRLock = thread.RLock
+    _CCondition = thread.Condition
+    TIMEOUT_MAX = thread.TIMEOUT_MAX
+except AttributeError:
+    _CRLock = _CCondition = None
 del thread
 
 
@@ -97,8 +103,13 @@ def settrace(func):
 
 Lock = _allocate_lock
 
-def RLock(*args, **kwargs):
-    return _RLock(*args, **kwargs)
+def RLock(verbose=None, *args, **kwargs):
+    # The C implementation can't print debugging notes
+    if verbose is None:
+        verbose = _VERBOSE
+    if (__debug__ and verbose) or _CRLock is None:
+        return _RLock(verbose, *args, **kwargs)
+    return _CRLock(*args, **kwargs)
 
 class _RLock(_Verbose):
 
@@ -177,8 +188,12 @@ class _RLock(_Verbose):
         return self.__owner == _get_ident()
 
 
-def Condition(*args, **kwargs):
-    return _Condition(*args, **kwargs)
+def Condition(lock=None, verbose=None):
+    if verbose is None:
+        verbose = _VERBOSE
+    if (__debug__ and verbose) or _CCondition is None:
+        return _Condition(lock, verbose)
+    return _CCondition(lock)
 
 class _Condition(_Verbose):
 
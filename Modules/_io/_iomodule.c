@@ -285,11 +285,12 @@ PyDoc_STRVAR(open_doc,
     );
 
 static PyObject *
-io_open(PyObject *self, PyObject *args, PyObject *kwds)
+io_open(PyObject *self, PyObject **args, Py_ssize_t nargs, PyObject *kwnames)
 {
-    char *kwlist[] = {"file", "mode", "buffering",
-                      "encoding", "errors", "newline",
-                      "closefd", NULL};
+    static const char * const kwlist[] = {"file", "mode", "buffering",
+                                          "encoding", "errors", "newline",
+                                          "closefd", NULL};
+    static _PyArg_Parser _parser = {"O|sizzzi:open", kwlist, 0};
     PyObject *file;
     char *mode = "r";
     int buffering = -1, closefd = 1;
@@ -304,10 +305,10 @@ io_open(PyObject *self, PyObject *args, PyObject *kwds)
 
     PyObject *raw, *modeobj = NULL, *buffer = NULL, *wrapper = NULL;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|sizzzi:open", kwlist,
-                                     &file, &mode, &buffering,
-                                     &encoding, &errors, &newline,
-                                     &closefd)) {
+    if (!_PyArg_ParseStackAndKeywords(args, nargs, kwnames, &_parser,
+                                      &file, &mode, &buffering,
+                                      &encoding, &errors, &newline,
+                                      &closefd)) {
         return NULL;
     }
 
@@ -615,7 +616,7 @@ PyObject *_PyIO_locale_module = NULL;
 PyObject *_PyIO_unsupported_operation = NULL;
 
 static PyMethodDef module_methods[] = {
-    {"open", (PyCFunction)io_open, METH_VARARGS|METH_KEYWORDS, open_doc},
+    {"open", (PyCFunction)io_open, METH_FASTCALL, open_doc},
     {NULL, NULL}
 };
 
@@ -553,12 +553,13 @@ stringio_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 static int
 stringio_init(stringio *self, PyObject *args, PyObject *kwds)
 {
-    char *kwlist[] = {"initial_value", "newline", NULL};
+    static const char * const kwlist[] = {"initial_value", "newline", NULL};
+    static _PyArg_Parser _parser = {"|Oz:__init__", kwlist, 0};
     PyObject *value = NULL;
     char *newline = "\n";
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Oz:__init__", kwlist,
-                                     &value, &newline))
+    if (!_PyArg_ParseTupleAndKeywordsFast(args, kwds, &_parser,
+                                          &value, &newline))
         return -1;
 
     if (newline && newline[0] != '\0'
@@ -202,10 +202,13 @@ incrementalnewlinedecoder_init(nldecoder_object *self,
     PyObject *decoder;
     int translate;
     PyObject *errors = NULL;
-    char *kwlist[] = {"decoder", "translate", "errors", NULL};
+    static const char * const kwlist[] = {"decoder", "translate", "errors",
+                                          NULL};
+    static _PyArg_Parser _parser = {"Oi|O:IncrementalNewlineDecoder",
+                                    kwlist, 0};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "Oi|O:IncrementalNewlineDecoder",
-                                     kwlist, &decoder, &translate, &errors))
+    if (!_PyArg_ParseTupleAndKeywordsFast(args, kwds, &_parser,
+                                          &decoder, &translate, &errors))
         return -1;
 
     self->decoder = decoder;
@@ -463,12 +466,14 @@ static PyObject *
 incrementalnewlinedecoder_decode(nldecoder_object *self,
                                  PyObject *args, PyObject *kwds)
 {
-    char *kwlist[] = {"input", "final", NULL};
+    static const char * const kwlist[] = {"input", "final", NULL};
+    static _PyArg_Parser _parser = {"O|i:IncrementalNewlineDecoder",
+                                    kwlist, 0};
     PyObject *input;
     int final = 0;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|i:IncrementalNewlineDecoder",
-                                     kwlist, &input, &final))
+    if (!_PyArg_ParseTupleAndKeywordsFast(args, kwds, &_parser,
+                                          &input, &final))
         return NULL;
     return _PyIncrementalNewlineDecoder_decode((PyObject *) self, input, final);
 }
@@ -807,9 +812,10 @@ static encodefuncentry encodefuncs[] = {
 static int
 textiowrapper_init(textio *self, PyObject *args, PyObject *kwds)
 {
-    char *kwlist[] = {"buffer", "encoding", "errors",
-                      "newline", "line_buffering",
-                      NULL};
+    static const char * const kwlist[] = {"buffer", "encoding", "errors",
+                                          "newline", "line_buffering",
+                                          NULL};
+    static _PyArg_Parser _parser = {"O|zzzi:fileio", kwlist, 0};
     PyObject *buffer, *raw;
     char *encoding = NULL;
     char *errors = NULL;
@@ -821,9 +827,9 @@ textiowrapper_init(textio *self, PyObject *args, PyObject *kwds)
 
     self->ok = 0;
     self->detached = 0;
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|zzzi:fileio",
-                                     kwlist, &buffer, &encoding, &errors,
-                                     &newline, &line_buffering))
+    if (!_PyArg_ParseTupleAndKeywordsFast(args, kwds, &_parser,
+                                          &buffer, &encoding, &errors,
+                                          &newline, &line_buffering))
         return -1;
 
     if (newline && newline[0] != '\0'
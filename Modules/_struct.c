@@ -1367,12 +1367,13 @@ s_init(PyObject *self, PyObject *args, PyObject *kwds)
     PyStructObject *soself = (PyStructObject *)self;
     PyObject *o_format = NULL;
     int ret = 0;
-    static char *kwlist[] = {"format", 0};
+    static const char * const kwlist[] = {"format", 0};
+    static _PyArg_Parser _parser = {"S:Struct", kwlist, 0};
 
     assert(PyStruct_Check(self));
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "S:Struct", kwlist,
-                                     &o_format))
+    if (!_PyArg_ParseTupleAndKeywordsFast(args, kwds, &_parser,
+                                          &o_format))
         return -1;
 
     Py_INCREF(o_format);
@@ -1481,20 +1482,16 @@ See struct.__doc__ for more on format strings.");
 static PyObject *
 s_unpack_from(PyObject *self, PyObject *args, PyObject *kwds)
 {
-    static char *kwlist[] = {"buffer", "offset", 0};
-#if (PY_VERSION_HEX < 0x02050000)
-    static char *fmt = "z#|i:unpack_from";
-#else
-    static char *fmt = "z#|n:unpack_from";
-#endif
+    static const char * const kwlist[] = {"buffer", "offset", 0};
+    static _PyArg_Parser _parser = {"z#|n:unpack_from", kwlist, 0};
     Py_ssize_t buffer_len = 0, offset = 0;
     char *buffer = NULL;
     PyStructObject *soself = (PyStructObject *)self;
     assert(PyStruct_Check(self));
     assert(soself->s_codes != NULL);
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, fmt, kwlist,
-                                     &buffer, &buffer_len, &offset))
+    if (!_PyArg_ParseTupleAndKeywordsFast(args, kwds, &_parser,
+                                          &buffer, &buffer_len, &offset))
         return NULL;
 
     if (buffer == NULL) {
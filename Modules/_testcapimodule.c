@@ -856,6 +856,58 @@ static PyObject *getargs_keywords(PyObject *self, PyObject *args, PyObject *kwar
         int_args[5], int_args[6], int_args[7], int_args[8], int_args[9]);
 }
 
+/* test _PyArg_ParseTupleAndKeywordsFast, same format as getargs_keywords */
+static const char * const getargs_keywords_kwlist[] = {
+    "arg1", "arg2", "arg3", "arg4", "arg5", NULL};
+static _PyArg_Parser getargs_keywords_parser = {
+    "(ii)i|(i(ii))(iii)i", getargs_keywords_kwlist, 0};
+
+static PyObject *
+getargs_keywords_fast(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    int int_args[10]={-1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+
+    if (!_PyArg_ParseTupleAndKeywordsFast(args, kwargs,
+        &getargs_keywords_parser,
+        &int_args[0], &int_args[1], &int_args[2], &int_args[3], &int_args[4],
+        &int_args[5], &int_args[6], &int_args[7], &int_args[8], &int_args[9]))
+        return NULL;
+    return Py_BuildValue("iiiiiiiiii",
+        int_args[0], int_args[1], int_args[2], int_args[3], int_args[4],
+        int_args[5], int_args[6], int_args[7], int_args[8], int_args[9]);
+}
+
+/* test _PyArg_ParseStackAndKeywords, sharing the parser above */
+static PyObject *
+getargs_keywords_stack(PyObject *self, PyObject **args, Py_ssize_t nargs,
+                       PyObject *kwnames)
+{
+    int int_args[10]={-1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+
+    if (!_PyArg_ParseStackAndKeywords(args, nargs, kwnames,
+        &getargs_keywords_parser,
+        &int_args[0], &int_args[1], &int_args[2], &int_args[3], &int_args[4],
+        &int_args[5], &int_args[6], &int_args[7], &int_args[8], &int_args[9]))
+        return NULL;
+    return Py_BuildValue("iiiiiiiiii",
+        int_args[0], int_args[1], int_args[2], int_args[3], int_args[4],
+        int_args[5], int_args[6], int_args[7], int_args[8], int_args[9]);
+}
+
+/* A parser with more keywords than format units: the error is raised
+   on every call, not only when the parser is first initialized */
+static PyObject *
+getargs_keywords_badformat(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    static const char * const kwlist[] = {"a", "b", NULL};
+    static _PyArg_Parser _parser = {"i:badformat", kwlist, 0};
+    int a = 0, b = 0;
+
+    if (!_PyArg_ParseTupleAndKeywordsFast(args, kwargs, &_parser, &a, &b))
+        return NULL;
+    Py_RETURN_NONE;
+}
+
 /* Functions to call PyArg_ParseTuple with integer format codes,
    and return the result.
 */
@@ -1230,6 +1282,34 @@ test_long_numbits(PyObject *self)
     return Py_None;
 }
 
+/* A METH_FASTCALL function returning its positional arguments, the
+   keyword names and the keyword values as three tuples */
+static PyObject *
+fastcall_args(PyObject *self, PyObject **args, Py_ssize_t nargs,
+              PyObject *kwnames)
+{
+    Py_ssize_t i, nkw = kwnames == NULL ? 0 : PyTuple_GET_SIZE(kwnames);
+    PyObject *posargs, *kwvalues;
+
+    posargs = PyTuple_New(nargs);
+    kwvalues = PyTuple_New(nkw);
+    if (posargs == NULL || kwvalues == NULL) {
+        Py_XDECREF(posargs);
+        Py_XDECREF(kwvalues);
+        return NULL;
+    }
+    for (i = 0; i < nargs; i++) {
+        Py_INCREF(args[i]);
+        PyTuple_SET_ITEM(posargs, i, args[i]);
+    }
+    for (i = 0; i < nkw; i++) {
+        Py_INCREF(args[nargs + i]);
+        PyTuple_SET_ITEM(kwvalues, i, args[nargs + i]);
+    }
+    return Py_BuildValue("NON", posargs,
+                         kwnames == NULL ? Py_None : kwnames, kwvalues);
+}
+
 /* Example passing NULLs to PyObject_Str(NULL) and PyObject_Unicode(NULL). */
 
 static PyObject *
@@ -1706,9 +1786,16 @@ static PyMethodDef TestMethods[] = {
     {"test_with_docstring", (PyCFunction)test_with_docstring, METH_NOARGS,
      PyDoc_STR("This is a pretty normal docstring.")},
 
+    {"fastcall_args", (PyCFunction)fastcall_args, METH_FASTCALL},
     {"getargs_tuple",           getargs_tuple,                   METH_VARARGS},
     {"getargs_keywords", (PyCFunction)getargs_keywords,
       METH_VARARGS|METH_KEYWORDS},
+    {"getargs_keywords_fast", (PyCFunction)getargs_keywords_fast,
+      METH_VARARGS|METH_KEYWORDS},
+    {"getargs_keywords_stack", (PyCFunction)getargs_keywords_stack,
+      METH_FASTCALL},
+    {"getargs_keywords_badformat", (PyCFunction)getargs_keywords_badformat,
+      METH_VARARGS|METH_KEYWORDS},
     {"getargs_b",               getargs_b,                       METH_VARARGS},
     {"getargs_B",               getargs_B,                       METH_VARARGS},
     {"getargs_h",               getargs_h,                       METH_VARARGS},
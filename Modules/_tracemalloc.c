@@ -0,0 +1,797 @@
+/* Allocation tracer.
+
+   Installs itself as the allocation tracer of the PyMem_ and PyObject_
+   allocators (see pymem.h) and remembers, for every live memory block, its
+   size and the traceback of the Python code that allocated it.  Tracebacks
+   are interned, so that all the blocks allocated by the same line share
+   one.  Lib/tracemalloc.py builds snapshots and statistics on top of this.
+
+   The hooks can run without the GIL (PyOS_Readline() allocates with the
+   GIL released, for example), so the table of traces is protected by a
+   lock of its own.  The interned tracebacks are only touched with the GIL
+   held; a block allocated without the GIL gets the empty traceback.  The
+   tracer's own memory comes from the platform malloc, which it does not
+   trace.
+*/
+
+#include "Python.h"
+#include "frameobject.h"
+#ifdef WITH_THREAD
+#include "pythread.h"
+#endif
+
+PyDoc_STRVAR(module_doc,
+"Debug module to trace memory blocks allocated by Python.");
+
+#if Py_TRACEMALLOC
+
+/* Maximum number of frames stored in a traceback. */
+#define MAX_NFRAME 100
+
+typedef struct {
+    PyObject *filename;
+    int lineno;
+} frame_t;
+
+typedef struct traceback {
+    struct traceback *next;     /* next traceback in the same bucket */
+    long hash;
+    int nframe;
+    frame_t frames[1];
+} traceback_t;
+
+#define TRACEBACK_SIZE(nframe) \
+    (sizeof(traceback_t) + ((nframe) - 1) * sizeof(frame_t))
+
+/* A live block.  The table of traces uses open addressing with linear
+   probing; a slot with ptr == 0 is empty. */
+typedef struct {
+    Py_uintptr_t ptr;
+    size_t size;
+    traceback_t *traceback;
+} trace_t;
+
+#define TRACES_MINSIZE 1024
+
+static struct {
+    int tracing;                /* the hooks are installed */
+    int max_nframe;             /* frames stored per traceback */
+    int sample_rate;            /* trace one allocation in sample_rate */
+    int countdown;              /* allocations left until the next sample */
+
+    /* The traces, protected by lock. */
+    trace_t *traces;
+    size_t traces_mask;
+    size_t ntraces;
+    size_t traced_memory;
+    size_t peak_traced_memory;
+
+    /* The interned tracebacks, protected by the GIL. */
+    traceback_t **tracebacks;
+    size_t tracebacks_mask;
+    size_t ntracebacks;
+    size_t tracebacks_memory;
+} tracer = {0, 1, 1, 1};
+
+#ifdef WITH_THREAD
+static PyThread_type_lock tables_lock = NULL;
+#define TABLES_LOCK() PyThread_acquire_lock(tables_lock, WAIT_LOCK)
+#define TABLES_UNLOCK() PyThread_release_lock(tables_lock)
+#else
+#define TABLES_LOCK()
+#define TABLES_UNLOCK()
+#endif
+
+/* Allocations made without the GIL, or with no Python frame at all. */
+static traceback_t empty_traceback = {NULL, 0, 0};
+
+/* --- the table of traces ------------------------------------------------ */
+
+static size_t
+ptr_hash(Py_uintptr_t ptr)
+{
+    /* Blocks are at least 8-byte aligned:  drop the low bits and let a
+       Fibonacci multiplication spread the rest over the whole word. */
+    size_t h = (size_t)(ptr >> 3);
+#if SIZEOF_SIZE_T > 4
+    h *= (size_t)0x9E3779B97F4A7C15ULL;
+    return h ^ (h >> 32);
+#else
+    h *= (size_t)0x9E3779B9UL;
+    return h ^ (h >> 16);
+#endif
+}
+
+static trace_t *
+traces_lookup(Py_uintptr_t ptr)
+{
+    size_t mask = tracer.traces_mask;
+    size_t i = ptr_hash(ptr) & mask;
+
+    while (tracer.traces[i].ptr != 0) {
+        if (tracer.traces[i].ptr == ptr)
+            return &tracer.traces[i];
+        i = (i + 1) & mask;
+    }
+    return NULL;
+}
+
+/* Remove the trace in slot t and shift the entries of its cluster back
+   into place, so that lookups never need tombstones. */
+static void
+traces_remove(trace_t *t)
+{
+    trace_t *table = tracer.traces;
+    size_t mask = tracer.traces_mask;
+    size_t i = t - table, j = i, home;
+
+    tracer.traced_memory -= t->size;
+    tracer.ntraces--;
+    for (;;) {
+        table[i].ptr = 0;
+        for (;;) {
+            j = (j + 1) & mask;
+            if (table[j].ptr == 0)
+                return;
+            home = ptr_hash(table[j].ptr) & mask;
+            /* Move entry j to i unless its home lies cyclically in (i, j]. */
+            if (i <= j ? (i < home && home <= j) : (i < home || home <= j))
+                continue;
+            break;
+        }
+        table[i] = table[j];
+        i = j;
+    }
+}
+
+static int
+traces_resize(size_t newsize)
+{
+    trace_t *old = tracer.traces, *table;
+    size_t oldsize = old ? tracer.traces_mask + 1 : 0;
+    size_t i, j;
+
+    table = (trace_t *)calloc(newsize, sizeof(trace_t));
+    if (table == NULL)
+        return -1;
+    for (i = 0; i < oldsize; i++) {
+        if (old[i].ptr == 0)
+            continue;
+        j = ptr_hash(old[i].ptr) & (newsize - 1);
+        while (table[j].ptr != 0)
+            j = (j + 1) & (newsize - 1);
+        table[j] = old[i];
+    }
+    tracer.traces = table;
+    tracer.traces_mask = newsize - 1;
+    free(old);
+    return 0;
+}
+
+/* Record a block; an entry left behind for the same address (a block freed
+   behind the allocators' back) is replaced.  Called with the lock held. */
+static void
+traces_add(Py_uintptr_t ptr, size_t size, traceback_t *traceback)
+{
+    trace_t *t;
+    size_t i;
+
+    if (tracer.traces == NULL)
+        return;
+    t = traces_lookup(ptr);
+    if (t != NULL) {
+        tracer.traced_memory -= t->size;
+    }
+    else {
+        if ((tracer.ntraces + 1) * 3 >= (tracer.traces_mask + 1) * 2
+            && traces_resize((tracer.traces_mask + 1) * 2) < 0)
+            return;     /* out of memory:  leave the block untraced */
+        i = ptr_hash(ptr) & tracer.traces_mask;
+        while (tracer.traces[i].ptr != 0)
+            i = (i + 1) & tracer.traces_mask;
+        t = &tracer.traces[i];
+        t->ptr = ptr;
+        tracer.ntraces++;
+    }
+    t->size = size;
+    t->traceback = traceback;
+    tracer.traced_memory += size;
+    if (tracer.traced_memory > tracer.peak_traced_memory)
+        tracer.peak_traced_memory = tracer.traced_memory;
+}
+
+/* --- interned tracebacks ------------------------------------------------ */
+
+static long
+traceback_hash(frame_t *frames, int nframe)
+{
+    long x = 0x345678L, mult = 1000003L;
+    int i;
+
+    for (i = 0; i < nframe; i++) {
+        x = (x ^ _Py_HashPointer(frames[i].filename)) * mult;
+        mult += 82520L + 2 * (nframe - i);
+        x = (x ^ frames[i].lineno) * mult;
+    }
+    x += 97531L;
+    return x;
+}
+
+static traceback_t *
+traceback_intern(frame_t *frames, int nframe)
+{
+    long hash = traceback_hash(frames, nframe);
+    traceback_t *tb, **bucket;
+    int i;
+
+    if (tracer.tracebacks == NULL)
+        return NULL;
+    bucket = &tracer.tracebacks[(size_t)hash & tracer.tracebacks_mask];
+    for (tb = *bucket; tb != NULL; tb = tb->next) {
+        if (tb->hash != hash || tb->nframe != nframe)
+            continue;
+        for (i = 0; i < nframe; i++) {
+            if (tb->frames[i].filename != frames[i].filename
+                || tb->frames[i].lineno != frames[i].lineno)
+                break;
+        }
+        if (i == nframe)
+            return tb;
+    }
+
+    if (tracer.ntracebacks > tracer.tracebacks_mask) {
+        /* Double the number of buckets. */
+        size_t newsize = 2 * (tracer.tracebacks_mask + 1), j;
+        traceback_t **table = (traceback_t **)calloc(newsize,
+                                                     sizeof(traceback_t *));
+        if (table != NULL) {
+            for (j = 0; j <= tracer.tracebacks_mask; j++) {
+                traceback_t *next;
+                for (tb = tracer.tracebacks[j]; tb != NULL; tb = next) {
+                    next = tb->next;
+                    tb->next = table[(size_t)tb->hash & (newsize - 1)];
+                    table[(size_t)tb->hash & (newsize - 1)] = tb;
+                }
+            }
+            free(tracer.tracebacks);
+            tracer.tracebacks = table;
+            tracer.tracebacks_mask = newsize - 1;
+            bucket = &table[(size_t)hash & (newsize - 1)];
+        }
+    }
+
+    tb = (traceback_t *)malloc(TRACEBACK_SIZE(nframe));
+    if (tb == NULL)
+        return NULL;
+    tb->hash = hash;
+    tb->nframe = nframe;
+    for (i = 0; i < nframe; i++) {
+        tb->frames[i] = frames[i];
+        Py_INCREF(frames[i].filename);
+    }
+    tb->next = *bucket;
+    *bucket = tb;
+    tracer.ntracebacks++;
+    tracer.tracebacks_memory += TRACEBACK_SIZE(nframe);
+    return tb;
+}
+
+/* The traceback of the calling thread, or the empty traceback if it does
+   not hold the GIL. */
+static traceback_t *
+traceback_get(void)
+{
+    PyThreadState *tstate = _PyThreadState_Current;
+    frame_t frames[MAX_NFRAME];
+    PyFrameObject *f;
+    int n = 0;
+
+    if (tstate == NULL)
+        return &empty_traceback;
+#ifdef WITH_THREAD
+    if (tstate->thread_id != PyThread_get_thread_ident())
+        return &empty_traceback;
+#endif
+    for (f = tstate->frame; f != NULL && n < tracer.max_nframe;
+         f = f->f_back) {
+        frames[n].filename = f->f_code->co_filename;
+        frames[n].lineno = PyFrame_GetLineNumber(f);
+        n++;
+    }
+    if (n == 0)
+        return &empty_traceback;
+    return traceback_intern(frames, n);
+}
+
+/* --- the hooks ---------------------------------------------------------- */
+
+/* Count down to the next sampled allocation.  Threads that do not hold the
+   GIL race on the counter; that only moves the next sample a little. */
+static int
+sample_next(void)
+{
+    if (--tracer.countdown > 0)
+        return 0;
+    tracer.countdown = tracer.sample_rate;
+    return 1;
+}
+
+static void
+tracer_alloc(void *ptr, size_t size)
+{
+    traceback_t *tb;
+
+    if (!sample_next())
+        return;
+    tb = traceback_get();
+    if (tb == NULL)
+        return;
+    TABLES_LOCK();
+    if (tracer.tracing)
+        traces_add((Py_uintptr_t)ptr, size, tb);
+    TABLES_UNLOCK();
+}
+
+static void
+tracer_free(void *ptr)
+{
+    trace_t *t;
+
+    if (tracer.ntraces == 0)
+        return;
+    TABLES_LOCK();
+    if (tracer.tracing && (t = traces_lookup((Py_uintptr_t)ptr)) != NULL)
+        traces_remove(t);
+    TABLES_UNLOCK();
+}
+
+/* A resized block stays traced, with the traceback of the resize. */
+static void
+tracer_realloc(Py_uintptr_t oldaddr, void *ptr, size_t size)
+{
+    trace_t *t;
+    int traced = 0;
+    traceback_t *tb;
+
+    if (oldaddr != 0 && tracer.ntraces != 0) {
+        TABLES_LOCK();
+        if (tracer.tracing && (t = traces_lookup(oldaddr)) != NULL) {
+            traces_remove(t);
+            traced = 1;
+        }
+        TABLES_UNLOCK();
+    }
+    if (!traced && !sample_next())
+        return;
+    tb = traceback_get();
+    if (tb == NULL)
+        return;
+    TABLES_LOCK();
+    if (tracer.tracing)
+        traces_add((Py_uintptr_t)ptr, size, tb);
+    TABLES_UNLOCK();
+}
+
+static _PyMem_TracerHooks hooks = {tracer_alloc, tracer_realloc, tracer_free};
+
+/* --- starting and stopping ---------------------------------------------- */
+
+/* Empty both tables.  The tracebacks own references to their filenames;
+   they are released after the lock is dropped, since freeing a filename
+   comes back through tracer_free(). */
+static int
+tracer_clear(int reallocate)
+{
+    trace_t *traces = NULL;
+    traceback_t **tracebacks = tracer.tracebacks, *tb, *next;
+    size_t ntracebacks = tracer.tracebacks_mask + 1, i;
+    traceback_t **newtracebacks = NULL;
+    int j, err = 0;
+
+    if (reallocate) {
+        traces = (trace_t *)calloc(TRACES_MINSIZE, sizeof(trace_t));
+        newtracebacks = (traceback_t **)calloc(TRACES_MINSIZE,
+                                               sizeof(traceback_t *));
+        if (traces == NULL || newtracebacks == NULL) {
+            free(traces);
+            free(newtracebacks);
+            traces = NULL;
+            newtracebacks = NULL;
+            err = -1;
+        }
+    }
+
+    TABLES_LOCK();
+    free(tracer.traces);
+    tracer.traces = traces;
+    tracer.traces_mask = TRACES_MINSIZE - 1;
+    tracer.ntraces = 0;
+    tracer.traced_memory = 0;
+    tracer.peak_traced_memory = 0;
+    TABLES_UNLOCK();
+
+    tracer.tracebacks = newtracebacks;
+    tracer.tracebacks_mask = TRACES_MINSIZE - 1;
+    tracer.ntracebacks = 0;
+    tracer.tracebacks_memory = 0;
+
+    if (tracebacks != NULL) {
+        for (i = 0; i < ntracebacks; i++) {
+            for (tb = tracebacks[i]; tb != NULL; tb = next) {
+                next = tb->next;
+                for (j = 0; j < tb->nframe; j++)
+                    Py_DECREF(tb->frames[j].filename);
+                free(tb);
+            }
+        }
+        free(tracebacks);
+    }
+    return err;
+}
+
+static void
+tracer_stop(void)
+{
+    if (!tracer.tracing)
+        return;
+    _PyMem_Tracer = NULL;
+    TABLES_LOCK();
+    tracer.tracing = 0;
+    TABLES_UNLOCK();
+    tracer_clear(0);
+}
+
+#endif  /* Py_TRACEMALLOC */
+
+/* --- module functions --------------------------------------------------- */
+
+PyDoc_STRVAR(start_doc,
+"start(nframe=1, sample_rate=1)\n\
+\n\
+Start tracing Python memory allocations, storing at most nframe frames\n\
+per traceback and tracing one allocation in sample_rate.  If tracing is\n\
+already on, only change the two limits.");
+
+static PyObject *
+tracemalloc_start(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"nframe", "sample_rate", NULL};
+    int nframe = 1, sample_rate = 1;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ii:start", kwlist,
+                                     &nframe, &sample_rate))
+        return NULL;
+#if Py_TRACEMALLOC
+    if (nframe < 1 || nframe > MAX_NFRAME) {
+        PyErr_Format(PyExc_ValueError,
+                     "the number of frames must be in range [1; %d]",
+                     MAX_NFRAME);
+        return NULL;
+    }
+    if (sample_rate < 1) {
+        PyErr_SetString(PyExc_ValueError,
+                        "the sample rate must be at least 1");
+        return NULL;
+    }
+    tracer.max_nframe = nframe;
+    tracer.sample_rate = sample_rate;
+    tracer.countdown = 1;
+    if (tracer.tracing)
+        Py_RETURN_NONE;
+
+#ifdef WITH_THREAD
+    if (tables_lock == NULL) {
+        tables_lock = PyThread_allocate_lock();
+        if (tables_lock == NULL) {
+            PyErr_SetString(PyExc_RuntimeError, "cannot allocate lock");
+            return NULL;
+        }
+    }
+#endif
+    if (tracer_clear(1) < 0)
+        return PyErr_NoMemory();
+    tracer.tracing = 1;
+    _PyMem_Tracer = &hooks;
+    Py_RETURN_NONE;
+#else
+    PyErr_SetString(PyExc_RuntimeError,
+                    "Python was built without allocation tracing");
+    return NULL;
+#endif
+}
+
+PyDoc_STRVAR(stop_doc,
+"stop()\n\
+\n\
+Stop tracing Python memory allocations and clear the traces.");
+
+static PyObject *
+tracemalloc_stop(PyObject *self)
+{
+#if Py_TRACEMALLOC
+    tracer_stop();
+#endif
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(is_tracing_doc,
+"is_tracing() -> bool\n\
+\n\
+True if the tracemalloc module is tracing Python memory allocations.");
+
+static PyObject *
+tracemalloc_is_tracing(PyObject *self)
+{
+#if Py_TRACEMALLOC
+    return PyBool_FromLong(tracer.tracing);
+#else
+    Py_RETURN_FALSE;
+#endif
+}
+
+PyDoc_STRVAR(clear_traces_doc,
+"clear_traces()\n\
+\n\
+Forget the traces of the memory blocks allocated so far.");
+
+static PyObject *
+tracemalloc_clear_traces(PyObject *self)
+{
+#if Py_TRACEMALLOC
+    if (tracer.tracing && tracer_clear(1) < 0) {
+        /* Without tables nothing more gets traced; give up properly. */
+        tracer_stop();
+        return PyErr_NoMemory();
+    }
+#endif
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(get_traceback_limit_doc,
+"get_traceback_limit() -> int\n\
+\n\
+The maximum number of frames stored in the traceback of a trace.");
+
+static PyObject *
+tracemalloc_get_traceback_limit(PyObject *self)
+{
+#if Py_TRACEMALLOC
+    return PyInt_FromLong(tracer.max_nframe);
+#else
+    return PyInt_FromLong(1);
+#endif
+}
+
+PyDoc_STRVAR(get_sample_rate_doc,
+"get_sample_rate() -> int\n\
+\n\
+One allocation in this many is traced.");
+
+static PyObject *
+tracemalloc_get_sample_rate(PyObject *self)
+{
+#if Py_TRACEMALLOC
+    return PyInt_FromLong(tracer.sample_rate);
+#else
+    return PyInt_FromLong(1);
+#endif
+}
+
+PyDoc_STRVAR(get_traced_memory_doc,
+"get_traced_memory() -> (int, int)\n\
+\n\
+The current size and the peak size of the traced memory blocks, in bytes.");
+
+static PyObject *
+tracemalloc_get_traced_memory(PyObject *self)
+{
+    size_t size = 0, peak = 0;
+
+#if Py_TRACEMALLOC
+    if (tracer.tracing) {
+        TABLES_LOCK();
+        size = tracer.traced_memory;
+        peak = tracer.peak_traced_memory;
+        TABLES_UNLOCK();
+    }
+#endif
+    return Py_BuildValue("nn", (Py_ssize_t)size, (Py_ssize_t)peak);
+}
+
+PyDoc_STRVAR(get_tracemalloc_memory_doc,
+"get_tracemalloc_memory() -> int\n\
+\n\
+The memory used by the tracer itself to store the traces, in bytes.");
+
+static PyObject *
+tracemalloc_get_tracemalloc_memory(PyObject *self)
+{
+    size_t size = 0;
+
+#if Py_TRACEMALLOC
+    if (tracer.tracing) {
+        TABLES_LOCK();
+        size = (tracer.traces_mask + 1) * sizeof(trace_t);
+        TABLES_UNLOCK();
+        size += (tracer.tracebacks_mask + 1) * sizeof(traceback_t *);
+        size += tracer.tracebacks_memory;
+    }
+#endif
+    return PyInt_FromSsize_t((Py_ssize_t)size);
+}
+
+#if Py_TRACEMALLOC
+/* Convert a traceback to a tuple of (filename, lineno) tuples, most recent
+   call first.  cache maps the address of each traceback converted so far
+   to its tuple. */
+static PyObject *
+traceback_to_tuple(traceback_t *tb, PyObject *cache)
+{
+    PyObject *key, *result, *frame;
+    int i;
+
+    key = PyLong_FromVoidPtr(tb);
+    if (key == NULL)
+        return NULL;
+    result = PyDict_GetItem(cache, key);
+    if (result != NULL) {
+        Py_DECREF(key);
+        Py_INCREF(result);
+        return result;
+    }
+    result = PyTuple_New(tb->nframe);
+    if (result == NULL)
+        goto error;
+    for (i = 0; i < tb->nframe; i++) {
+        frame = Py_BuildValue("Oi", tb->frames[i].filename,
+                              tb->frames[i].lineno);
+        if (frame == NULL)
+            goto error;
+        PyTuple_SET_ITEM(result, i, frame);
+    }
+    if (PyDict_SetItem(cache, key, result) < 0)
+        goto error;
+    Py_DECREF(key);
+    return result;
+
+  error:
+    Py_DECREF(key);
+    Py_XDECREF(result);
+    return NULL;
+}
+#endif
+
+PyDoc_STRVAR(get_traces_doc,
+"_get_traces() -> list\n\
+\n\
+The traces of all the traced memory blocks, as (size, traceback) tuples;\n\
+a traceback is a tuple of (filename, lineno) tuples, most recent call\n\
+first.  Use tracemalloc.take_snapshot() instead.");
+
+static PyObject *
+tracemalloc_get_traces(PyObject *self)
+{
+    PyObject *list;
+
+    list = PyList_New(0);
+    if (list == NULL)
+        return NULL;
+#if Py_TRACEMALLOC
+    if (tracer.tracing) {
+        trace_t *copy;
+        size_t n = 0, i, size;
+        PyObject *cache = NULL, *tb, *item;
+
+        /* Copy the traces first:  building the result allocates, which
+           changes the table under our feet. */
+        TABLES_LOCK();
+        size = tracer.traces_mask + 1;
+        copy = (trace_t *)malloc(tracer.ntraces * sizeof(trace_t) + 1);
+        if (copy != NULL) {
+            for (i = 0; i < size; i++) {
+                if (tracer.traces[i].ptr != 0)
+                    copy[n++] = tracer.traces[i];
+            }
+        }
+        TABLES_UNLOCK();
+        if (copy == NULL) {
+            Py_DECREF(list);
+            return PyErr_NoMemory();
+        }
+
+        cache = PyDict_New();
+        if (cache == NULL)
+            goto error;
+        for (i = 0; i < n; i++) {
+            tb = traceback_to_tuple(copy[i].traceback, cache);
+            if (tb == NULL)
+                goto error;
+            item = Py_BuildValue("nN", (Py_ssize_t)copy[i].size, tb);
+            if (item == NULL)
+                goto error;
+            if (PyList_Append(list, item) < 0) {
+                Py_DECREF(item);
+                goto error;
+            }
+            Py_DECREF(item);
+        }
+        free(copy);
+        Py_DECREF(cache);
+        return list;
+
+      error:
+        free(copy);
+        Py_XDECREF(cache);
+        Py_DECREF(list);
+        return NULL;
+    }
+#endif
+    return list;
+}
+
+PyDoc_STRVAR(get_object_traceback_doc,
+"_get_object_traceback(obj) -> tuple or None\n\
+\n\
+The traceback where the memory block holding obj was allocated, as a\n\
+tuple of (filename, lineno) tuples, or None if it is not traced.");
+
+static PyObject *
+tracemalloc_get_object_traceback(PyObject *self, PyObject *obj)
+{
+#if Py_TRACEMALLOC
+    Py_uintptr_t ptr = (Py_uintptr_t)obj;
+    traceback_t *tb = NULL;
+    trace_t *t;
+    PyObject *cache, *result;
+
+    if (!tracer.tracing)
+        Py_RETURN_NONE;
+    /* A GC object's block starts with its GC header. */
+    if (PyType_IS_GC(Py_TYPE(obj)))
+        ptr -= sizeof(PyGC_Head);
+    TABLES_LOCK();
+    if ((t = traces_lookup(ptr)) != NULL)
+        tb = t->traceback;
+    TABLES_UNLOCK();
+    if (tb == NULL)
+        Py_RETURN_NONE;
+    cache = PyDict_New();
+    if (cache == NULL)
+        return NULL;
+    result = traceback_to_tuple(tb, cache);
+    Py_DECREF(cache);
+    return result;
+#else
+    Py_RETURN_NONE;
+#endif
+}
+
+static PyMethodDef tracemalloc_methods[] = {
+    {"start", (PyCFunction)tracemalloc_start,
+     METH_VARARGS | METH_KEYWORDS, start_doc},
+    {"stop", (PyCFunction)tracemalloc_stop, METH_NOARGS, stop_doc},
+    {"is_tracing", (PyCFunction)tracemalloc_is_tracing,
+     METH_NOARGS, is_tracing_doc},
+    {"clear_traces", (PyCFunction)tracemalloc_clear_traces,
+     METH_NOARGS, clear_traces_doc},
+    {"get_traceback_limit", (PyCFunction)tracemalloc_get_traceback_limit,
+     METH_NOARGS, get_traceback_limit_doc},
+    {"get_sample_rate", (PyCFunction)tracemalloc_get_sample_rate,
+     METH_NOARGS, get_sample_rate_doc},
+    {"get_traced_memory", (PyCFunction)tracemalloc_get_traced_memory,
+     METH_NOARGS, get_traced_memory_doc},
+    {"get_tracemalloc_memory",
+     (PyCFunction)tracemalloc_get_tracemalloc_memory,
+     METH_NOARGS, get_tracemalloc_memory_doc},
+    {"_get_traces", (PyCFunction)tracemalloc_get_traces,
+     METH_NOARGS, get_traces_doc},
+    {"_get_object_traceback", (PyCFunction)tracemalloc_get_object_traceback,
+     METH_O, get_object_traceback_doc},
+    {NULL, NULL}
+};
+
+PyMODINIT_FUNC
+init_tracemalloc(void)
+{
+    Py_InitModule3("_tracemalloc", tracemalloc_methods, module_doc);
+}
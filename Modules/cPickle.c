@@ -2211,6 +2211,7 @@ save_global(Picklerobject *self, PyObject *args, PyObject *name)
 
         PyTuple_SET_ITEM(two_tuple, 0, module);
         PyTuple_SET_ITEM(two_tuple, 1, global_name);
+        _PyTuple_FORGET_HASH(two_tuple);
         py_code = PyDict_GetItem(extension_registry, two_tuple);
         if (py_code == NULL)
             goto gen_global;                    /* not registered */
@@ -5828,7 +5829,8 @@ init_stuff(PyObject *module_dict)
 {
     PyObject *copyreg, *t, *r;
 
-#define INIT_STR(S) if (!( S ## _str=PyString_InternFromString(#S)))  return -1;
+#define INIT_STR(S) \
+    if (!( S ## _str=_PyString_InternImmortalFromString(#S)))  return -1;
 
     if (PyType_Ready(&Unpicklertype) < 0)
         return -1;
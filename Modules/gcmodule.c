@@ -19,6 +19,7 @@
 */
 
 #include "Python.h"
+#include "code.h"              /* for gc.freeze(immortal) */
 #include "frameobject.h"        /* for PyFrame_ClearFreeList */
 
 /* Get an object's GC head */
@@ -49,6 +50,11 @@ static struct gc_generation generations[NUM_GENERATIONS] = {
 
 PyGC_Head *_PyGC_generation0 = GEN_HEAD(0);
 
+/* objects moved here by gc.freeze(); never examined by collect() */
+static struct gc_generation permanent_generation = {
+    {{&permanent_generation.head, &permanent_generation.head, 0}}, 0, 0
+};
+
 static int enabled = 1; /* automatic collection enabled? */
 
 /* true if we are currently running the collector */
@@ -57,6 +63,11 @@ static int collecting = 0;
 /* list of uncollectable objects */
 static PyObject *garbage = NULL;
 
+/* Incremental collection of the oldest generation, see set_incremental().
+   0 means the oldest generation is only ever collected in full; otherwise
+   this is the number of old objects examined per increment. */
+static Py_ssize_t incremental_work = 0;
+
 /* Python string to use if unhandled exception occurs */
 static PyObject *gc_str = NULL;
 
@@ -112,6 +123,27 @@ static Py_ssize_t long_lived_pending = 0;
 */
 
 
+/* Collection statistics, see gc.get_stats().  Pauses are recorded in a
+   histogram of powers of two: pauses[0] counts the collections that took
+   less than a microsecond and pauses[i] the ones that took from 2**(i-1)
+   up to 2**i microseconds; the last bucket takes everything longer. */
+#define NUM_PAUSE_BUCKETS 24
+
+struct gc_stats {
+    Py_ssize_t collections;     /* number of collections */
+    Py_ssize_t collected;       /* unreachable objects found */
+    Py_ssize_t uncollectable;   /* of which uncollectable */
+    double pause_total;         /* seconds spent collecting */
+    double pause_max;           /* longest collection */
+    Py_ssize_t pauses[NUM_PAUSE_BUCKETS];
+};
+
+static struct gc_stats generation_stats[NUM_GENERATIONS];
+/* increments of the oldest generation, see collect_increment() */
+static struct gc_stats increment_stats;
+static Py_ssize_t increment_passes = 0; /* completed passes */
+static Py_ssize_t increment_examined = 0; /* old objects examined */
+
 /* set for debugging information */
 #define DEBUG_STATS             (1<<0) /* print collection statistics */
 #define DEBUG_COLLECTABLE       (1<<1) /* print collectable objects */
@@ -164,14 +196,44 @@ GC_TENTATIVELY_UNREACHABLE
     Only objects with GC_TENTATIVELY_UNREACHABLE still set are candidates
     for collection.  If it's decided not to collect such an object (e.g.,
     it has a __del__ method), its gc_refs is restored to GC_REACHABLE again.
+
+Objects outside the young generations can carry two more marks, which mean
+the same as GC_REACHABLE to everything but the incremental collector:
+
+GC_VISITED_0, GC_VISITED_1
+    The object survived an increment of the current (visited_mark) or of
+    the previous pass over the oldest generation, see collect_increment().
+    Flipping visited_mark at the end of a pass turns every visited object
+    back into a pending one without touching it.
+
+GC_FROZEN
+    The object lives in the permanent generation, see gc.freeze().
 ----------------------------------------------------------------------------
 */
 #define GC_UNTRACKED                    _PyGC_REFS_UNTRACKED
 #define GC_REACHABLE                    _PyGC_REFS_REACHABLE
 #define GC_TENTATIVELY_UNREACHABLE      _PyGC_REFS_TENTATIVELY_UNREACHABLE
+#define GC_VISITED_0                    (-5)
+#define GC_VISITED_1                    (-6)
+#define GC_FROZEN                       (-7)
+
+static Py_ssize_t visited_mark = GC_VISITED_0;
+
+/* true for all the gc_refs values of a tracked object between
+   collections */
+#define IS_REACHABLE_REFS(refs) ((refs) == GC_REACHABLE \
+                                 || (refs) == GC_VISITED_0 \
+                                 || (refs) == GC_VISITED_1 \
+                                 || (refs) == GC_FROZEN)
+/* true for objects in the oldest generation that the current pass of
+   the incremental collector has yet to examine */
+#define IS_PENDING_REFS(refs) ((refs) == GC_REACHABLE \
+                               || (((refs) == GC_VISITED_0 \
+                                    || (refs) == GC_VISITED_1) \
+                                   && (refs) != visited_mark))
 
 #define IS_TRACKED(o) ((AS_GC(o))->gc.gc_refs != GC_UNTRACKED)
-#define IS_REACHABLE(o) ((AS_GC(o))->gc.gc_refs == GC_REACHABLE)
+#define IS_REACHABLE(o) IS_REACHABLE_REFS((AS_GC(o))->gc.gc_refs)
 #define IS_TENTATIVELY_UNREACHABLE(o) ( \
     (AS_GC(o))->gc.gc_refs == GC_TENTATIVELY_UNREACHABLE)
 
@@ -288,7 +350,8 @@ update_refs(PyGC_Head *containers)
 {
     PyGC_Head *gc = containers->gc.gc_next;
     for (; gc != containers; gc = gc->gc.gc_next) {
-        assert(gc->gc.gc_refs == GC_REACHABLE);
+        assert(IS_REACHABLE_REFS(gc->gc.gc_refs)
+               && gc->gc.gc_refs != GC_FROZEN);
         gc->gc.gc_refs = Py_REFCNT(FROM_GC(gc));
         /* Python's cyclic gc should never see an incoming refcount
          * of 0:  if something decref'ed to 0, it should have been
@@ -379,12 +442,13 @@ visit_reachable(PyObject *op, PyGC_Head *reachable)
          * list, and move_unreachable will eventually get to it.
          * If gc_refs == GC_REACHABLE, it's either in some other
          * generation so we don't care about it, or move_unreachable
-         * already dealt with it.
+         * already dealt with it.  The same goes for the visited and
+         * frozen marks.
          * If gc_refs == GC_UNTRACKED, it must be ignored.
          */
          else {
             assert(gc_refs > 0
-                   || gc_refs == GC_REACHABLE
+                   || IS_REACHABLE_REFS(gc_refs)
                    || gc_refs == GC_UNTRACKED);
          }
     }
@@ -680,6 +744,7 @@ handle_weakrefs(PyGC_Head *unreachable, PyGC_Head *old)
         if (wrcb_to_call.gc.gc_next == gc) {
             /* object is still alive -- move it */
             gc_list_move(gc, old);
+            gc->gc.gc_refs = GC_REACHABLE;
         }
         else
             ++num_freed;
@@ -795,6 +860,51 @@ clear_freelists(void)
 #endif
     (void)PyInt_ClearFreeList();
     (void)PyFloat_ClearFreeList();
+    (void)PyDict_ClearFreeList();
+    (void)PySet_ClearFreeList();
+    (void)_PyMem_ClearTableCache();
+}
+
+#ifdef GETTIMEOFDAY_NO_TZ
+#define GETTIMEOFDAY(ptv) gettimeofday(ptv)
+#else
+#define GETTIMEOFDAY(ptv) gettimeofday(ptv, (struct timezone *)NULL)
+#endif
+
+/* Cheap clock for the pause statistics; unlike get_time() this doesn't
+   call into the time module. */
+static double
+gc_time(void)
+{
+#ifdef HAVE_GETTIMEOFDAY
+    struct timeval t;
+    GETTIMEOFDAY(&t);
+    return (double)t.tv_sec + t.tv_usec * 1e-6;
+#else
+    return 0.0;
+#endif
+}
+
+static void
+record_stats(struct gc_stats *stats, double pause,
+             Py_ssize_t collected, Py_ssize_t uncollectable)
+{
+    double usec = pause * 1e6;
+    int bucket = 0;
+
+    stats->collections++;
+    stats->collected += collected;
+    stats->uncollectable += uncollectable;
+    if (pause < 0.0)
+        pause = 0.0; /* the clock went backwards */
+    stats->pause_total += pause;
+    if (pause > stats->pause_max)
+        stats->pause_max = pause;
+    while (usec >= 1.0 && bucket < NUM_PAUSE_BUCKETS - 1) {
+        usec /= 2.0;
+        bucket++;
+    }
+    stats->pauses[bucket]++;
 }
 
 static double
@@ -815,10 +925,81 @@ get_time(void)
     return result;
 }
 
+/* State of the transitive closure computed by move_increment(). */
+struct increment_state {
+    PyGC_Head *increment;
+    Py_ssize_t work;            /* old objects moved so far */
+};
+
+/* A traversal callback for move_increment. */
+static int
+visit_increment(PyObject *op, struct increment_state *state)
+{
+    if (PyObject_IS_GC(op)) {
+        PyGC_Head *gc = AS_GC(op);
+        if (IS_PENDING_REFS(gc->gc.gc_refs)) {
+            gc_list_move(gc, state->increment);
+            gc->gc.gc_refs = Py_REFCNT(op);
+            assert(gc->gc.gc_refs != 0);
+            /* stop the traversal once the budget is spent */
+            if (++state->work >= incremental_work)
+                return 1;
+        }
+    }
+    return 0;
+}
+
+/* Add the next slice of the oldest generation to `increment`, whose
+ * objects have been through update_refs() already.  Objects are taken
+ * from the front of the oldest generation, each followed by the pending
+ * objects it reaches, until incremental_work objects have been moved; a
+ * garbage cycle is thus found as long as it fits into one increment.
+ * Objects that survive an increment go to the end of the oldest
+ * generation with the visited mark, so the pending objects are always
+ * at the front; once there are none left, the pass is over and flipping
+ * visited_mark starts the next one.
+ */
+static Py_ssize_t
+move_increment(PyGC_Head *increment)
+{
+    PyGC_Head *old = GEN_HEAD(NUM_GENERATIONS-1);
+    PyGC_Head *scan = increment->gc.gc_prev; /* last object traversed */
+    struct increment_state state;
+
+    if (!gc_list_is_empty(old)
+        && !IS_PENDING_REFS(old->gc.gc_next->gc.gc_refs)) {
+        visited_mark = (visited_mark == GC_VISITED_0 ? GC_VISITED_1
+                                                     : GC_VISITED_0);
+        increment_passes++;
+    }
+    state.increment = increment;
+    state.work = 0;
+    while (state.work < incremental_work) {
+        PyGC_Head *gc = scan->gc.gc_next;
+        if (gc == increment) {
+            /* the closure is complete, start from the next seed */
+            gc = old->gc.gc_next;
+            if (gc == old || !IS_PENDING_REFS(gc->gc.gc_refs))
+                break;
+            gc_list_move(gc, increment);
+            gc->gc.gc_refs = Py_REFCNT(FROM_GC(gc));
+            state.work++;
+        }
+        (void) Py_TYPE(FROM_GC(gc))->tp_traverse(FROM_GC(gc),
+                                               (visitproc)visit_increment,
+                                               &state);
+        scan = gc;
+    }
+    increment_examined += state.work;
+    return state.work;
+}
+
 /* This is the main function.  Read this to understand how the
- * collection process works. */
+ * collection process works.  With `incremental` set, the younger
+ * generations are collected together with a slice of the oldest one
+ * instead, see move_increment(). */
 static Py_ssize_t
-collect(int generation)
+collect(int generation, int incremental)
 {
     int i;
     Py_ssize_t m = 0; /* # objects collected */
@@ -827,8 +1008,15 @@ collect(int generation)
     PyGC_Head *old; /* next older generation */
     PyGC_Head unreachable; /* non-problematic unreachable trash */
     PyGC_Head finalizers;  /* objects with, & reachable from, __del__ */
+    PyGC_Head increment;   /* young objects and a slice of the old ones */
     PyGC_Head *gc;
+    Py_ssize_t slice = 0;
+    Py_ssize_t nyoung = 0;
     double t1 = 0.0;
+    double t0 = gc_time();
+
+    if (incremental)
+        generation = NUM_GENERATIONS - 2;
 
     if (delstr == NULL) {
         delstr = PyString_InternFromString("__del__");
@@ -837,8 +1025,13 @@ collect(int generation)
     }
 
     if (debug & DEBUG_STATS) {
-        PySys_WriteStderr("gc: collecting generation %d...\n",
-                          generation);
+        if (incremental)
+            PySys_WriteStderr("gc: collecting generation %d and an "
+                              "increment of generation %d...\n",
+                              generation, generation+1);
+        else
+            PySys_WriteStderr("gc: collecting generation %d...\n",
+                              generation);
         PySys_WriteStderr("gc: objects in each generation:");
         for (i = 0; i < NUM_GENERATIONS; i++)
             PySys_WriteStderr(" %" PY_FORMAT_SIZE_T "d",
@@ -871,6 +1064,13 @@ collect(int generation)
      * set are taken into account).
      */
     update_refs(young);
+    if (incremental) {
+        nyoung = gc_list_size(young);
+        gc_list_init(&increment);
+        gc_list_merge(young, &increment);
+        young = &increment;
+        slice = move_increment(young);
+    }
     subtract_refs(young);
 
     /* Leave everything reachable from outside young in young, and move
@@ -883,7 +1083,19 @@ collect(int generation)
     move_unreachable(young, &unreachable);
 
     /* Move reachable objects to next generation. */
-    if (young != old) {
+    if (incremental) {
+        Py_ssize_t survivors = 0;
+        for (gc = young->gc.gc_next; gc != young; gc = gc->gc.gc_next) {
+            gc->gc.gc_refs = visited_mark;
+            survivors++;
+        }
+        /* The survivors of the slice can't be told apart from the young
+           ones any more; count at most as many as there were young
+           objects towards the next full collection. */
+        long_lived_pending += survivors < nyoung ? survivors : nyoung;
+        gc_list_merge(young, old);
+    }
+    else if (young != old) {
         if (generation == NUM_GENERATIONS - 2) {
             long_lived_pending += gc_list_size(young);
         }
@@ -948,6 +1160,9 @@ collect(int generation)
                 "%" PY_FORMAT_SIZE_T "d unreachable, "
                 "%" PY_FORMAT_SIZE_T "d uncollectable",
                 n+m, n);
+        if (incremental)
+            PySys_WriteStderr(", %" PY_FORMAT_SIZE_T "d old objects "
+                              "examined", slice);
         if (t1 && t2) {
             PySys_WriteStderr(", %.4fs elapsed", t2-t1);
         }
@@ -965,6 +1180,16 @@ collect(int generation)
     if (generation == NUM_GENERATIONS-1) {
         clear_freelists();
     }
+    else {
+        /* Ints are not tracked, so freeing lots of them never triggers a
+         * full collection; give their blocks back at the next one. */
+        (void)_PyInt_ReclaimBlocks();
+    }
+
+    t0 = gc_time() - t0;
+    record_stats(&generation_stats[generation], t0, n+m, n);
+    if (incremental)
+        record_stats(&increment_stats, t0, n+m, n);
 
     if (PyErr_Occurred()) {
         if (gc_str == NULL)
@@ -988,12 +1213,14 @@ collect_generations(void)
         if (generations[i].count > generations[i].threshold) {
             /* Avoid quadratic performance degradation in number
                of tracked objects. See comments at the beginning
-               of this file, and issue #4074.
+               of this file, and issue #4074.  In incremental mode
+               this is what still collects the oldest generation in
+               full, for the garbage cycles too big for an increment.
             */
             if (i == NUM_GENERATIONS - 1
                 && long_lived_pending < long_lived_total / 4)
                 continue;
-            n = collect(i);
+            n = collect(i, i == NUM_GENERATIONS - 2 && incremental_work);
             break;
         }
     }
@@ -1064,7 +1291,7 @@ gc_collect(PyObject *self, PyObject *args, PyObject *kws)
         n = 0; /* already collecting, don't do anything */
     else {
         collecting = 1;
-        n = collect(genarg);
+        n = collect(genarg, 0);
         collecting = 0;
     }
 
@@ -1160,6 +1387,125 @@ gc_get_count(PyObject *self, PyObject *noargs)
                          generations[2].count);
 }
 
+PyDoc_STRVAR(gc_set_incremental__doc__,
+"set_incremental(work) -> None\n"
+"\n"
+"Collect the oldest generation incrementally, examining about work of its\n"
+"objects each time the younger generations are collected.  0 turns\n"
+"incremental collection off.\n");
+
+static PyObject *
+gc_set_incremental(PyObject *self, PyObject *args)
+{
+    Py_ssize_t work;
+
+    if (!PyArg_ParseTuple(args, "n:set_incremental", &work))
+        return NULL;
+    if (work < 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "work must be non-negative");
+        return NULL;
+    }
+    incremental_work = work;
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+PyDoc_STRVAR(gc_get_incremental__doc__,
+"get_incremental() -> work\n"
+"\n"
+"Return the number of old objects examined per increment (0 if the\n"
+"oldest generation is not collected incrementally).\n");
+
+static PyObject *
+gc_get_incremental(PyObject *self, PyObject *noargs)
+{
+    return PyInt_FromSsize_t(incremental_work);
+}
+
+static PyObject *
+stats_as_dict(struct gc_stats *stats)
+{
+    PyObject *pauses;
+    int i;
+
+    pauses = PyList_New(NUM_PAUSE_BUCKETS);
+    if (pauses == NULL)
+        return NULL;
+    for (i = 0; i < NUM_PAUSE_BUCKETS; i++) {
+        PyObject *v = PyInt_FromSsize_t(stats->pauses[i]);
+        if (v == NULL) {
+            Py_DECREF(pauses);
+            return NULL;
+        }
+        PyList_SET_ITEM(pauses, i, v);
+    }
+    return Py_BuildValue("{snsnsnsdsdsN}",
+                         "collections", stats->collections,
+                         "collected", stats->collected,
+                         "uncollectable", stats->uncollectable,
+                         "pause_total", stats->pause_total,
+                         "pause_max", stats->pause_max,
+                         "pause_histogram", pauses);
+}
+
+PyDoc_STRVAR(gc_get_stats__doc__,
+"get_stats([reset]) -> [dict, ...]\n"
+"\n"
+"Return a list of dictionaries with statistics for each generation.\n"
+"If reset is true, the statistics are cleared afterwards.\n");
+
+static PyObject *
+gc_get_stats(PyObject *self, PyObject *args)
+{
+    PyObject *result, *stats, *incr, *v;
+    int reset = 0;
+    int i;
+
+    if (!PyArg_ParseTuple(args, "|i:get_stats", &reset))
+        return NULL;
+    result = PyList_New(0);
+    if (result == NULL)
+        return NULL;
+    for (i = 0; i < NUM_GENERATIONS; i++) {
+        stats = stats_as_dict(&generation_stats[i]);
+        if (stats == NULL)
+            goto error;
+        if (PyList_Append(result, stats) < 0) {
+            Py_DECREF(stats);
+            goto error;
+        }
+        Py_DECREF(stats);
+    }
+    /* the increments go with the oldest generation */
+    incr = stats_as_dict(&increment_stats);
+    if (incr == NULL)
+        goto error;
+    v = Py_BuildValue("{snsn}",
+                      "passes", increment_passes,
+                      "examined", increment_examined);
+    if (v == NULL || PyDict_Update(incr, v) < 0 ||
+        PyDict_SetItemString(PyList_GET_ITEM(result, NUM_GENERATIONS-1),
+                             "incremental", incr) < 0) {
+        Py_XDECREF(v);
+        Py_DECREF(incr);
+        goto error;
+    }
+    Py_DECREF(v);
+    Py_DECREF(incr);
+    if (reset) {
+        memset(generation_stats, 0, sizeof(generation_stats));
+        memset(&increment_stats, 0, sizeof(increment_stats));
+        increment_passes = 0;
+        increment_examined = 0;
+    }
+    return result;
+
+  error:
+    Py_DECREF(result);
+    return NULL;
+}
+
 static int
 referrersvisit(PyObject* obj, PyObject *objs)
 {
@@ -1206,6 +1552,10 @@ gc_get_referrers(PyObject *self, PyObject *args)
             return NULL;
         }
     }
+    if (!(gc_referrers_for(args, &permanent_generation.head, result))) {
+        Py_DECREF(result);
+        return NULL;
+    }
     return result;
 }
 
@@ -1267,6 +1617,10 @@ gc_get_objects(PyObject *self, PyObject *noargs)
             return NULL;
         }
     }
+    if (append_objects(result, &permanent_generation.head)) {
+        Py_DECREF(result);
+        return NULL;
+    }
     return result;
 }
 
@@ -1290,6 +1644,159 @@ gc_is_tracked(PyObject *self, PyObject *obj)
     return result;
 }
 
+#if Py_IMMORTAL_OBJECTS
+/* Stack of objects made immortal whose referents are still to be
+   visited, see immortalize(). */
+struct immortal_stack {
+    PyObject **items;
+    Py_ssize_t len;
+    Py_ssize_t size;
+};
+
+static int
+visit_immortalize(PyObject *op, struct immortal_stack *st)
+{
+    if (op == NULL || _Py_IsImmortal(op))
+        return 0;
+    /* Frames come and go with the calls that are running now; what
+       their locals refer to stays mortal unless reachable otherwise. */
+    if (PyFrame_Check(op))
+        return 0;
+    if (st->len == st->size) {
+        Py_ssize_t size = st->size ? st->size * 2 : 1024;
+        PyObject **items = PyMem_RESIZE(st->items, PyObject *, size);
+        if (items == NULL)
+            return -1;
+        st->items = items;
+        st->size = size;
+    }
+    _Py_SetImmortal(op);
+    st->items[st->len++] = op;
+    return 0;
+}
+
+/* Make every object in the list immortal, along with everything it
+   refers to, directly or not.  Code objects have no tp_traverse, so
+   their constants and names are visited by hand. */
+static int
+immortalize(PyGC_Head *list)
+{
+    struct immortal_stack st = {NULL, 0, 0};
+    PyGC_Head *gc;
+    visitproc visit = (visitproc)visit_immortalize;
+    int err = 0;
+
+    for (gc = list->gc.gc_next; gc != list && !err; gc = gc->gc.gc_next)
+        err = visit(FROM_GC(gc), &st);
+    while (st.len > 0 && !err) {
+        PyObject *op = st.items[--st.len];
+        if (PyCode_Check(op)) {
+            PyCodeObject *co = (PyCodeObject *)op;
+            err = (visit(co->co_code, &st) ||
+                   visit(co->co_consts, &st) ||
+                   visit(co->co_names, &st) ||
+                   visit(co->co_varnames, &st) ||
+                   visit(co->co_freevars, &st) ||
+                   visit(co->co_cellvars, &st) ||
+                   visit(co->co_filename, &st) ||
+                   visit(co->co_name, &st) ||
+                   visit(co->co_lnotab, &st));
+        }
+        else if (PyObject_IS_GC(op))
+            err = Py_TYPE(op)->tp_traverse(op, visit, &st);
+    }
+    PyMem_FREE(st.items);
+    if (err) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    _PyString_ImmortalizeInterned();
+    return 0;
+}
+#endif
+
+PyDoc_STRVAR(gc_freeze__doc__,
+"freeze([immortal]) -> None\n"
+"\n"
+"Freeze all current tracked objects and ignore them for future collections.\n"
+"\n"
+"This can be used before a POSIX fork() call to make the gc copy-on-write\n"
+"friendly.  Note: collection before a POSIX fork() call may free pages for\n"
+"future allocation which can cause copy-on-write.\n"
+"\n"
+"If immortal is true, the frozen objects and everything they refer to also\n"
+"become immortal:  their reference counts are never written again and they\n"
+"are never deallocated.\n");
+
+static PyObject *
+gc_freeze(PyObject *self, PyObject *args)
+{
+    int i, immortal = 0;
+    PyGC_Head *gc;
+
+    if (!PyArg_ParseTuple(args, "|i:freeze", &immortal))
+        return NULL;
+#if Py_IMMORTAL_OBJECTS
+    if (immortal) {
+        for (i = 0; i < NUM_GENERATIONS; i++)
+            if (immortalize(GEN_HEAD(i)) < 0)
+                return NULL;
+    }
+#endif
+    for (i = 0; i < NUM_GENERATIONS; i++) {
+        /* mark them so the incremental collector leaves them alone */
+        for (gc = GEN_HEAD(i)->gc.gc_next; gc != GEN_HEAD(i);
+             gc = gc->gc.gc_next)
+            gc->gc.gc_refs = GC_FROZEN;
+        gc_list_merge(GEN_HEAD(i), &permanent_generation.head);
+        generations[i].count = 0;
+    }
+    /* The frozen objects no longer count towards the full collection
+       heuristic, see the comment above long_lived_pending. */
+    long_lived_total = 0;
+    long_lived_pending = 0;
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+PyDoc_STRVAR(gc_unfreeze__doc__,
+"unfreeze() -> None\n"
+"\n"
+"Unfreeze all objects in the permanent generation.\n"
+"\n"
+"Put all objects in the permanent generation back into the oldest\n"
+"generation.\n");
+
+static PyObject *
+gc_unfreeze(PyObject *self, PyObject *noargs)
+{
+    PyGC_Head *old = GEN_HEAD(NUM_GENERATIONS-1);
+    PyGC_Head *gc;
+
+    for (gc = permanent_generation.head.gc.gc_next;
+         gc != &permanent_generation.head; gc = gc->gc.gc_next) {
+        gc->gc.gc_refs = GC_REACHABLE;
+        long_lived_total++;
+    }
+    /* Put them in front of the oldest generation, where the incremental
+       collector expects the objects it has yet to examine. */
+    gc_list_merge(old, &permanent_generation.head);
+    gc_list_merge(&permanent_generation.head, old);
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+PyDoc_STRVAR(gc_get_freeze_count__doc__,
+"get_freeze_count() -> n\n"
+"\n"
+"Return the number of objects in the permanent generation.\n");
+
+static PyObject *
+gc_get_freeze_count(PyObject *self, PyObject *noargs)
+{
+    return PyInt_FromSsize_t(gc_list_size(&permanent_generation.head));
+}
+
 
 PyDoc_STRVAR(gc__doc__,
 "This module provides access to the garbage collector for reference cycles.\n"
@@ -1303,10 +1810,16 @@ PyDoc_STRVAR(gc__doc__,
 "get_debug() -- Get debugging flags.\n"
 "set_threshold() -- Set the collection thresholds.\n"
 "get_threshold() -- Return the current the collection thresholds.\n"
+"set_incremental() -- Collect the oldest generation in slices.\n"
+"get_incremental() -- Return the work done per slice (0 if disabled).\n"
+"get_stats() -- Return collection and pause time statistics.\n"
 "get_objects() -- Return a list of all objects tracked by the collector.\n"
 "is_tracked() -- Returns true if a given object is tracked.\n"
 "get_referrers() -- Return the list of objects that refer to an object.\n"
-"get_referents() -- Return the list of objects that an object refers to.\n");
+"get_referents() -- Return the list of objects that an object refers to.\n"
+"freeze() -- Freeze all tracked objects and ignore them for future collections.\n"
+"unfreeze() -- Unfreeze all objects in the permanent generation.\n"
+"get_freeze_count() -- Return the number of objects in the permanent generation.\n");
 
 static PyMethodDef GcMethods[] = {
     {"enable",             gc_enable,     METH_NOARGS,  gc_enable__doc__},
@@ -1317,6 +1830,11 @@ static PyMethodDef GcMethods[] = {
     {"get_count",          gc_get_count,  METH_NOARGS,  gc_get_count__doc__},
     {"set_threshold",  gc_set_thresh, METH_VARARGS, gc_set_thresh__doc__},
     {"get_threshold",  gc_get_thresh, METH_NOARGS,  gc_get_thresh__doc__},
+    {"set_incremental", gc_set_incremental, METH_VARARGS,
+        gc_set_incremental__doc__},
+    {"get_incremental", gc_get_incremental, METH_NOARGS,
+        gc_get_incremental__doc__},
+    {"get_stats",      gc_get_stats,  METH_VARARGS, gc_get_stats__doc__},
     {"collect",            (PyCFunction)gc_collect,
         METH_VARARGS | METH_KEYWORDS,           gc_collect__doc__},
     {"get_objects",    gc_get_objects,METH_NOARGS,  gc_get_objects__doc__},
@@ -1325,6 +1843,10 @@ static PyMethodDef GcMethods[] = {
         gc_get_referrers__doc__},
     {"get_referents",  gc_get_referents, METH_VARARGS,
         gc_get_referents__doc__},
+    {"freeze",         gc_freeze,     METH_VARARGS, gc_freeze__doc__},
+    {"unfreeze",       gc_unfreeze,   METH_NOARGS,  gc_unfreeze__doc__},
+    {"get_freeze_count", gc_get_freeze_count, METH_NOARGS,
+        gc_get_freeze_count__doc__},
     {NULL,      NULL}           /* Sentinel */
 };
 
@@ -1383,7 +1905,7 @@ PyGC_Collect(void)
         n = 0; /* already collecting, don't do anything */
     else {
         collecting = 1;
-        n = collect(NUM_GENERATIONS - 1);
+        n = collect(NUM_GENERATIONS - 1, 0);
         collecting = 0;
     }
 
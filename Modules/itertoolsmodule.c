@@ -1928,6 +1928,7 @@ product_next(productobject *lz)
         }
         /* Now, we've got the only copy so we can update it in-place */
         assert (npools==0 || Py_REFCNT(result) == 1);
+        _PyTuple_FORGET_HASH(result);
 
         /* Update the pool indices right-to-left.  Only advance to the
            next pool when the previous one rolls-over */
@@ -2159,6 +2160,7 @@ combinations_next(combinationsobject *co)
          * PyTuple's freelist.
          */
         assert(r == 0 || Py_REFCNT(result) == 1);
+        _PyTuple_FORGET_HASH(result);
 
         /* Scan indices right-to-left until finding one that is not
            at its maximum (i + n - r). */
@@ -2406,6 +2408,7 @@ cwr_next(cwrobject *co)
         /* Now, we've got the only copy so we can update it in-place CPython's
            empty tuple is a singleton and cached in PyTuple's freelist. */
         assert(r == 0 || Py_REFCNT(result) == 1);
+        _PyTuple_FORGET_HASH(result);
 
     /* Scan indices right-to-left until finding one that is not
      * at its maximum (n-1). */
@@ -2668,6 +2671,7 @@ permutations_next(permutationsobject *po)
         }
         /* Now, we've got the only copy so we can update it in-place */
         assert(r == 0 || Py_REFCNT(result) == 1);
+        _PyTuple_FORGET_HASH(result);
 
         /* Decrement rightmost cycle, moving leftward upon zero rollover */
         for (i=r-1 ; i>=0 ; i--) {
@@ -3552,6 +3556,7 @@ izip_next(izipobject *lz)
         return NULL;
     if (Py_REFCNT(result) == 1) {
         Py_INCREF(result);
+        _PyTuple_FORGET_HASH(result);
         for (i=0 ; i < tuplesize ; i++) {
             it = PyTuple_GET_ITEM(lz->ittuple, i);
             item = (*Py_TYPE(it)->tp_iternext)(it);
@@ -3897,6 +3902,7 @@ izip_longest_next(iziplongestobject *lz)
         return NULL;
     if (Py_REFCNT(result) == 1) {
         Py_INCREF(result);
+        _PyTuple_FORGET_HASH(result);
         for (i=0 ; i < tuplesize ; i++) {
             it = PyTuple_GET_ITEM(lz->ittuple, i);
             if (it == NULL) {
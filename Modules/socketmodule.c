@@ -2469,9 +2469,11 @@ the remote end is closed and all data is read, return the empty string.");
 /* s.recv_into(buffer, [nbytes [,flags]]) method */
 
 static PyObject*
-sock_recv_into(PySocketSockObject *s, PyObject *args, PyObject *kwds)
+sock_recv_into(PySocketSockObject *s, PyObject **args, Py_ssize_t nargs,
+               PyObject *kwnames)
 {
-    static char *kwlist[] = {"buffer", "nbytes", "flags", 0};
+    static const char * const kwlist[] = {"buffer", "nbytes", "flags", 0};
+    static _PyArg_Parser _parser = {"w*|ii:recv_into", kwlist, 0};
 
     int recvlen = 0, flags = 0;
     ssize_t readlen;
@@ -2479,8 +2481,8 @@ sock_recv_into(PySocketSockObject *s, PyObject *args, PyObject *kwds)
     Py_ssize_t buflen;
 
     /* Get the buffer's memory */
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "w*|ii:recv_into", kwlist,
-                                     &buf, &recvlen, &flags))
+    if (!_PyArg_ParseStackAndKeywords(args, nargs, kwnames, &_parser,
+                                      &buf, &recvlen, &flags))
         return NULL;
     buflen = buf.len;
     assert(buf.buf != 0 && buflen > 0);
@@ -2649,9 +2651,11 @@ Like recv(buffersize, flags) but also return the sender's address info.");
 /* s.recvfrom_into(buffer[, nbytes [,flags]]) method */
 
 static PyObject *
-sock_recvfrom_into(PySocketSockObject *s, PyObject *args, PyObject* kwds)
+sock_recvfrom_into(PySocketSockObject *s, PyObject **args, Py_ssize_t nargs,
+                   PyObject *kwnames)
 {
-    static char *kwlist[] = {"buffer", "nbytes", "flags", 0};
+    static const char * const kwlist[] = {"buffer", "nbytes", "flags", 0};
+    static _PyArg_Parser _parser = {"w*|ii:recvfrom_into", kwlist, 0};
 
     int recvlen = 0, flags = 0;
     ssize_t readlen;
@@ -2660,9 +2664,8 @@ sock_recvfrom_into(PySocketSockObject *s, PyObject *args, PyObject* kwds)
 
     PyObject *addr = NULL;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "w*|ii:recvfrom_into",
-                                     kwlist, &buf,
-                                     &recvlen, &flags))
+    if (!_PyArg_ParseStackAndKeywords(args, nargs, kwnames, &_parser,
+                                      &buf, &recvlen, &flags))
         return NULL;
     buflen = buf.len;
     assert(buf.buf != 0 && buflen > 0);
@@ -2996,11 +2999,11 @@ static PyMethodDef sock_methods[] = {
 #endif
     {"recv",              (PyCFunction)sock_recv, METH_VARARGS,
                       recv_doc},
-    {"recv_into",         (PyCFunction)sock_recv_into, METH_VARARGS | METH_KEYWORDS,
+    {"recv_into",         (PyCFunction)sock_recv_into, METH_FASTCALL,
                       recv_into_doc},
     {"recvfrom",          (PyCFunction)sock_recvfrom, METH_VARARGS,
                       recvfrom_doc},
-    {"recvfrom_into",  (PyCFunction)sock_recvfrom_into, METH_VARARGS | METH_KEYWORDS,
+    {"recvfrom_into",  (PyCFunction)sock_recvfrom_into, METH_FASTCALL,
                       recvfrom_into_doc},
     {"send",              (PyCFunction)sock_send, METH_VARARGS,
                       send_doc},
@@ -3097,11 +3100,11 @@ sock_initobj(PyObject *self, PyObject *args, PyObject *kwds)
     PySocketSockObject *s = (PySocketSockObject *)self;
     SOCKET_T fd;
     int family = AF_INET, type = SOCK_STREAM, proto = 0;
-    static char *keywords[] = {"family", "type", "proto", 0};
+    static const char * const keywords[] = {"family", "type", "proto", 0};
+    static _PyArg_Parser _parser = {"|iii:socket", keywords, 0};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds,
-                                     "|iii:socket", keywords,
-                                     &family, &type, &proto))
+    if (!_PyArg_ParseTupleAndKeywordsFast(args, kwds, &_parser,
+                                          &family, &type, &proto))
         return -1;
 
     Py_BEGIN_ALLOW_THREADS
@@ -40,30 +40,133 @@ lock_dealloc(lockobject *self)
     PyObject_Del(self);
 }
 
+#ifdef GETTIMEOFDAY_NO_TZ
+#define GETTIMEOFDAY(ptv) gettimeofday(ptv)
+#else
+#define GETTIMEOFDAY(ptv) gettimeofday(ptv, (struct timezone *)NULL)
+#endif
+
+/* Acquire lock, waiting up to microseconds (forever if negative).  The
+   first attempt doesn't wait and is made without releasing the GIL, so an
+   uncontended acquire costs no thread switch.  A signal interrupts the
+   wait to run the Python signal handlers; if one of them raises, return
+   PY_LOCK_INTR with the exception set, otherwise wait for the time left. */
+static PyLockStatus
+acquire_timed(PyThread_type_lock lock, PY_TIMEOUT_T microseconds)
+{
+    PyLockStatus r;
+#ifdef HAVE_GETTIMEOFDAY
+    struct timeval now;
+    double deadline = 0.0;
+
+    if (microseconds > 0) {
+        GETTIMEOFDAY(&now);
+        deadline = now.tv_sec * 1e6 + now.tv_usec + microseconds;
+    }
+#endif
+
+    r = PyThread_acquire_lock_timed(lock, 0, 0);
+    while (r == PY_LOCK_FAILURE && microseconds != 0) {
+        Py_BEGIN_ALLOW_THREADS
+        r = PyThread_acquire_lock_timed(lock, microseconds, 1);
+        Py_END_ALLOW_THREADS
+        if (r != PY_LOCK_INTR)
+            break;
+        if (Py_MakePendingCalls() < 0)
+            break;
+#ifdef HAVE_GETTIMEOFDAY
+        /* the handlers may have taken a while too */
+        if (microseconds > 0) {
+            GETTIMEOFDAY(&now);
+            microseconds = (PY_TIMEOUT_T)(deadline - now.tv_sec * 1e6
+                                          - now.tv_usec);
+            if (microseconds <= 0)
+                microseconds = 0;
+        }
+#endif
+        r = PyThread_acquire_lock_timed(lock, 0, 0);
+    }
+    return r;
+}
+
+/* Acquire lock, waiting for as long as it takes; for taking a lock back
+   in wait(), which must not give up. */
+static void
+acquire_uninterrupted(PyThread_type_lock lock)
+{
+    if (!PyThread_acquire_lock(lock, 0)) {
+        Py_BEGIN_ALLOW_THREADS
+        PyThread_acquire_lock(lock, 1);
+        Py_END_ALLOW_THREADS
+    }
+}
+
+static int
+lock_acquire_parse_args(PyObject **args, Py_ssize_t nargs,
+                        PyObject *kwnames, PY_TIMEOUT_T *timeout)
+{
+    static const char * const kwlist[] = {"blocking", "timeout", 0};
+    static _PyArg_Parser _parser = {"|id:acquire", kwlist, 0};
+    int blocking = 1;
+    double timeout_obj = -1;
+
+    *timeout = -1;
+    if (nargs == 0 && kwnames == NULL)
+        return 0;
+    if (!_PyArg_ParseStackAndKeywords(args, nargs, kwnames, &_parser,
+                                      &blocking, &timeout_obj))
+        return -1;
+
+    if (!blocking && timeout_obj != -1) {
+        PyErr_SetString(PyExc_ValueError, "can't specify a timeout "
+                        "for a non-blocking call");
+        return -1;
+    }
+    if (timeout_obj < 0 && timeout_obj != -1) {
+        PyErr_SetString(PyExc_ValueError, "timeout value must be "
+                        "strictly positive");
+        return -1;
+    }
+    if (!blocking)
+        *timeout = 0;
+    else if (timeout_obj != -1) {
+        double f = timeout_obj * 1e6;
+        if (f >= (double) PY_TIMEOUT_MAX) {
+            PyErr_SetString(PyExc_OverflowError,
+                            "timeout value is too large");
+            return -1;
+        }
+        *timeout = (PY_TIMEOUT_T) f;
+    }
+    return 0;
+}
+
 static PyObject *
-lock_PyThread_acquire_lock(lockobject *self, PyObject *args)
+lock_PyThread_acquire_lock(lockobject *self, PyObject **args,
+                           Py_ssize_t nargs, PyObject *kwnames)
 {
-    int i = 1;
+    PY_TIMEOUT_T timeout;
+    PyLockStatus r;
 
-    if (!PyArg_ParseTuple(args, "|i:acquire", &i))
+    if (lock_acquire_parse_args(args, nargs, kwnames, &timeout) < 0)
         return NULL;
 
-    Py_BEGIN_ALLOW_THREADS
-    i = PyThread_acquire_lock(self->lock_lock, i);
-    Py_END_ALLOW_THREADS
-
-    return PyBool_FromLong((long)i);
+    r = acquire_timed(self->lock_lock, timeout);
+    if (r == PY_LOCK_INTR)
+        return NULL;
+    return PyBool_FromLong(r == PY_LOCK_ACQUIRED);
 }
 
 PyDoc_STRVAR(acquire_doc,
-"acquire([wait]) -> None or bool\n\
+"acquire([wait[, timeout]]) -> bool\n\
 (acquire_lock() is an obsolete synonym)\n\
 \n\
 Lock the lock.  Without argument, this blocks if the lock is already\n\
 locked (even by the same thread), waiting for another thread to release\n\
-the lock, and return None once the lock is acquired.\n\
+the lock, and return True once the lock is acquired.\n\
 With an argument, this will only block if the argument is true,\n\
 and the return value reflects whether the lock is acquired.\n\
+With a positive timeout, it blocks for at most timeout seconds.\n\
 The blocking operation is not interruptible.");
 
 static PyObject *
@@ -107,9 +210,9 @@ Return whether the lock is in the locked state.");
 
 static PyMethodDef lock_methods[] = {
     {"acquire_lock", (PyCFunction)lock_PyThread_acquire_lock,
-     METH_VARARGS, acquire_doc},
+     METH_FASTCALL, acquire_doc},
     {"acquire",      (PyCFunction)lock_PyThread_acquire_lock,
-     METH_VARARGS, acquire_doc},
+     METH_FASTCALL, acquire_doc},
     {"release_lock", (PyCFunction)lock_PyThread_release_lock,
      METH_NOARGS, release_doc},
     {"release",      (PyCFunction)lock_PyThread_release_lock,
@@ -119,7 +222,7 @@ static PyMethodDef lock_methods[] = {
     {"locked",       (PyCFunction)lock_locked_lock,
      METH_NOARGS, locked_doc},
     {"__enter__",    (PyCFunction)lock_PyThread_acquire_lock,
-     METH_VARARGS, acquire_doc},
+     METH_FASTCALL, acquire_doc},
     {"__exit__",    (PyCFunction)lock_PyThread_release_lock,
      METH_VARARGS, release_doc},
     {NULL}              /* sentinel */
@@ -174,6 +277,815 @@ newlockobject(void)
     return self;
 }
 
+/* Recursive lock objects */
+
+typedef struct {
+    PyObject_HEAD
+    PyThread_type_lock rlock_lock;
+    long rlock_owner;
+    unsigned long rlock_count;
+    PyObject *in_weakreflist;
+} rlockobject;
+
+static void
+rlock_dealloc(rlockobject *self)
+{
+    if (self->in_weakreflist != NULL)
+        PyObject_ClearWeakRefs((PyObject *) self);
+    /* self->rlock_lock can be NULL if PyThread_allocate_lock() failed
+       in rlock_new() */
+    if (self->rlock_lock != NULL) {
+        /* Unlock the lock so it's safe to free it */
+        if (self->rlock_count > 0)
+            PyThread_release_lock(self->rlock_lock);
+
+        PyThread_free_lock(self->rlock_lock);
+    }
+    Py_TYPE(self)->tp_free(self);
+}
+
+static PyObject *
+rlock_acquire(rlockobject *self, PyObject **args, Py_ssize_t nargs,
+              PyObject *kwnames)
+{
+    PY_TIMEOUT_T timeout;
+    long tid;
+    PyLockStatus r = PY_LOCK_ACQUIRED;
+
+    if (lock_acquire_parse_args(args, nargs, kwnames, &timeout) < 0)
+        return NULL;
+
+    tid = PyThread_get_thread_ident();
+    if (self->rlock_count > 0 && tid == self->rlock_owner) {
+        unsigned long count = self->rlock_count + 1;
+        if (count <= self->rlock_count) {
+            PyErr_SetString(PyExc_OverflowError,
+                            "Internal lock count overflowed");
+            return NULL;
+        }
+        self->rlock_count = count;
+        Py_RETURN_TRUE;
+    }
+
+    if (self->rlock_count > 0 ||
+        !PyThread_acquire_lock(self->rlock_lock, 0)) {
+        if (timeout == 0) {
+            Py_RETURN_FALSE;
+        }
+        r = acquire_timed(self->rlock_lock, timeout);
+        if (r == PY_LOCK_INTR)
+            return NULL;
+    }
+
+    if (r == PY_LOCK_ACQUIRED) {
+        assert(self->rlock_count == 0);
+        self->rlock_owner = tid;
+        self->rlock_count = 1;
+    }
+
+    return PyBool_FromLong(r == PY_LOCK_ACQUIRED);
+}
+
+PyDoc_STRVAR(rlock_acquire_doc,
+"acquire([blocking[, timeout]]) -> bool\n\
+\n\
+Lock the lock.  `blocking` indicates whether we should wait\n\
+for the lock to be available or not.  If `blocking` is False\n\
+and another thread holds the lock, the method will return False\n\
+immediately.  If `blocking` is True and another thread holds\n\
+the lock, the method will wait for the lock to be released,\n\
+take it and then return True.\n\
+(note: the blocking operation is not interruptible.)\n\
+\n\
+In all other cases, the method will return True immediately.\n\
+Precisely, if the current thread already holds the lock, its\n\
+internal counter is simply incremented. If nobody holds the lock,\n\
+the lock is taken and its internal counter initialized to 1.");
+
+static PyObject *
+rlock_release(rlockobject *self)
+{
+    long tid = PyThread_get_thread_ident();
+
+    if (self->rlock_count == 0 || self->rlock_owner != tid) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "cannot release un-acquired lock");
+        return NULL;
+    }
+    if (--self->rlock_count == 0) {
+        self->rlock_owner = 0;
+        PyThread_release_lock(self->rlock_lock);
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(rlock_release_doc,
+"release()\n\
+\n\
+Release the lock, allowing another thread that is blocked waiting for\n\
+the lock to acquire the lock.  The lock must be in the locked state,\n\
+and must be locked by the same thread that unlocks it; otherwise a\n\
+`RuntimeError` is raised.\n\
+\n\
+Do note that if the lock was acquire()d several times in a row by the\n\
+current thread, release() needs to be called as many times for the lock\n\
+to be available for other threads.");
+
+static int
+rlock_restore(rlockobject *self, unsigned long count, long owner)
+{
+    acquire_uninterrupted(self->rlock_lock);
+    assert(self->rlock_count == 0);
+    self->rlock_owner = owner;
+    self->rlock_count = count;
+    return 0;
+}
+
+static PyObject *
+rlock_acquire_restore(rlockobject *self, PyObject *args)
+{
+    unsigned long count;
+    long owner;
+
+    if (!PyArg_ParseTuple(args, "(kl):_acquire_restore", &count, &owner))
+        return NULL;
+    if (rlock_restore(self, count, owner) < 0)
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(rlock_acquire_restore_doc,
+"_acquire_restore(state) -> None\n\
+\n\
+For internal use by `threading.Condition`.");
+
+static PyObject *
+rlock_release_save(rlockobject *self)
+{
+    long owner;
+    unsigned long count;
+
+    if (self->rlock_count == 0) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "cannot release un-acquired lock");
+        return NULL;
+    }
+
+    owner = self->rlock_owner;
+    count = self->rlock_count;
+    self->rlock_count = 0;
+    self->rlock_owner = 0;
+    PyThread_release_lock(self->rlock_lock);
+    return Py_BuildValue("kl", count, owner);
+}
+
+PyDoc_STRVAR(rlock_release_save_doc,
+"_release_save() -> tuple\n\
+\n\
+For internal use by `threading.Condition`.");
+
+static PyObject *
+rlock_is_owned(rlockobject *self)
+{
+    long tid = PyThread_get_thread_ident();
+
+    if (self->rlock_count > 0 && self->rlock_owner == tid) {
+        Py_RETURN_TRUE;
+    }
+    Py_RETURN_FALSE;
+}
+
+PyDoc_STRVAR(rlock_is_owned_doc,
+"_is_owned() -> bool\n\
+\n\
+For internal use by `threading.Condition`.");
+
+static PyObject *
+rlock_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    rlockobject *self;
+
+    self = (rlockobject *) type->tp_alloc(type, 0);
+    if (self != NULL) {
+        self->in_weakreflist = NULL;
+        self->rlock_owner = 0;
+        self->rlock_count = 0;
+
+        self->rlock_lock = PyThread_allocate_lock();
+        if (self->rlock_lock == NULL) {
+            Py_DECREF(self);
+            PyErr_SetString(ThreadError, "can't allocate lock");
+            return NULL;
+        }
+    }
+
+    return (PyObject *) self;
+}
+
+static PyObject *
+rlock_repr(rlockobject *self)
+{
+    return PyString_FromFormat("<%s owner=%ld count=%lu>",
+        Py_TYPE(self)->tp_name, self->rlock_owner, self->rlock_count);
+}
+
+
+static PyMethodDef rlock_methods[] = {
+    {"acquire",      (PyCFunction)rlock_acquire,
+     METH_FASTCALL, rlock_acquire_doc},
+    {"release",      (PyCFunction)rlock_release,
+     METH_NOARGS, rlock_release_doc},
+    {"_is_owned",     (PyCFunction)rlock_is_owned,
+     METH_NOARGS, rlock_is_owned_doc},
+    {"_acquire_restore", (PyCFunction)rlock_acquire_restore,
+     METH_VARARGS, rlock_acquire_restore_doc},
+    {"_release_save", (PyCFunction)rlock_release_save,
+     METH_NOARGS, rlock_release_save_doc},
+    {"__enter__",    (PyCFunction)rlock_acquire,
+     METH_FASTCALL, rlock_acquire_doc},
+    {"__exit__",    (PyCFunction)rlock_release,
+     METH_VARARGS, rlock_release_doc},
+    {NULL,           NULL}              /* sentinel */
+};
+
+
+static PyTypeObject RLocktype = {
+    PyVarObject_HEAD_INIT(&PyType_Type, 0)
+    "thread.RLock",                     /*tp_name*/
+    sizeof(rlockobject),                /*tp_size*/
+    0,                                  /*tp_itemsize*/
+    /* methods */
+    (destructor)rlock_dealloc,          /*tp_dealloc*/
+    0,                                  /*tp_print*/
+    0,                                  /*tp_getattr*/
+    0,                                  /*tp_setattr*/
+    0,                                  /*tp_compare*/
+    (reprfunc)rlock_repr,               /*tp_repr*/
+    0,                                  /* tp_as_number */
+    0,                                  /* tp_as_sequence */
+    0,                                  /* tp_as_mapping */
+    0,                                  /* tp_hash */
+    0,                                  /* tp_call */
+    0,                                  /* tp_str */
+    0,                                  /* tp_getattro */
+    0,                                  /* tp_setattro */
+    0,                                  /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE, /* tp_flags */
+    0,                                  /* tp_doc */
+    0,                                  /* tp_traverse */
+    0,                                  /* tp_clear */
+    0,                                  /* tp_richcompare */
+    offsetof(rlockobject, in_weakreflist), /* tp_weaklistoffset */
+    0,                                  /* tp_iter */
+    0,                                  /* tp_iternext */
+    rlock_methods,                      /* tp_methods */
+    0,                                  /* tp_members */
+    0,                                  /* tp_getset */
+    0,                                  /* tp_base */
+    0,                                  /* tp_dict */
+    0,                                  /* tp_descr_get */
+    0,                                  /* tp_descr_set */
+    0,                                  /* tp_dictoffset */
+    0,                                  /* tp_init */
+    PyType_GenericAlloc,                /* tp_alloc */
+    rlock_new                           /* tp_new */
+};
+
+/* Condition variables
+
+   The same algorithm as threading._Condition: every waiting thread
+   allocates a lock, acquires it, appends it to the waiters list and then
+   blocks acquiring it a second time; notify() releases the first n locks
+   of the list.  When the condition is bound to a thread.lock or a
+   thread.RLock (cond_kind COND_LOCK or COND_RLOCK) the lock is operated on
+   directly, any other lock object through its acquire(), release() and,
+   when it has them, _is_owned(), _release_save() and _acquire_restore()
+   methods.
+*/
+
+enum { COND_OTHER, COND_LOCK, COND_RLOCK };
+
+typedef struct {
+    PyObject_HEAD
+    PyObject *cond_lock;
+    int cond_kind;
+    PyObject *cond_acquire;             /* cond_lock.acquire */
+    PyObject *cond_release;             /* cond_lock.release */
+    /* Bound methods of the lock or NULL, only used for COND_OTHER */
+    PyObject *cond_is_owned;
+    PyObject *cond_release_save;
+    PyObject *cond_acquire_restore;
+    PyObject *cond_waiters;             /* list of locks; NULL until the
+                                           condition is initialized */
+    PyObject *in_weakreflist;
+} condobject;
+
+static int
+cond_traverse(condobject *self, visitproc visit, void *arg)
+{
+    Py_VISIT(self->cond_lock);
+    Py_VISIT(self->cond_acquire);
+    Py_VISIT(self->cond_release);
+    Py_VISIT(self->cond_is_owned);
+    Py_VISIT(self->cond_release_save);
+    Py_VISIT(self->cond_acquire_restore);
+    Py_VISIT(self->cond_waiters);
+    return 0;
+}
+
+static int
+cond_clear(condobject *self)
+{
+    Py_CLEAR(self->cond_waiters);
+    Py_CLEAR(self->cond_lock);
+    Py_CLEAR(self->cond_acquire);
+    Py_CLEAR(self->cond_release);
+    Py_CLEAR(self->cond_is_owned);
+    Py_CLEAR(self->cond_release_save);
+    Py_CLEAR(self->cond_acquire_restore);
+    self->cond_kind = COND_OTHER;
+    return 0;
+}
+
+static void
+cond_dealloc(condobject *self)
+{
+    PyObject_GC_UnTrack(self);
+    if (self->in_weakreflist != NULL)
+        PyObject_ClearWeakRefs((PyObject *) self);
+    cond_clear(self);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+/* Return a new reference to lock.name, or NULL without an exception set
+   if the lock has no such attribute. */
+static PyObject *
+cond_lock_method(PyObject *lock, const char *name)
+{
+    PyObject *meth = PyObject_GetAttrString(lock, name);
+    if (meth == NULL && PyErr_ExceptionMatches(PyExc_AttributeError))
+        PyErr_Clear();
+    return meth;
+}
+
+static int
+cond_init(condobject *self, PyObject *args, PyObject *kwds)
+{
+    static const char * const kwlist[] = {"lock", 0};
+    static _PyArg_Parser _parser = {"|O:Condition", kwlist, 0};
+    PyObject *lock = Py_None;
+
+    if (!_PyArg_ParseTupleAndKeywordsFast(args, kwds, &_parser, &lock))
+        return -1;
+    if (lock == Py_None)
+        lock = rlock_new(&RLocktype, NULL, NULL);
+    else
+        Py_INCREF(lock);
+    if (lock == NULL)
+        return -1;
+
+    /* __init__() is called again on the conditions of threading.Thread
+       after a fork */
+    cond_clear(self);
+    self->cond_lock = lock;
+    if (Py_TYPE(lock) == &Locktype)
+        self->cond_kind = COND_LOCK;
+    else if (Py_TYPE(lock) == &RLocktype)
+        self->cond_kind = COND_RLOCK;
+    else {
+        self->cond_is_owned = cond_lock_method(lock, "_is_owned");
+        self->cond_release_save = cond_lock_method(lock, "_release_save");
+        self->cond_acquire_restore = cond_lock_method(lock,
+                                                      "_acquire_restore");
+        if (PyErr_Occurred())
+            return -1;
+    }
+    self->cond_acquire = PyObject_GetAttrString(lock, "acquire");
+    if (self->cond_acquire == NULL)
+        return -1;
+    self->cond_release = PyObject_GetAttrString(lock, "release");
+    if (self->cond_release == NULL)
+        return -1;
+    self->cond_waiters = PyList_New(0);
+    if (self->cond_waiters == NULL)
+        return -1;
+    return 0;
+}
+
+static int
+cond_check(condobject *self)
+{
+    if (self->cond_waiters == NULL) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "Condition object is not initialized");
+        return -1;
+    }
+    return 0;
+}
+
+/* Return 1 if the current thread holds the lock (a thread.lock is taken
+   to be held by whoever locked it), 0 if not and -1 on error. */
+static int
+cond_is_owned(condobject *self)
+{
+    PyObject *r;
+    int acquired;
+
+    if (self->cond_kind == COND_LOCK) {
+        PyThread_type_lock lock = ((lockobject *)self->cond_lock)->lock_lock;
+        if (!PyThread_acquire_lock(lock, 0))
+            return 1;
+        PyThread_release_lock(lock);
+        return 0;
+    }
+    if (self->cond_kind == COND_RLOCK) {
+        rlockobject *rlock = (rlockobject *)self->cond_lock;
+        return rlock->rlock_count > 0 &&
+            rlock->rlock_owner == PyThread_get_thread_ident();
+    }
+    if (self->cond_is_owned != NULL) {
+        r = PyObject_CallObject(self->cond_is_owned, NULL);
+        if (r == NULL)
+            return -1;
+        acquired = PyObject_IsTrue(r);
+        Py_DECREF(r);
+        return acquired;
+    }
+    r = PyObject_CallFunction(self->cond_acquire, "i", 0);
+    if (r == NULL)
+        return -1;
+    acquired = PyObject_IsTrue(r);
+    Py_DECREF(r);
+    if (acquired <= 0)
+        return acquired < 0 ? -1 : 1;
+    r = PyObject_CallObject(self->cond_release, NULL);
+    if (r == NULL)
+        return -1;
+    Py_DECREF(r);
+    return 0;
+}
+
+/* Release the lock completely; return what cond_acquire_restore() needs
+   to take it back. */
+static PyObject *
+cond_release_save(condobject *self)
+{
+    PyObject *r;
+
+    if (self->cond_kind == COND_LOCK) {
+        PyThread_release_lock(((lockobject *)self->cond_lock)->lock_lock);
+        Py_RETURN_NONE;
+    }
+    if (self->cond_kind == COND_RLOCK)
+        return rlock_release_save((rlockobject *)self->cond_lock);
+    if (self->cond_release_save != NULL)
+        return PyObject_CallObject(self->cond_release_save, NULL);
+    r = PyObject_CallObject(self->cond_release, NULL);
+    if (r == NULL)
+        return NULL;
+    Py_DECREF(r);
+    Py_RETURN_NONE;
+}
+
+static int
+cond_acquire_restore(condobject *self, PyObject *saved)
+{
+    PyObject *r;
+    unsigned long count;
+    long owner;
+
+    if (self->cond_kind == COND_LOCK) {
+        acquire_uninterrupted(((lockobject *)self->cond_lock)->lock_lock);
+        return 0;
+    }
+    if (self->cond_kind == COND_RLOCK) {
+        if (!PyArg_ParseTuple(saved, "kl:_acquire_restore", &count, &owner))
+            return -1;
+        return rlock_restore((rlockobject *)self->cond_lock, count, owner);
+    }
+    if (self->cond_acquire_restore != NULL)
+        r = PyObject_CallFunctionObjArgs(self->cond_acquire_restore,
+                                         saved, NULL);
+    else
+        r = PyObject_CallObject(self->cond_acquire, NULL);
+    if (r == NULL)
+        return -1;
+    Py_DECREF(r);
+    return 0;
+}
+
+static PyObject *
+cond_enter(condobject *self)
+{
+    if (cond_check(self) < 0)
+        return NULL;
+    if (self->cond_kind == COND_LOCK)
+        return lock_PyThread_acquire_lock((lockobject *)self->cond_lock,
+                                          NULL, 0, NULL);
+    if (self->cond_kind == COND_RLOCK)
+        return rlock_acquire((rlockobject *)self->cond_lock, NULL, 0, NULL);
+    return PyObject_CallMethod(self->cond_lock, "__enter__", NULL);
+}
+
+static PyObject *
+cond_exit(condobject *self, PyObject *args)
+{
+    PyObject *meth, *r;
+
+    if (cond_check(self) < 0)
+        return NULL;
+    if (self->cond_kind == COND_LOCK)
+        return lock_PyThread_release_lock((lockobject *)self->cond_lock);
+    if (self->cond_kind == COND_RLOCK)
+        return rlock_release((rlockobject *)self->cond_lock);
+    meth = PyObject_GetAttrString(self->cond_lock, "__exit__");
+    if (meth == NULL)
+        return NULL;
+    r = PyObject_Call(meth, args, NULL);
+    Py_DECREF(meth);
+    return r;
+}
+
+static PyObject *
+cond_owned(condobject *self)
+{
+    int owned;
+
+    if (cond_check(self) < 0)
+        return NULL;
+    owned = cond_is_owned(self);
+    if (owned < 0)
+        return NULL;
+    return PyBool_FromLong(owned);
+}
+
+static PyObject *
+cond_release_save_meth(condobject *self)
+{
+    if (cond_check(self) < 0)
+        return NULL;
+    return cond_release_save(self);
+}
+
+static PyObject *
+cond_acquire_restore_meth(condobject *self, PyObject *saved)
+{
+    if (cond_check(self) < 0 || cond_acquire_restore(self, saved) < 0)
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+static void
+cond_remove_waiter(condobject *self, PyObject *waiter)
+{
+    Py_ssize_t i;
+
+    for (i = 0; i < PyList_GET_SIZE(self->cond_waiters); i++) {
+        if (PyList_GET_ITEM(self->cond_waiters, i) == waiter) {
+            PyList_SetSlice(self->cond_waiters, i, i + 1, NULL);
+            return;
+        }
+    }
+}
+
+static PyObject *
+cond_wait(condobject *self, PyObject **args, Py_ssize_t nargs,
+          PyObject *kwnames)
+{
+    static const char * const kwlist[] = {"timeout", 0};
+    static _PyArg_Parser _parser = {"|O:wait", kwlist, 0};
+    PyObject *timeout_obj = Py_None, *saved;
+    PyObject *exc = NULL, *val = NULL, *tb = NULL;
+    PY_TIMEOUT_T timeout = -1;
+    PyLockStatus r;
+    lockobject *waiter;
+    int owned;
+
+    if (!_PyArg_ParseStackAndKeywords(args, nargs, kwnames, &_parser,
+                                      &timeout_obj))
+        return NULL;
+    if (timeout_obj != Py_None) {
+        double f = PyFloat_AsDouble(timeout_obj);
+        if (f == -1.0 && PyErr_Occurred())
+            return NULL;
+        /* A timeout <= 0 only gives notify() a chance between releasing
+           and reacquiring the lock; one too large to count waits forever */
+        f *= 1e6;
+        if (f <= 0)
+            timeout = 0;
+        else if (f < (double) PY_TIMEOUT_MAX)
+            timeout = (PY_TIMEOUT_T) f;
+    }
+
+    if (cond_check(self) < 0)
+        return NULL;
+    owned = cond_is_owned(self);
+    if (owned <= 0) {
+        if (owned == 0)
+            PyErr_SetString(PyExc_RuntimeError,
+                            "cannot wait on un-acquired lock");
+        return NULL;
+    }
+
+    waiter = newlockobject();
+    if (waiter == NULL)
+        return NULL;
+    PyThread_acquire_lock(waiter->lock_lock, 1);
+    if (PyList_Append(self->cond_waiters, (PyObject *)waiter) < 0) {
+        Py_DECREF(waiter);
+        return NULL;
+    }
+    saved = cond_release_save(self);
+    if (saved == NULL) {
+        cond_remove_waiter(self, (PyObject *)waiter);
+        Py_DECREF(waiter);
+        return NULL;
+    }
+    r = acquire_timed(waiter->lock_lock, timeout);
+    if (r != PY_LOCK_ACQUIRED) {
+        /* Timed out or interrupted; notify() may have taken us off the
+           list meanwhile */
+        cond_remove_waiter(self, (PyObject *)waiter);
+    }
+    Py_DECREF(waiter);
+    /* The lock is taken back even when a signal handler raised, and
+       maybe by calling Python code, so keep its exception aside */
+    if (r == PY_LOCK_INTR)
+        PyErr_Fetch(&exc, &val, &tb);
+    if (cond_acquire_restore(self, saved) < 0) {
+        Py_DECREF(saved);
+        if (r == PY_LOCK_INTR) {
+            Py_XDECREF(exc);
+            Py_XDECREF(val);
+            Py_XDECREF(tb);
+        }
+        return NULL;
+    }
+    Py_DECREF(saved);
+    if (r == PY_LOCK_INTR) {
+        PyErr_Restore(exc, val, tb);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(cond_wait_doc,
+"wait([timeout])\n\
+\n\
+Release the lock, wait until notified or until timeout seconds have\n\
+passed, then reacquire the lock.  The lock must be held by the calling\n\
+thread; otherwise a RuntimeError is raised.");
+
+static PyObject *
+cond_do_notify(condobject *self, Py_ssize_t n)
+{
+    int owned;
+
+    if (cond_check(self) < 0)
+        return NULL;
+    owned = cond_is_owned(self);
+    if (owned <= 0) {
+        if (owned == 0)
+            PyErr_SetString(PyExc_RuntimeError,
+                            "cannot notify on un-acquired lock");
+        return NULL;
+    }
+    while (n-- > 0 && PyList_GET_SIZE(self->cond_waiters) > 0) {
+        lockobject *waiter;
+        waiter = (lockobject *)PyList_GET_ITEM(self->cond_waiters, 0);
+        PyThread_release_lock(waiter->lock_lock);
+        if (PyList_SetSlice(self->cond_waiters, 0, 1, NULL) < 0)
+            return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+cond_notify(condobject *self, PyObject *args)
+{
+    Py_ssize_t n = 1;
+
+    if (!PyArg_ParseTuple(args, "|n:notify", &n))
+        return NULL;
+    return cond_do_notify(self, n);
+}
+
+PyDoc_STRVAR(cond_notify_doc,
+"notify([n])\n\
+\n\
+Wake up n (one by default) of the threads waiting on the condition.\n\
+The lock must be held by the calling thread.");
+
+static PyObject *
+cond_notify_all(condobject *self)
+{
+    if (cond_check(self) < 0)
+        return NULL;
+    return cond_do_notify(self, PyList_GET_SIZE(self->cond_waiters));
+}
+
+PyDoc_STRVAR(cond_notify_all_doc,
+"notify_all()\n\
+(notifyAll() is an obsolete synonym)\n\
+\n\
+Wake up all threads waiting on the condition.\n\
+The lock must be held by the calling thread.");
+
+static PyObject *
+cond_repr(condobject *self)
+{
+    PyObject *lock, *r;
+
+    if (self->cond_waiters == NULL)
+        return PyString_FromString("<Condition(uninitialized)>");
+    lock = PyObject_Str(self->cond_lock);
+    if (lock == NULL)
+        return NULL;
+    r = PyString_FromFormat("<Condition(%s, %zd)>", PyString_AsString(lock),
+                            PyList_GET_SIZE(self->cond_waiters));
+    Py_DECREF(lock);
+    return r;
+}
+
+static PyMethodDef cond_methods[] = {
+    {"wait",         (PyCFunction)cond_wait,
+     METH_FASTCALL, cond_wait_doc},
+    {"notify",       (PyCFunction)cond_notify,
+     METH_VARARGS, cond_notify_doc},
+    {"notify_all",   (PyCFunction)cond_notify_all,
+     METH_NOARGS, cond_notify_all_doc},
+    {"notifyAll",    (PyCFunction)cond_notify_all,
+     METH_NOARGS, cond_notify_all_doc},
+    {"_is_owned",    (PyCFunction)cond_owned,
+     METH_NOARGS, rlock_is_owned_doc},
+    {"_release_save", (PyCFunction)cond_release_save_meth,
+     METH_NOARGS, rlock_release_save_doc},
+    {"_acquire_restore", (PyCFunction)cond_acquire_restore_meth,
+     METH_O, rlock_acquire_restore_doc},
+    {"__enter__",    (PyCFunction)cond_enter,
+     METH_NOARGS, NULL},
+    {"__exit__",     (PyCFunction)cond_exit,
+     METH_VARARGS, NULL},
+    {NULL,           NULL}              /* sentinel */
+};
+
+/* Like threading._Condition, export the acquire() and release() methods
+   of the lock */
+static PyMemberDef cond_members[] = {
+    {"acquire", T_OBJECT, offsetof(condobject, cond_acquire), READONLY},
+    {"release", T_OBJECT, offsetof(condobject, cond_release), READONLY},
+    {NULL}
+};
+
+PyDoc_STRVAR(cond_doc,
+"Condition([lock])\n\
+\n\
+A condition variable, bound to lock (a new RLock by default), that lets\n\
+threads wait() until another thread notify()s them.");
+
+static PyTypeObject Condtype = {
+    PyVarObject_HEAD_INIT(&PyType_Type, 0)
+    "thread.Condition",                 /*tp_name*/
+    sizeof(condobject),                 /*tp_size*/
+    0,                                  /*tp_itemsize*/
+    /* methods */
+    (destructor)cond_dealloc,           /*tp_dealloc*/
+    0,                                  /*tp_print*/
+    0,                                  /*tp_getattr*/
+    0,                                  /*tp_setattr*/
+    0,                                  /*tp_compare*/
+    (reprfunc)cond_repr,                /*tp_repr*/
+    0,                                  /* tp_as_number */
+    0,                                  /* tp_as_sequence */
+    0,                                  /* tp_as_mapping */
+    0,                                  /* tp_hash */
+    0,                                  /* tp_call */
+    0,                                  /* tp_str */
+    0,                                  /* tp_getattro */
+    0,                                  /* tp_setattro */
+    0,                                  /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC,
+                                        /* tp_flags */
+    cond_doc,                           /* tp_doc */
+    (traverseproc)cond_traverse,        /* tp_traverse */
+    (inquiry)cond_clear,                /* tp_clear */
+    0,                                  /* tp_richcompare */
+    offsetof(condobject, in_weakreflist), /* tp_weaklistoffset */
+    0,                                  /* tp_iter */
+    0,                                  /* tp_iternext */
+    cond_methods,                       /* tp_methods */
+    cond_members,                       /* tp_members */
+    0,                                  /* tp_getset */
+    0,                                  /* tp_base */
+    0,                                  /* tp_dict */
+    0,                                  /* tp_descr_get */
+    0,                                  /* tp_descr_set */
+    0,                                  /* tp_dictoffset */
+    (initproc)cond_init,                /* tp_init */
+    PyType_GenericAlloc,                /* tp_alloc */
+    PyType_GenericNew                   /* tp_new */
+};
+
 /* Thread-local objects */
 
 #include "structmember.h"
@@ -882,7 +1794,8 @@ PyDoc_STRVAR(lock_doc,
 "A lock object is a synchronization primitive.  To create a lock,\n\
 call the PyThread_allocate_lock() function.  Methods are:\n\
 \n\
-acquire() -- lock the lock, possibly blocking until it can be obtained\n\
+acquire() -- lock the lock, possibly blocking (for at most a timeout)\n\
+             until it can be obtained\n\
 release() -- unlock of the lock\n\
 locked() -- test whether the lock is currently locked\n\
 \n\
@@ -894,6 +1807,7 @@ PyMODINIT_FUNC
 initthread(void)
 {
     PyObject *m, *d;
+    double timeout_max;
 
     /* Initialize types: */
     if (PyType_Ready(&localdummytype) < 0)
@@ -915,6 +1829,23 @@ initthread(void)
         return;
     Py_INCREF(&Locktype);
     PyDict_SetItemString(d, "LockType", (PyObject *)&Locktype);
+    if (PyType_Ready(&RLocktype) < 0)
+        return;
+    Py_INCREF(&RLocktype);
+    if (PyModule_AddObject(m, "RLock", (PyObject *)&RLocktype) < 0)
+        return;
+    if (PyType_Ready(&Condtype) < 0)
+        return;
+    Py_INCREF(&Condtype);
+    if (PyModule_AddObject(m, "Condition", (PyObject *)&Condtype) < 0)
+        return;
+
+    /* The longest timeout lock.acquire() accepts, rounded down to whole
+       seconds */
+    timeout_max = floor((double)PY_TIMEOUT_MAX / 1000000);
+    if (PyModule_AddObject(m, "TIMEOUT_MAX",
+                           PyFloat_FromDouble(timeout_max)) < 0)
+        return;
 
     Py_INCREF(&localtype);
     if (PyModule_AddObject(m, "_local", (PyObject *)&localtype) < 0)
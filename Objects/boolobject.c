@@ -192,11 +192,11 @@ PyTypeObject PyBool_Type = {
 
 /* Named Zero for link-level compatibility */
 PyIntObject _Py_ZeroStruct = {
-    PyObject_HEAD_INIT(&PyBool_Type)
+    PyObject_HEAD_IMMORTAL_INIT(&PyBool_Type)
     0
 };
 
 PyIntObject _Py_TrueStruct = {
-    PyObject_HEAD_INIT(&PyBool_Type)
+    PyObject_HEAD_IMMORTAL_INIT(&PyBool_Type)
     1
 };
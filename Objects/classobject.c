@@ -32,17 +32,17 @@ PyClass_New(PyObject *bases, PyObject *dict, PyObject *name)
     PyClassObject *op, *dummy;
     static PyObject *docstr, *modstr, *namestr;
     if (docstr == NULL) {
-        docstr= PyString_InternFromString("__doc__");
+        docstr= _PyString_InternImmortalFromString("__doc__");
         if (docstr == NULL)
             return NULL;
     }
     if (modstr == NULL) {
-        modstr= PyString_InternFromString("__module__");
+        modstr= _PyString_InternImmortalFromString("__module__");
         if (modstr == NULL)
             return NULL;
     }
     if (namestr == NULL) {
-        namestr= PyString_InternFromString("__name__");
+        namestr= _PyString_InternImmortalFromString("__name__");
         if (namestr == NULL)
             return NULL;
     }
@@ -101,13 +101,13 @@ PyClass_New(PyObject *bases, PyObject *dict, PyObject *name)
     }
 
     if (getattrstr == NULL) {
-        getattrstr = PyString_InternFromString("__getattr__");
+        getattrstr = _PyString_InternImmortalFromString("__getattr__");
         if (getattrstr == NULL)
             goto alloc_error;
-        setattrstr = PyString_InternFromString("__setattr__");
+        setattrstr = _PyString_InternImmortalFromString("__setattr__");
         if (setattrstr == NULL)
             goto alloc_error;
-        delattrstr = PyString_InternFromString("__delattr__");
+        delattrstr = _PyString_InternImmortalFromString("__delattr__");
         if (delattrstr == NULL)
             goto alloc_error;
     }
@@ -221,6 +221,14 @@ class_lookup(PyClassObject *cp, PyObject *name, PyClassObject **pclass)
     return NULL;
 }
 
+static PyObject *
+class_no_attribute_message(PyObject *cl_name, PyObject *name)
+{
+    return PyString_FromFormat("class %.50s has no attribute '%.400s'",
+                               PyString_AS_STRING(cl_name),
+                               PyString_AS_STRING(name));
+}
+
 static PyObject *
 class_getattr(register PyClassObject *op, PyObject *name)
 {
@@ -254,9 +262,8 @@ class_getattr(register PyClassObject *op, PyObject *name)
     }
     v = class_lookup(op, name, &klass);
     if (v == NULL) {
-        PyErr_Format(PyExc_AttributeError,
-                     "class %.50s has no attribute '%.400s'",
-                     PyString_AS_STRING(op->cl_name), sname);
+        _PyErr_SetDeferred(PyExc_AttributeError, class_no_attribute_message,
+                           op->cl_name, name);
         return NULL;
     }
     f = TP_DESCR_GET(v->ob_type);
@@ -544,7 +551,7 @@ PyInstance_New(PyObject *klass, PyObject *arg, PyObject *kw)
     static PyObject *initstr;
 
     if (initstr == NULL) {
-        initstr = PyString_InternFromString("__init__");
+        initstr = _PyString_InternImmortalFromString("__init__");
         if (initstr == NULL)
             return NULL;
     }
@@ -637,7 +644,7 @@ instance_dealloc(register PyInstanceObject *inst)
     PyErr_Fetch(&error_type, &error_value, &error_traceback);
     /* Execute __del__ method, if any. */
     if (delstr == NULL) {
-        delstr = PyString_InternFromString("__del__");
+        delstr = _PyString_InternImmortalFromString("__del__");
         if (delstr == NULL)
             PyErr_WriteUnraisable((PyObject*)inst);
     }
@@ -695,6 +702,14 @@ instance_dealloc(register PyInstanceObject *inst)
     }
 }
 
+static PyObject *
+instance_no_attribute_message(PyObject *cl_name, PyObject *name)
+{
+    return PyString_FromFormat("%.50s instance has no attribute '%.400s'",
+                               PyString_AS_STRING(cl_name),
+                               PyString_AS_STRING(name));
+}
+
 static PyObject *
 instance_getattr1(register PyInstanceObject *inst, PyObject *name)
 {
@@ -717,9 +732,9 @@ instance_getattr1(register PyInstanceObject *inst, PyObject *name)
     }
     v = instance_getattr2(inst, name);
     if (v == NULL && !PyErr_Occurred()) {
-        PyErr_Format(PyExc_AttributeError,
-                     "%.50s instance has no attribute '%.400s'",
-                     PyString_AS_STRING(inst->in_class->cl_name), sname);
+        _PyErr_SetDeferred(PyExc_AttributeError,
+                           instance_no_attribute_message,
+                           inst->in_class->cl_name, name);
     }
     return v;
 }
@@ -878,7 +893,7 @@ instance_repr(PyInstanceObject *inst)
     static PyObject *reprstr;
 
     if (reprstr == NULL) {
-        reprstr = PyString_InternFromString("__repr__");
+        reprstr = _PyString_InternImmortalFromString("__repr__");
         if (reprstr == NULL)
             return NULL;
     }
@@ -917,7 +932,7 @@ instance_str(PyInstanceObject *inst)
     static PyObject *strstr;
 
     if (strstr == NULL) {
-        strstr = PyString_InternFromString("__str__");
+        strstr = _PyString_InternImmortalFromString("__str__");
         if (strstr == NULL)
             return NULL;
     }
@@ -942,7 +957,7 @@ instance_hash(PyInstanceObject *inst)
     static PyObject *hashstr, *eqstr, *cmpstr;
 
     if (hashstr == NULL) {
-        hashstr = PyString_InternFromString("__hash__");
+        hashstr = _PyString_InternImmortalFromString("__hash__");
         if (hashstr == NULL)
             return -1;
     }
@@ -955,7 +970,7 @@ instance_hash(PyInstanceObject *inst)
            address.  If an __eq__ or __cmp__ method exists, there must
            be a __hash__. */
         if (eqstr == NULL) {
-            eqstr = PyString_InternFromString("__eq__");
+            eqstr = _PyString_InternImmortalFromString("__eq__");
             if (eqstr == NULL)
                 return -1;
         }
@@ -965,7 +980,7 @@ instance_hash(PyInstanceObject *inst)
                 return -1;
             PyErr_Clear();
             if (cmpstr == NULL) {
-                cmpstr = PyString_InternFromString("__cmp__");
+                cmpstr = _PyString_InternImmortalFromString("__cmp__");
                 if (cmpstr == NULL)
                     return -1;
             }
@@ -1017,7 +1032,7 @@ instance_length(PyInstanceObject *inst)
     Py_ssize_t outcome;
 
     if (lenstr == NULL) {
-        lenstr = PyString_InternFromString("__len__");
+        lenstr = _PyString_InternImmortalFromString("__len__");
         if (lenstr == NULL)
             return -1;
     }
@@ -1066,7 +1081,7 @@ instance_subscript(PyInstanceObject *inst, PyObject *key)
     PyObject *res;
 
     if (getitemstr == NULL) {
-        getitemstr = PyString_InternFromString("__getitem__");
+        getitemstr = _PyString_InternImmortalFromString("__getitem__");
         if (getitemstr == NULL)
             return NULL;
     }
@@ -1093,7 +1108,7 @@ instance_ass_subscript(PyInstanceObject *inst, PyObject *key, PyObject *value)
 
     if (value == NULL) {
         if (delitemstr == NULL) {
-            delitemstr = PyString_InternFromString("__delitem__");
+            delitemstr = _PyString_InternImmortalFromString("__delitem__");
             if (delitemstr == NULL)
                 return -1;
         }
@@ -1101,7 +1116,7 @@ instance_ass_subscript(PyInstanceObject *inst, PyObject *key, PyObject *value)
     }
     else {
         if (setitemstr == NULL) {
-            setitemstr = PyString_InternFromString("__setitem__");
+            setitemstr = _PyString_InternImmortalFromString("__setitem__");
             if (setitemstr == NULL)
                 return -1;
         }
@@ -1138,7 +1153,7 @@ instance_item(PyInstanceObject *inst, Py_ssize_t i)
     PyObject *func, *res;
 
     if (getitemstr == NULL) {
-        getitemstr = PyString_InternFromString("__getitem__");
+        getitemstr = _PyString_InternImmortalFromString("__getitem__");
         if (getitemstr == NULL)
             return NULL;
     }
@@ -1157,7 +1172,7 @@ instance_slice(PyInstanceObject *inst, Py_ssize_t i, Py_ssize_t j)
     static PyObject *getslicestr;
 
     if (getslicestr == NULL) {
-        getslicestr = PyString_InternFromString("__getslice__");
+        getslicestr = _PyString_InternImmortalFromString("__getslice__");
         if (getslicestr == NULL)
             return NULL;
     }
@@ -1169,7 +1184,7 @@ instance_slice(PyInstanceObject *inst, Py_ssize_t i, Py_ssize_t j)
         PyErr_Clear();
 
         if (getitemstr == NULL) {
-            getitemstr = PyString_InternFromString("__getitem__");
+            getitemstr = _PyString_InternImmortalFromString("__getitem__");
             if (getitemstr == NULL)
                 return NULL;
         }
@@ -1204,7 +1219,7 @@ instance_ass_item(PyInstanceObject *inst, Py_ssize_t i, PyObject *item)
 
     if (item == NULL) {
         if (delitemstr == NULL) {
-            delitemstr = PyString_InternFromString("__delitem__");
+            delitemstr = _PyString_InternImmortalFromString("__delitem__");
             if (delitemstr == NULL)
                 return -1;
         }
@@ -1212,7 +1227,7 @@ instance_ass_item(PyInstanceObject *inst, Py_ssize_t i, PyObject *item)
     }
     else {
         if (setitemstr == NULL) {
-            setitemstr = PyString_InternFromString("__setitem__");
+            setitemstr = _PyString_InternImmortalFromString("__setitem__");
             if (setitemstr == NULL)
                 return -1;
         }
@@ -1246,7 +1261,7 @@ instance_ass_slice(PyInstanceObject *inst, Py_ssize_t i, Py_ssize_t j, PyObject
     if (value == NULL) {
         if (delslicestr == NULL) {
             delslicestr =
-                PyString_InternFromString("__delslice__");
+                _PyString_InternImmortalFromString("__delslice__");
             if (delslicestr == NULL)
                 return -1;
         }
@@ -1257,7 +1272,7 @@ instance_ass_slice(PyInstanceObject *inst, Py_ssize_t i, Py_ssize_t j, PyObject
             PyErr_Clear();
             if (delitemstr == NULL) {
                 delitemstr =
-                    PyString_InternFromString("__delitem__");
+                    _PyString_InternImmortalFromString("__delitem__");
                 if (delitemstr == NULL)
                     return -1;
             }
@@ -1280,7 +1295,7 @@ instance_ass_slice(PyInstanceObject *inst, Py_ssize_t i, Py_ssize_t j, PyObject
     else {
         if (setslicestr == NULL) {
             setslicestr =
-                PyString_InternFromString("__setslice__");
+                _PyString_InternImmortalFromString("__setslice__");
             if (setslicestr == NULL)
                 return -1;
         }
@@ -1291,7 +1306,7 @@ instance_ass_slice(PyInstanceObject *inst, Py_ssize_t i, Py_ssize_t j, PyObject
             PyErr_Clear();
             if (setitemstr == NULL) {
                 setitemstr =
-                    PyString_InternFromString("__setitem__");
+                    _PyString_InternImmortalFromString("__setitem__");
                 if (setitemstr == NULL)
                     return -1;
             }
@@ -1335,7 +1350,7 @@ instance_contains(PyInstanceObject *inst, PyObject *member)
      */
 
     if(__contains__ == NULL) {
-        __contains__ = PyString_InternFromString("__contains__");
+        __contains__ = _PyString_InternImmortalFromString("__contains__");
         if(__contains__ == NULL)
             return -1;
     }
@@ -1441,7 +1456,7 @@ half_binop(PyObject *v, PyObject *w, char *opname, binaryfunc thisfunc,
     }
 
     if (coerce_obj == NULL) {
-        coerce_obj = PyString_InternFromString("__coerce__");
+        coerce_obj = _PyString_InternImmortalFromString("__coerce__");
         if (coerce_obj == NULL)
             return NULL;
     }
@@ -1528,7 +1543,7 @@ instance_coerce(PyObject **pv, PyObject **pw)
     PyObject *coerced;
 
     if (coerce_obj == NULL) {
-        coerce_obj = PyString_InternFromString("__coerce__");
+        coerce_obj = _PyString_InternImmortalFromString("__coerce__");
         if (coerce_obj == NULL)
             return -1;
     }
@@ -1576,7 +1591,7 @@ instance_coerce(PyObject **pv, PyObject **pw)
 #define UNARY(funcname, methodname) \
 static PyObject *funcname(PyInstanceObject *self) { \
     static PyObject *o; \
-    if (o == NULL) { o = PyString_InternFromString(methodname); \
+    if (o == NULL) { o = _PyString_InternImmortalFromString(methodname); \
                      if (o == NULL) return NULL; } \
     return generic_unary_op(self, o); \
 }
@@ -1585,7 +1600,7 @@ static PyObject *funcname(PyInstanceObject *self) { \
 #define UNARY_FB(funcname, methodname, funcname_fb) \
 static PyObject *funcname(PyInstanceObject *self) { \
     static PyObject *o; \
-    if (o == NULL) { o = PyString_InternFromString(methodname); \
+    if (o == NULL) { o = _PyString_InternImmortalFromString(methodname); \
                      if (o == NULL) return NULL; } \
     if (PyObject_HasAttr((PyObject*)self, o)) \
         return generic_unary_op(self, o); \
@@ -1654,7 +1669,7 @@ half_cmp(PyObject *v, PyObject *w)
     assert(PyInstance_Check(v));
 
     if (cmp_obj == NULL) {
-        cmp_obj = PyString_InternFromString("__cmp__");
+        cmp_obj = _PyString_InternImmortalFromString("__cmp__");
         if (cmp_obj == NULL)
             return -2;
     }
@@ -1762,7 +1777,7 @@ instance_nonzero(PyInstanceObject *self)
     static PyObject *nonzerostr;
 
     if (nonzerostr == NULL) {
-        nonzerostr = PyString_InternFromString("__nonzero__");
+        nonzerostr = _PyString_InternImmortalFromString("__nonzero__");
         if (nonzerostr == NULL)
             return -1;
     }
@@ -1771,7 +1786,7 @@ instance_nonzero(PyInstanceObject *self)
             return -1;
         PyErr_Clear();
         if (lenstr == NULL) {
-            lenstr = PyString_InternFromString("__len__");
+            lenstr = _PyString_InternImmortalFromString("__len__");
             if (lenstr == NULL)
                 return -1;
         }
@@ -1811,7 +1826,7 @@ instance_index(PyInstanceObject *self)
     static PyObject *indexstr = NULL;
 
     if (indexstr == NULL) {
-        indexstr = PyString_InternFromString("__index__");
+        indexstr = _PyString_InternImmortalFromString("__index__");
         if (indexstr == NULL)
             return NULL;
     }
@@ -1838,7 +1853,7 @@ instance_int(PyInstanceObject *self)
     PyObject *truncated;
     static PyObject *int_name;
     if (int_name == NULL) {
-        int_name = PyString_InternFromString("__int__");
+        int_name = _PyString_InternImmortalFromString("__int__");
         if (int_name == NULL)
             return NULL;
     }
@@ -1953,7 +1968,7 @@ init_name_op(void)
     if (name_op == NULL)
         return -1;
     for (i = 0; i < NAME_OPS; ++i) {
-        name_op[i] = PyString_InternFromString(_name_op[i]);
+        name_op[i] = _PyString_InternImmortalFromString(_name_op[i]);
         if (name_op[i] == NULL)
             return -1;
     }
@@ -2036,12 +2051,12 @@ instance_getiter(PyInstanceObject *self)
     PyObject *func;
 
     if (iterstr == NULL) {
-        iterstr = PyString_InternFromString("__iter__");
+        iterstr = _PyString_InternImmortalFromString("__iter__");
         if (iterstr == NULL)
             return NULL;
     }
     if (getitemstr == NULL) {
-        getitemstr = PyString_InternFromString("__getitem__");
+        getitemstr = _PyString_InternImmortalFromString("__getitem__");
         if (getitemstr == NULL)
             return NULL;
     }
@@ -2079,7 +2094,7 @@ instance_iternext(PyInstanceObject *self)
     PyObject *func;
 
     if (nextstr == NULL) {
-        nextstr = PyString_InternFromString("next");
+        nextstr = _PyString_InternImmortalFromString("next");
         if (nextstr == NULL)
             return NULL;
     }
@@ -2281,7 +2296,7 @@ instancemethod_get_doc(PyMethodObject *im, void *context)
 {
     static PyObject *docstr;
     if (docstr == NULL) {
-        docstr= PyString_InternFromString("__doc__");
+        docstr= _PyString_InternImmortalFromString("__doc__");
         if (docstr == NULL)
             return NULL;
     }
@@ -104,6 +104,8 @@ PyCode_New(int argcount, int nlocals, int stacksize, int flags,
         co->co_lnotab = lnotab;
         co->co_zombieframe = NULL;
         co->co_weakreflist = NULL;
+        co->co_opcounts = NULL;
+        co->co_attrcache = NULL;
     }
     return co;
 }
@@ -315,6 +317,10 @@ code_dealloc(PyCodeObject *co)
     Py_XDECREF(co->co_lnotab);
     if (co->co_zombieframe != NULL)
         PyObject_GC_Del(co->co_zombieframe);
+    if (co->co_opcounts != NULL)
+        PyMem_Free(co->co_opcounts);
+    if (co->co_attrcache != NULL)
+        PyMem_Free(co->co_attrcache);
     if (co->co_weakreflist != NULL)
         PyObject_ClearWeakRefs((PyObject*)co);
     PyObject_DEL(co);
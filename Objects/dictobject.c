@@ -10,19 +10,6 @@
 #include "Python.h"
 
 long dub_hash(long x);
-/* Set a key error with the specified argument, wrapping it in a
- * tuple automatically so that tuple keys are not unpacked as the
- * exception arguments. */
-static void
-set_key_error(PyObject *arg)
-{
-    PyObject *tup;
-    tup = PyTuple_Pack(1, arg);
-    if (!tup)
-        return; /* caller will expect error to be set anyway */
-    PyErr_SetObject(PyExc_KeyError, tup);
-    Py_DECREF(tup);
-}
 
 /* Define this out if you don't want conversion statistics on exit. */
 #undef SHOW_CONVERSION_COUNTS
@@ -226,16 +213,24 @@ show_track(void)
 static PyDictObject *free_list[PyDict_MAXFREELIST];
 static int numfree = 0;
 
-void
-PyDict_Fini(void)
+int
+PyDict_ClearFreeList(void)
 {
     PyDictObject *op;
+    int ret = numfree;
 
     while (numfree) {
         op = free_list[--numfree];
         assert(PyDict_CheckExact(op));
         PyObject_GC_Del(op);
     }
+    return ret;
+}
+
+void
+PyDict_Fini(void)
+{
+    (void)PyDict_ClearFreeList();
 }
 
 PyObject *
@@ -643,7 +638,7 @@ actually be smaller than the old one.
 static int
 dictresize(PyDictObject *mp, Py_ssize_t minused)
 {
-    Py_ssize_t newsize;
+    Py_ssize_t newsize, oldsize;
     PyDictEntry *oldtable, *newtable, *ep;
     Py_ssize_t i;
     int is_oldtable_malloced;
@@ -686,7 +681,10 @@ dictresize(PyDictObject *mp, Py_ssize_t minused)
         }
     }
     else {
-        newtable = PyMem_NEW(PyDictEntry, newsize);
+        if ((size_t)newsize > PY_SSIZE_T_MAX / sizeof(PyDictEntry))
+            newtable = NULL;
+        else
+            newtable = _PyMem_TableAlloc(sizeof(PyDictEntry) * newsize);
         if (newtable == NULL) {
             PyErr_NoMemory();
             return -1;
@@ -695,6 +693,7 @@ dictresize(PyDictObject *mp, Py_ssize_t minused)
 
     /* Make the dict empty, using the new table. */
     assert(newtable != oldtable);
+    oldsize = mp->ma_mask + 1;
     mp->ma_table = newtable;
     mp->ma_mask = newsize - 1;
     memset(newtable, 0, sizeof(PyDictEntry) * newsize);
@@ -719,7 +718,7 @@ dictresize(PyDictObject *mp, Py_ssize_t minused)
     }
 
     if (is_oldtable_malloced)
-        PyMem_DEL(oldtable);
+        _PyMem_TableFree(oldtable, sizeof(PyDictEntry) * oldsize);
     return 0;
 }
 
@@ -874,7 +873,7 @@ PyDict_DelItem(PyObject *op, PyObject *key)
     if (ep == NULL)
         return -1;
     if (ep->me_value == NULL) {
-        set_key_error(key);
+        _PyErr_SetKeyError(key);
         return -1;
     }
     old_key = ep->me_key;
@@ -894,7 +893,7 @@ PyDict_Clear(PyObject *op)
     PyDictObject *mp;
     PyDictEntry *ep, *table;
     int table_is_malloced;
-    Py_ssize_t fill;
+    Py_ssize_t fill, size;
     PyDictEntry small_copy[PyDict_MINSIZE];
 #ifdef Py_DEBUG
     Py_ssize_t i, n;
@@ -903,8 +902,9 @@ PyDict_Clear(PyObject *op)
     if (!PyDict_Check(op))
         return;
     mp = (PyDictObject *)op;
+    size = mp->ma_mask + 1;
 #ifdef Py_DEBUG
-    n = mp->ma_mask + 1;
+    n = size;
     i = 0;
 #endif
 
@@ -954,7 +954,7 @@ PyDict_Clear(PyObject *op)
     }
 
     if (table_is_malloced)
-        PyMem_DEL(table);
+        _PyMem_TableFree(table, sizeof(PyDictEntry) * size);
 }
 
 /*
@@ -1043,7 +1043,8 @@ dict_dealloc(register PyDictObject *mp)
         }
     }
     if (mp->ma_table != mp->ma_smalltable)
-        PyMem_DEL(mp->ma_table);
+        _PyMem_TableFree(mp->ma_table,
+                         sizeof(PyDictEntry) * (mp->ma_mask + 1));
     if (numfree < PyDict_MAXFREELIST && Py_TYPE(mp) == &PyDict_Type)
         free_list[numfree++] = mp;
     else
@@ -1226,7 +1227,7 @@ dict_subscript(PyDictObject *mp, register PyObject *key)
             else if (PyErr_Occurred())
                 return NULL;
         }
-        set_key_error(key);
+        _PyErr_SetKeyError(key);
         return NULL;
     }
     else
@@ -1963,7 +1964,8 @@ dict_has_key(register PyDictObject *mp, PyObject *key)
 }
 
 static PyObject *
-dict_get(register PyDictObject *mp, PyObject *args)
+dict_get(register PyDictObject *mp, PyObject **args,
+         Py_ssize_t nargs, PyObject *kwnames)
 {
     PyObject *key;
     PyObject *failobj = Py_None;
@@ -1971,7 +1973,8 @@ dict_get(register PyDictObject *mp, PyObject *args)
     long hash;
     PyDictEntry *ep;
 
-    if (!PyArg_UnpackTuple(args, "get", 1, 2, &key, &failobj))
+    if (!_PyArg_NoStackKeywords("get", kwnames) ||
+        !_PyArg_UnpackStack(args, nargs, "get", 1, 2, &key, &failobj))
         return NULL;
 
     if (!PyString_CheckExact(key) ||
@@ -1992,7 +1995,8 @@ dict_get(register PyDictObject *mp, PyObject *args)
 
 
 static PyObject *
-dict_setdefault(register PyDictObject *mp, PyObject *args)
+dict_setdefault(register PyDictObject *mp, PyObject **args,
+                Py_ssize_t nargs, PyObject *kwnames)
 {
     PyObject *key;
     PyObject *failobj = Py_None;
@@ -2000,7 +2004,8 @@ dict_setdefault(register PyDictObject *mp, PyObject *args)
     long hash;
     PyDictEntry *ep;
 
-    if (!PyArg_UnpackTuple(args, "setdefault", 1, 2, &key, &failobj))
+    if (!_PyArg_NoStackKeywords("setdefault", kwnames) ||
+        !_PyArg_UnpackStack(args, nargs, "setdefault", 1, 2, &key, &failobj))
         return NULL;
 
     if (!PyString_CheckExact(key) ||
@@ -2031,21 +2036,23 @@ dict_clear(register PyDictObject *mp)
 }
 
 static PyObject *
-dict_pop(PyDictObject *mp, PyObject *args)
+dict_pop(PyDictObject *mp, PyObject **args,
+         Py_ssize_t nargs, PyObject *kwnames)
 {
     long hash;
     PyDictEntry *ep;
     PyObject *old_value, *old_key;
     PyObject *key, *deflt = NULL;
 
-    if(!PyArg_UnpackTuple(args, "pop", 1, 2, &key, &deflt))
+    if (!_PyArg_NoStackKeywords("pop", kwnames) ||
+        !_PyArg_UnpackStack(args, nargs, "pop", 1, 2, &key, &deflt))
         return NULL;
     if (mp->ma_used == 0) {
         if (deflt) {
             Py_INCREF(deflt);
             return deflt;
         }
-        set_key_error(key);
+        _PyErr_SetKeyError(key);
         return NULL;
     }
     if (!PyString_CheckExact(key) ||
@@ -2062,7 +2069,7 @@ dict_pop(PyDictObject *mp, PyObject *args)
             Py_INCREF(deflt);
             return deflt;
         }
-        set_key_error(key);
+        _PyErr_SetKeyError(key);
         return NULL;
     }
     old_key = ep->me_key;
@@ -2270,11 +2277,11 @@ static PyMethodDef mapp_methods[] = {
      sizeof__doc__},
     {"has_key",         (PyCFunction)dict_has_key,      METH_O,
      has_key__doc__},
-    {"get",         (PyCFunction)dict_get,          METH_VARARGS,
+    {"get",         (PyCFunction)dict_get,          METH_FASTCALL,
      get__doc__},
-    {"setdefault",  (PyCFunction)dict_setdefault,   METH_VARARGS,
+    {"setdefault",  (PyCFunction)dict_setdefault,   METH_FASTCALL,
      setdefault_doc__},
-    {"pop",         (PyCFunction)dict_pop,          METH_VARARGS,
+    {"pop",         (PyCFunction)dict_pop,          METH_FASTCALL,
      pop__doc__},
     {"popitem",         (PyCFunction)dict_popitem,      METH_NOARGS,
      popitem__doc__},
@@ -2731,6 +2738,7 @@ static PyObject *dictiter_iternextitem(dictiterobject *di)
         Py_INCREF(result);
         Py_DECREF(PyTuple_GET_ITEM(result, 0));
         Py_DECREF(PyTuple_GET_ITEM(result, 1));
+        _PyTuple_FORGET_HASH(result);
     } else {
         result = PyTuple_New(2);
         if (result == NULL)
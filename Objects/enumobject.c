@@ -106,6 +106,7 @@ enum_next_long(enumobject *en, PyObject* next_item)
         Py_INCREF(result);
         Py_DECREF(PyTuple_GET_ITEM(result, 0));
         Py_DECREF(PyTuple_GET_ITEM(result, 1));
+        _PyTuple_FORGET_HASH(result);
     } else {
         result = PyTuple_New(2);
         if (result == NULL) {
@@ -145,6 +146,7 @@ enum_next(enumobject *en)
         Py_INCREF(result);
         Py_DECREF(PyTuple_GET_ITEM(result, 0));
         Py_DECREF(PyTuple_GET_ITEM(result, 1));
+        _PyTuple_FORGET_HASH(result);
     } else {
         result = PyTuple_New(2);
         if (result == NULL) {
@@ -22,9 +22,11 @@ PyInt_GetMax(void)
    overhead (in space and time) than straight malloc(): a simple
    dedicated free list, filled when necessary with memory from malloc().
 
-   block_list is a singly-linked list of all PyIntBlocks ever allocated,
-   linked via their next members.  PyIntBlocks are never returned to the
-   system before shutdown (PyInt_Fini).
+   block_list is a singly-linked list of all PyIntBlocks allocated, linked
+   via their next members.  PyInt_ClearFreeList() returns the blocks that
+   hold no live int to the system; the collector calls it on full
+   collections, and through _PyInt_ReclaimBlocks() after the others once
+   most of the ints have been freed.
 
    free_list is a singly-linked list of available PyIntObjects, linked
    via abuse of their ob_type members.
@@ -44,6 +46,17 @@ typedef struct _intblock PyIntBlock;
 static PyIntBlock *block_list = NULL;
 static PyIntObject *free_list = NULL;
 
+/* Blocks on block_list and ints on free_list, plus totals of the blocks
+   given back to the system and of the passes that looked for them. */
+static Py_ssize_t numblocks = 0;
+static Py_ssize_t numfree = 0;
+static Py_ssize_t reclaimed_blocks = 0;
+static Py_ssize_t reclaim_passes = 0;
+
+/* The free and live ints left behind by the last pass over the blocks. */
+static Py_ssize_t numfree_after_pass = 0;
+static Py_ssize_t numlive_after_pass = 0;
+
 static PyIntObject *
 fill_free_list(void)
 {
@@ -54,6 +67,8 @@ fill_free_list(void)
         return (PyIntObject *) PyErr_NoMemory();
     ((PyIntBlock *)p)->next = block_list;
     block_list = (PyIntBlock *)p;
+    numblocks++;
+    numfree += N_INTOBJECTS;
     /* Link the int objects together, from rear to front, then return
        the address of the last int object in the block. */
     p = &((PyIntBlock *)p)->objects[0];
@@ -107,6 +122,7 @@ PyInt_FromLong(long ival)
     /* Inline PyObject_New */
     v = free_list;
     free_list = (PyIntObject *)Py_TYPE(v);
+    numfree--;
     PyObject_INIT(v, &PyInt_Type);
     v->ob_ival = ival;
     return (PyObject *) v;
@@ -134,6 +150,7 @@ int_dealloc(PyIntObject *v)
     if (PyInt_CheckExact(v)) {
         Py_TYPE(v) = (struct _typeobject *)free_list;
         free_list = v;
+        numfree++;
     }
     else
         Py_TYPE(v)->tp_free((PyObject *)v);
@@ -144,6 +161,7 @@ int_free(PyIntObject *v)
 {
     Py_TYPE(v) = (struct _typeobject *)free_list;
     free_list = v;
+    numfree++;
 }
 
 long
@@ -1441,9 +1459,11 @@ _PyInt_Init(void)
         /* PyObject_New is inlined */
         v = free_list;
         free_list = (PyIntObject *)Py_TYPE(v);
+        numfree--;
         PyObject_INIT(v, &PyInt_Type);
         v->ob_ival = ival;
         small_ints[ival + NSMALLNEGINTS] = v;
+        _Py_SetImmortal((PyObject *)v);
     }
 #endif
     return 1;
@@ -1461,6 +1481,9 @@ PyInt_ClearFreeList(void)
     list = block_list;
     block_list = NULL;
     free_list = NULL;
+    numblocks = 0;
+    numfree = 0;
+    reclaim_passes++;
     while (list != NULL) {
         u = 0;
         for (i = 0, p = &list->objects[0];
@@ -1473,6 +1496,7 @@ PyInt_ClearFreeList(void)
         if (u) {
             list->next = block_list;
             block_list = list;
+            numblocks++;
             for (i = 0, p = &list->objects[0];
                  i < N_INTOBJECTS;
                  i++, p++) {
@@ -1481,6 +1505,7 @@ PyInt_ClearFreeList(void)
                     Py_TYPE(p) = (struct _typeobject *)
                         free_list;
                     free_list = p;
+                    numfree++;
                 }
 #if NSMALLNEGINTS + NSMALLPOSINTS > 0
                 else if (-NSMALLNEGINTS <= p->ob_ival &&
@@ -1496,14 +1521,55 @@ PyInt_ClearFreeList(void)
         }
         else {
             PyMem_FREE(list);
+            reclaimed_blocks++;
         }
         freelist_size += u;
         list = next;
     }
+    numfree_after_pass = numfree;
+    numlive_after_pass = numblocks * (Py_ssize_t)N_INTOBJECTS - numfree;
 
     return freelist_size;
 }
 
+/* Don't bother looking for free blocks below this many free ints. */
+#define RECLAIM_MIN_FREE (64 * (Py_ssize_t)N_INTOBJECTS)
+
+/* Return the blocks that hold no live int to the system, if enough ints
+   have been freed to make it worth a pass over all the blocks:  the free
+   list must hold more ints than are alive.  So that a fragmented heap
+   isn't scanned over and over, it must also hold twice as many as the
+   last pass left behind, or half as many ints must be alive, which frees
+   the blocks the last pass had to keep.  Called by the collector after
+   every collection.  Return the number of blocks released. */
+Py_ssize_t
+_PyInt_ReclaimBlocks(void)
+{
+    Py_ssize_t before = reclaimed_blocks;
+    Py_ssize_t live = numblocks * (Py_ssize_t)N_INTOBJECTS - numfree;
+
+    if (numfree < RECLAIM_MIN_FREE || numfree <= live ||
+        (numfree < 2 * numfree_after_pass &&
+         live >= numlive_after_pass / 2))
+        return 0;
+    (void)PyInt_ClearFreeList();
+    return reclaimed_blocks - before;
+}
+
+PyObject *
+_PyInt_BlockStats(void)
+{
+    Py_ssize_t live = numblocks * (Py_ssize_t)N_INTOBJECTS - numfree;
+
+    return Py_BuildValue("{snsnsnsnsnsn}",
+                         "block_size", (Py_ssize_t)sizeof(PyIntBlock),
+                         "blocks", numblocks,
+                         "live", live,
+                         "free", numfree,
+                         "reclaimed_blocks", reclaimed_blocks,
+                         "passes", reclaim_passes);
+}
+
 void
 PyInt_Fini(void)
 {
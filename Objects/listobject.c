@@ -776,11 +776,13 @@ list_ass_item(PyListObject *a, Py_ssize_t i, PyObject *v)
 }
 
 static PyObject *
-listinsert(PyListObject *self, PyObject *args)
+listinsert(PyListObject *self, PyObject **args,
+           Py_ssize_t nargs, PyObject *kwnames)
 {
     Py_ssize_t i;
     PyObject *v;
-    if (!PyArg_ParseTuple(args, "nO:insert", &i, &v))
+    if (!_PyArg_NoStackKeywords("insert", kwnames) ||
+        !_PyArg_ParseStack(args, nargs, "nO:insert", &i, &v))
         return NULL;
     if (ins1(self, i, v) == 0)
         Py_RETURN_NONE;
@@ -924,13 +926,15 @@ list_inplace_concat(PyListObject *self, PyObject *other)
 }
 
 static PyObject *
-listpop(PyListObject *self, PyObject *args)
+listpop(PyListObject *self, PyObject **args,
+        Py_ssize_t nargs, PyObject *kwnames)
 {
     Py_ssize_t i = -1;
     PyObject *v;
     int status;
 
-    if (!PyArg_ParseTuple(args, "|n:pop", &i))
+    if (!_PyArg_NoStackKeywords("pop", kwnames) ||
+        !_PyArg_ParseStack(args, nargs, "|n:pop", &i))
         return NULL;
 
     if (Py_SIZE(self) == 0) {
@@ -981,12 +985,83 @@ reverse_slice(PyObject **lo, PyObject **hi)
  * pieces to this algorithm; read listsort.txt for overviews and details.
  */
 
-/* Comparison function.  Takes care of calling a user-supplied
- * comparison function (any callable Python object), which must not be
- * NULL (use the ISLT macro if you don't know, or call PyObject_RichCompareBool
- * with Py_LT if you know it's NULL).
- * Returns -1 on error, 1 if x < y, 0 if x >= y.
+/* The maximum number of entries in a MergeState's pending-runs stack.
+ * This is enough to sort arrays of size up to about
+ *     32 * phi ** MAX_MERGE_PENDING
+ * where phi ~= 1.618.  85 is ridiculouslylarge enough, good for an array
+ * with 2**64 elements.
+ */
+#define MAX_MERGE_PENDING 85
+
+/* When we get into galloping mode, we stay there until both runs win less
+ * often than MIN_GALLOP consecutive times.  See listsort.txt for more info.
+ */
+#define MIN_GALLOP 7
+
+/* Avoid malloc for small temp arrays. */
+#define MERGESTATE_TEMP_SIZE 256
+
+/* One MergeState exists on the stack per invocation of mergesort.  It's just
+ * a convenient way to pass state around among the helper functions.
  */
+struct s_slice {
+    PyObject **base;
+    Py_ssize_t len;
+};
+
+typedef struct s_MergeState MergeState;
+
+struct s_MergeState {
+    /* The user-supplied comparison function. or NULL if none given. */
+    PyObject *compare;
+
+    /* The function used for "<" on the items being sorted, see ISLT.
+     * Without a user comparison function it is key_lt, or sortwrapper_lt
+     * when sorting with a key function.
+     */
+    int (*lt)(PyObject *, PyObject *, MergeState *);
+
+    /* The "<" on keys, picked by merge_pick_lt() from the types of the
+     * keys.  key_richcompare is their tp_richcompare and tuple_elem_lt
+     * compares the first items of tuple keys.
+     */
+    int (*key_lt)(PyObject *, PyObject *, MergeState *);
+    richcmpfunc key_richcompare;
+    int (*tuple_elem_lt)(PyObject *, PyObject *, MergeState *);
+
+    /* This controls when we get *into* galloping mode.  It's initialized
+     * to MIN_GALLOP.  merge_lo and merge_hi tend to nudge it higher for
+     * random data, and lower for highly structured data.
+     */
+    Py_ssize_t min_gallop;
+
+    /* 'a' is temp storage to help with merges.  It contains room for
+     * alloced entries.
+     */
+    PyObject **a;       /* may point to temparray below */
+    Py_ssize_t alloced;
+
+    /* A stack of n pending runs yet to be merged.  Run #i starts at
+     * address base[i] and extends for len[i] elements.  It's always
+     * true (so long as the indices are in bounds) that
+     *
+     *     pending[i].base + pending[i].len == pending[i+1].base
+     *
+     * so we could cut the storage for this, but it's a minor amount,
+     * and keeping all the info explicit simplifies the code.
+     */
+    int n;
+    struct s_slice pending[MAX_MERGE_PENDING];
+
+    /* 'a' points to this when possible, rather than muck with malloc. */
+    PyObject *temparray[MERGESTATE_TEMP_SIZE];
+};
+
+/* Comparison functions.  Each returns -1 on error, 1 if x < y, 0 if
+ * x >= y.
+ */
+
+/* Call the user's comparison function.  It must not be NULL. */
 static int
 islt(PyObject *x, PyObject *y, PyObject *compare)
 {
@@ -1021,20 +1096,112 @@ islt(PyObject *x, PyObject *y, PyObject *compare)
     return i < 0;
 }
 
-/* If COMPARE is NULL, calls PyObject_RichCompareBool with Py_LT, else calls
- * islt.  This avoids a layer of function call in the usual case, and
- * sorting does many comparisons.
- * Returns -1 on error, 1 if x < y, 0 if x >= y.
+static int
+cmp_lt(PyObject *x, PyObject *y, MergeState *ms)
+{
+    return islt(x, y, ms->compare);
+}
+
+static int
+safe_object_lt(PyObject *x, PyObject *y, MergeState *ms)
+{
+    return PyObject_RichCompareBool(x, y, Py_LT);
+}
+
+/* The functions below skip the type dispatch of PyObject_RichCompareBool().
+ * They are only used once merge_pick_lt() has checked that all keys are of
+ * the type they expect, and don't check it again.
+ */
+
+/* All keys are of one type, with a tp_richcompare; call it directly. */
+static int
+unsafe_object_lt(PyObject *x, PyObject *y, MergeState *ms)
+{
+    PyObject *res;
+    int k;
+
+    /* A comparison may have assigned to __class__ */
+    if (Py_TYPE(x)->tp_richcompare != ms->key_richcompare)
+        return PyObject_RichCompareBool(x, y, Py_LT);
+    res = (*ms->key_richcompare)(x, y, Py_LT);
+    if (res == Py_NotImplemented) {
+        Py_DECREF(res);
+        return PyObject_RichCompareBool(x, y, Py_LT);
+    }
+    if (res == NULL)
+        return -1;
+    if (PyBool_Check(res))
+        k = (res == Py_True);
+    else
+        k = PyObject_IsTrue(res);
+    Py_DECREF(res);
+    return k;
+}
+
+/* All keys are exact str: the same byte order as string_richcompare() */
+static int
+unsafe_string_lt(PyObject *x, PyObject *y, MergeState *ms)
+{
+    Py_ssize_t len_x = PyString_GET_SIZE(x);
+    Py_ssize_t len_y = PyString_GET_SIZE(y);
+    int c;
+
+    c = memcmp(PyString_AS_STRING(x), PyString_AS_STRING(y),
+               len_x < len_y ? len_x : len_y);
+    return c != 0 ? c < 0 : len_x < len_y;
+}
+
+/* All keys are exact int */
+static int
+unsafe_int_lt(PyObject *x, PyObject *y, MergeState *ms)
+{
+    return PyInt_AS_LONG(x) < PyInt_AS_LONG(y);
+}
+
+/* All keys are exact float; a NaN is never less than anything, as with
+   float_richcompare() */
+static int
+unsafe_float_lt(PyObject *x, PyObject *y, MergeState *ms)
+{
+    return PyFloat_AS_DOUBLE(x) < PyFloat_AS_DOUBLE(y);
+}
+
+/* All keys are non-empty exact tuples.  Like tuplerichcompare(), find the
+   first items that differ, then compare those; tuple_elem_lt is used for
+   the first items, which merge_pick_lt() checked too. */
+static int
+unsafe_tuple_lt(PyObject *x, PyObject *y, MergeState *ms)
+{
+    Py_ssize_t i, len_x = Py_SIZE(x), len_y = Py_SIZE(y);
+    int k;
+
+    for (i = 0; i < len_x && i < len_y; i++) {
+        k = PyObject_RichCompareBool(PyTuple_GET_ITEM(x, i),
+                                     PyTuple_GET_ITEM(y, i), Py_EQ);
+        if (k < 0)
+            return -1;
+        if (!k)
+            break;
+    }
+    if (i >= len_x || i >= len_y)
+        return len_x < len_y;
+    if (i == 0)
+        return (*ms->tuple_elem_lt)(PyTuple_GET_ITEM(x, 0),
+                                    PyTuple_GET_ITEM(y, 0), ms);
+    return PyObject_RichCompareBool(PyTuple_GET_ITEM(x, i),
+                                    PyTuple_GET_ITEM(y, i), Py_LT);
+}
+
+/* Compare X to Y with the function picked for this sort, ms->lt.
+ * Returns -1 on error, 1 if X < Y, 0 if X >= Y.
  */
-#define ISLT(X, Y, COMPARE) ((COMPARE) == NULL ?                        \
-                 PyObject_RichCompareBool(X, Y, Py_LT) :                \
-                 islt(X, Y, COMPARE))
+#define ISLT(X, Y) (*(ms->lt))(X, Y, ms)
 
 /* Compare X to Y via "<".  Goto "fail" if the comparison raises an
    error.  Else "k" is set to true iff X<Y, and an "if (k)" block is
    started.  It makes more sense in context <wink>.  X and Y are PyObject*s.
 */
-#define IFLT(X, Y) if ((k = ISLT(X, Y, compare)) < 0) goto fail;  \
+#define IFLT(X, Y) if ((k = ISLT(X, Y)) < 0) goto fail;  \
            if (k)
 
 /* binarysort is the best method for sorting small arrays: it does
@@ -1049,8 +1216,7 @@ islt(PyObject *x, PyObject *y, PyObject *compare)
    the input (nothing is lost or duplicated).
 */
 static int
-binarysort(PyObject **lo, PyObject **hi, PyObject **start, PyObject *compare)
-     /* compare -- comparison function object, or NULL for default */
+binarysort(MergeState *ms, PyObject **lo, PyObject **hi, PyObject **start)
 {
     register Py_ssize_t k;
     register PyObject **l, **p, **r;
@@ -1115,7 +1281,7 @@ elements to get out of order).
 Returns -1 in case of error.
 */
 static Py_ssize_t
-count_run(PyObject **lo, PyObject **hi, PyObject *compare, int *descending)
+count_run(MergeState *ms, PyObject **lo, PyObject **hi, int *descending)
 {
     Py_ssize_t k;
     Py_ssize_t n;
@@ -1170,7 +1336,8 @@ key, and the last n-k should follow key.
 Returns -1 on error.  See listsort.txt for info on the method.
 */
 static Py_ssize_t
-gallop_left(PyObject *key, PyObject **a, Py_ssize_t n, Py_ssize_t hint, PyObject *compare)
+gallop_left(MergeState *ms, PyObject *key, PyObject **a, Py_ssize_t n,
+            Py_ssize_t hint)
 {
     Py_ssize_t ofs;
     Py_ssize_t lastofs;
@@ -1261,7 +1428,8 @@ we're sticking to "<" comparisons that it's much harder to follow if
 written as one routine with yet another "left or right?" flag.
 */
 static Py_ssize_t
-gallop_right(PyObject *key, PyObject **a, Py_ssize_t n, Py_ssize_t hint, PyObject *compare)
+gallop_right(MergeState *ms, PyObject *key, PyObject **a, Py_ssize_t n,
+             Py_ssize_t hint)
 {
     Py_ssize_t ofs;
     Py_ssize_t lastofs;
@@ -1337,68 +1505,13 @@ fail:
     return -1;
 }
 
-/* The maximum number of entries in a MergeState's pending-runs stack.
- * This is enough to sort arrays of size up to about
- *     32 * phi ** MAX_MERGE_PENDING
- * where phi ~= 1.618.  85 is ridiculouslylarge enough, good for an array
- * with 2**64 elements.
- */
-#define MAX_MERGE_PENDING 85
-
-/* When we get into galloping mode, we stay there until both runs win less
- * often than MIN_GALLOP consecutive times.  See listsort.txt for more info.
- */
-#define MIN_GALLOP 7
-
-/* Avoid malloc for small temp arrays. */
-#define MERGESTATE_TEMP_SIZE 256
-
-/* One MergeState exists on the stack per invocation of mergesort.  It's just
- * a convenient way to pass state around among the helper functions.
- */
-struct s_slice {
-    PyObject **base;
-    Py_ssize_t len;
-};
-
-typedef struct s_MergeState {
-    /* The user-supplied comparison function. or NULL if none given. */
-    PyObject *compare;
-
-    /* This controls when we get *into* galloping mode.  It's initialized
-     * to MIN_GALLOP.  merge_lo and merge_hi tend to nudge it higher for
-     * random data, and lower for highly structured data.
-     */
-    Py_ssize_t min_gallop;
-
-    /* 'a' is temp storage to help with merges.  It contains room for
-     * alloced entries.
-     */
-    PyObject **a;       /* may point to temparray below */
-    Py_ssize_t alloced;
-
-    /* A stack of n pending runs yet to be merged.  Run #i starts at
-     * address base[i] and extends for len[i] elements.  It's always
-     * true (so long as the indices are in bounds) that
-     *
-     *     pending[i].base + pending[i].len == pending[i+1].base
-     *
-     * so we could cut the storage for this, but it's a minor amount,
-     * and keeping all the info explicit simplifies the code.
-     */
-    int n;
-    struct s_slice pending[MAX_MERGE_PENDING];
-
-    /* 'a' points to this when possible, rather than muck with malloc. */
-    PyObject *temparray[MERGESTATE_TEMP_SIZE];
-} MergeState;
-
 /* Conceptually a MergeState's constructor. */
 static void
 merge_init(MergeState *ms, PyObject *compare)
 {
     assert(ms != NULL);
     ms->compare = compare;
+    ms->lt = compare != NULL ? cmp_lt : safe_object_lt;
     ms->a = ms->temparray;
     ms->alloced = MERGESTATE_TEMP_SIZE;
     ms->n = 0;
@@ -1459,7 +1572,6 @@ merge_lo(MergeState *ms, PyObject **pa, Py_ssize_t na,
                          PyObject **pb, Py_ssize_t nb)
 {
     Py_ssize_t k;
-    PyObject *compare;
     PyObject **dest;
     int result = -1;            /* guilty until proved innocent */
     Py_ssize_t min_gallop;
@@ -1479,7 +1591,6 @@ merge_lo(MergeState *ms, PyObject **pa, Py_ssize_t na,
         goto CopyB;
 
     min_gallop = ms->min_gallop;
-    compare = ms->compare;
     for (;;) {
         Py_ssize_t acount = 0;          /* # of times A won in a row */
         Py_ssize_t bcount = 0;          /* # of times B won in a row */
@@ -1489,7 +1600,7 @@ merge_lo(MergeState *ms, PyObject **pa, Py_ssize_t na,
          */
         for (;;) {
             assert(na > 1 && nb > 0);
-            k = ISLT(*pb, *pa, compare);
+            k = ISLT(*pb, *pa);
             if (k) {
                 if (k < 0)
                     goto Fail;
@@ -1524,7 +1635,7 @@ merge_lo(MergeState *ms, PyObject **pa, Py_ssize_t na,
             assert(na > 1 && nb > 0);
             min_gallop -= min_gallop > 1;
             ms->min_gallop = min_gallop;
-            k = gallop_right(*pb, pa, na, 0, compare);
+            k = gallop_right(ms, *pb, pa, na, 0);
             acount = k;
             if (k) {
                 if (k < 0)
@@ -1547,7 +1658,7 @@ merge_lo(MergeState *ms, PyObject **pa, Py_ssize_t na,
             if (nb == 0)
                 goto Succeed;
 
-            k = gallop_left(*pa, pb, nb, 0, compare);
+            k = gallop_left(ms, *pa, pb, nb, 0);
             bcount = k;
             if (k) {
                 if (k < 0)
@@ -1591,7 +1702,6 @@ static Py_ssize_t
 merge_hi(MergeState *ms, PyObject **pa, Py_ssize_t na, PyObject **pb, Py_ssize_t nb)
 {
     Py_ssize_t k;
-    PyObject *compare;
     PyObject **dest;
     int result = -1;            /* guilty until proved innocent */
     PyObject **basea;
@@ -1616,7 +1726,6 @@ merge_hi(MergeState *ms, PyObject **pa, Py_ssize_t na, PyObject **pb, Py_ssize_t
         goto CopyA;
 
     min_gallop = ms->min_gallop;
-    compare = ms->compare;
     for (;;) {
         Py_ssize_t acount = 0;          /* # of times A won in a row */
         Py_ssize_t bcount = 0;          /* # of times B won in a row */
@@ -1626,7 +1735,7 @@ merge_hi(MergeState *ms, PyObject **pa, Py_ssize_t na, PyObject **pb, Py_ssize_t
          */
         for (;;) {
             assert(na > 0 && nb > 1);
-            k = ISLT(*pb, *pa, compare);
+            k = ISLT(*pb, *pa);
             if (k) {
                 if (k < 0)
                     goto Fail;
@@ -1661,7 +1770,7 @@ merge_hi(MergeState *ms, PyObject **pa, Py_ssize_t na, PyObject **pb, Py_ssize_t
             assert(na > 0 && nb > 1);
             min_gallop -= min_gallop > 1;
             ms->min_gallop = min_gallop;
-            k = gallop_right(*pb, basea, na, na-1, compare);
+            k = gallop_right(ms, *pb, basea, na, na-1);
             if (k < 0)
                 goto Fail;
             k = na - k;
@@ -1679,7 +1788,7 @@ merge_hi(MergeState *ms, PyObject **pa, Py_ssize_t na, PyObject **pb, Py_ssize_t
             if (nb == 1)
                 goto CopyA;
 
-            k = gallop_left(*pa, baseb, nb, nb-1, compare);
+            k = gallop_left(ms, *pa, baseb, nb, nb-1);
             if (k < 0)
                 goto Fail;
             k = nb - k;
@@ -1731,7 +1840,6 @@ merge_at(MergeState *ms, Py_ssize_t i)
     PyObject **pa, **pb;
     Py_ssize_t na, nb;
     Py_ssize_t k;
-    PyObject *compare;
 
     assert(ms != NULL);
     assert(ms->n >= 2);
@@ -1757,8 +1865,7 @@ merge_at(MergeState *ms, Py_ssize_t i)
     /* Where does b start in a?  Elements in a before that can be
      * ignored (already in place).
      */
-    compare = ms->compare;
-    k = gallop_right(*pb, pa, na, 0, compare);
+    k = gallop_right(ms, *pb, pa, na, 0);
     if (k < 0)
         return -1;
     pa += k;
@@ -1769,7 +1876,7 @@ merge_at(MergeState *ms, Py_ssize_t i)
     /* Where does a end in b?  Elements in b after that can be
      * ignored (already in place).
      */
-    nb = gallop_left(pa[na-1], pb, nb, nb-1, compare);
+    nb = gallop_left(ms, pa[na-1], pb, nb, nb-1);
     if (nb <= 0)
         return nb;
 
@@ -2034,6 +2141,78 @@ build_cmpwrapper(PyObject *cmpfunc)
     return (PyObject *)co;
 }
 
+/* Compare the keys of two sortwrappers */
+static int
+sortwrapper_lt(PyObject *x, PyObject *y, MergeState *ms)
+{
+    return (*ms->key_lt)(((sortwrapperobject *)x)->key,
+                         ((sortwrapperobject *)y)->key, ms);
+}
+
+/* Scan the n > 0 keys of items, which are sortwrappers if wrapped is true,
+ * and pick ms->key_lt.  If all keys are of one type, or all are non-empty
+ * tuples whose first items are, a comparison specialized for that type
+ * saves the dispatch of PyObject_RichCompareBool() at every step of the
+ * sort.  Keys can't change while sorting, so one scan is enough.
+ */
+static void
+merge_pick_lt(MergeState *ms, PyObject **items, Py_ssize_t n, int wrapped)
+{
+    PyObject *key;
+    PyTypeObject *key_type;
+    int keys_are_in_tuples, keys_are_all_same_type = 1;
+    int (*lt)(PyObject *, PyObject *, MergeState *);
+    Py_ssize_t i;
+
+    assert(n > 0);
+    key = wrapped ? ((sortwrapperobject *)items[0])->key : items[0];
+    keys_are_in_tuples = PyTuple_CheckExact(key) && Py_SIZE(key) > 0;
+    key_type = Py_TYPE(keys_are_in_tuples ? PyTuple_GET_ITEM(key, 0) : key);
+
+    for (i = 0; i < n; i++) {
+        key = wrapped ? ((sortwrapperobject *)items[i])->key : items[i];
+        if (keys_are_in_tuples) {
+            if (!PyTuple_CheckExact(key) || Py_SIZE(key) == 0) {
+                keys_are_in_tuples = 0;
+                keys_are_all_same_type = 0;
+                break;
+            }
+            key = PyTuple_GET_ITEM(key, 0);
+        }
+        if (Py_TYPE(key) != key_type) {
+            keys_are_all_same_type = 0;
+            /* Tuple keys are still worth checking to the end */
+            if (!keys_are_in_tuples)
+                break;
+        }
+    }
+
+    if (!keys_are_all_same_type)
+        lt = safe_object_lt;
+    else if (key_type == &PyString_Type)
+        lt = unsafe_string_lt;
+    else if (key_type == &PyInt_Type)
+        lt = unsafe_int_lt;
+    else if (key_type == &PyFloat_Type)
+        lt = unsafe_float_lt;
+    else if (key_type != &PyInstance_Type &&
+             PyType_HasFeature(key_type, Py_TPFLAGS_HAVE_RICHCOMPARE) &&
+             key_type->tp_richcompare != NULL) {
+        /* Classic instances of different classes share a type, and
+           PyObject_RichCompare() treats them apart */
+        ms->key_richcompare = key_type->tp_richcompare;
+        lt = unsafe_object_lt;
+    }
+    else
+        lt = safe_object_lt;
+
+    if (keys_are_in_tuples) {
+        ms->tuple_elem_lt = lt;
+        lt = unsafe_tuple_lt;
+    }
+    ms->key_lt = lt;
+}
+
 /* An adaptive, stable, natural mergesort.  See listsort.txt.
  * Returns Py_None on success, NULL on error.  Even in case of error, the
  * list will be some permutation of its input state (nothing is lost or
@@ -2122,6 +2301,11 @@ listsort(PyListObject *self, PyObject *args, PyObject *kwds)
     if (nremaining < 2)
         goto succeed;
 
+    if (compare == NULL) {
+        merge_pick_lt(&ms, saved_ob_item, saved_ob_size, keyfunc != NULL);
+        ms.lt = keyfunc != NULL ? sortwrapper_lt : ms.key_lt;
+    }
+
     /* March over the array once, left to right, finding natural runs,
      * and extending short natural runs to minrun elements.
      */
@@ -2133,7 +2317,7 @@ listsort(PyListObject *self, PyObject *args, PyObject *kwds)
         Py_ssize_t n;
 
         /* Identify next run. */
-        n = count_run(lo, hi, compare, &descending);
+        n = count_run(&ms, lo, hi, &descending);
         if (n < 0)
             goto fail;
         if (descending)
@@ -2142,7 +2326,7 @@ listsort(PyListObject *self, PyObject *args, PyObject *kwds)
         if (n < minrun) {
             const Py_ssize_t force = nremaining <= minrun ?
                               nremaining : minrun;
-            if (binarysort(lo, lo + force, lo + n, compare) < 0)
+            if (binarysort(&ms, lo, lo + force, lo + n) < 0)
                 goto fail;
             n = force;
         }
@@ -2511,9 +2695,9 @@ static PyMethodDef list_methods[] = {
     {"__reversed__",(PyCFunction)list_reversed, METH_NOARGS, reversed_doc},
     {"__sizeof__",  (PyCFunction)list_sizeof, METH_NOARGS, sizeof_doc},
     {"append",          (PyCFunction)listappend,  METH_O, append_doc},
-    {"insert",          (PyCFunction)listinsert,  METH_VARARGS, insert_doc},
+    {"insert",          (PyCFunction)listinsert,  METH_FASTCALL, insert_doc},
     {"extend",      (PyCFunction)listextend,  METH_O, extend_doc},
-    {"pop",             (PyCFunction)listpop,     METH_VARARGS, pop_doc},
+    {"pop",             (PyCFunction)listpop,     METH_FASTCALL, pop_doc},
     {"remove",          (PyCFunction)listremove,  METH_O, remove_doc},
     {"index",           (PyCFunction)listindex,   METH_VARARGS, index_doc},
     {"count",           (PyCFunction)listcount,   METH_O, count_doc},
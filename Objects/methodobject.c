@@ -67,6 +67,41 @@ PyCFunction_GetFlags(PyObject *op)
     return ((PyCFunctionObject *)op) -> m_ml -> ml_flags;
 }
 
+/* Call a METH_FASTCALL function with an argument tuple and a keyword
+   dict */
+static PyObject *
+fastcall_dict(PyObject *func, PyObject *arg, PyObject *kw)
+{
+    _PyCFunctionFast meth = (_PyCFunctionFast)PyCFunction_GET_FUNCTION(func);
+    PyObject *self = PyCFunction_GET_SELF(func);
+    Py_ssize_t nargs = PyTuple_GET_SIZE(arg);
+    Py_ssize_t nkw, i, pos;
+    PyObject **stack, *kwnames, *key, *value, *result;
+
+    if (kw == NULL || (nkw = PyDict_Size(kw)) == 0)
+        return (*meth)(self, &PyTuple_GET_ITEM(arg, 0), nargs, NULL);
+    kwnames = PyTuple_New(nkw);
+    if (kwnames == NULL)
+        return NULL;
+    stack = PyMem_New(PyObject *, nargs + nkw);
+    if (stack == NULL) {
+        Py_DECREF(kwnames);
+        return PyErr_NoMemory();
+    }
+    for (i = 0; i < nargs; i++)
+        stack[i] = PyTuple_GET_ITEM(arg, i);
+    i = pos = 0;
+    while (PyDict_Next(kw, &pos, &key, &value)) {
+        Py_INCREF(key);
+        PyTuple_SET_ITEM(kwnames, i, key);
+        stack[nargs + i++] = value;
+    }
+    result = (*meth)(self, stack, nargs, kwnames);
+    PyMem_Free(stack);
+    Py_DECREF(kwnames);
+    return result;
+}
+
 PyObject *
 PyCFunction_Call(PyObject *func, PyObject *arg, PyObject *kw)
 {
@@ -105,6 +140,8 @@ PyCFunction_Call(PyObject *func, PyObject *arg, PyObject *kw)
             return NULL;
         }
         break;
+    case METH_FASTCALL:
+        return fastcall_dict(func, arg, kw);
     case METH_OLDARGS:
         /* the really old style */
         if (kw == NULL || PyDict_Size(kw) == 0) {
@@ -1318,6 +1318,15 @@ _PyObject_NextNotImplemented(PyObject *self)
 
 /* Generic GetAttr functions - put these in your tp_[gs]etattro slot */
 
+/* The message of the AttributeError, built only when somebody looks at it */
+static PyObject *
+no_attribute_message(PyObject *tp, PyObject *name)
+{
+    return PyString_FromFormat("'%.50s' object has no attribute '%.400s'",
+                               ((PyTypeObject *)tp)->tp_name,
+                               PyString_AS_STRING(name));
+}
+
 PyObject *
 _PyObject_GenericGetAttrWithDict(PyObject *obj, PyObject *name, PyObject *dict)
 {
@@ -1442,9 +1451,8 @@ _PyObject_GenericGetAttrWithDict(PyObject *obj, PyObject *name, PyObject *dict)
         goto done;
     }
 
-    PyErr_Format(PyExc_AttributeError,
-                 "'%.50s' object has no attribute '%.400s'",
-                 tp->tp_name, PyString_AS_STRING(name));
+    _PyErr_SetDeferred(PyExc_AttributeError, no_attribute_message,
+                       (PyObject *)tp, name);
   done:
     Py_DECREF(name);
     return res;
@@ -2025,8 +2033,7 @@ static PyTypeObject PyNone_Type = {
 };
 
 PyObject _Py_NoneStruct = {
-  _PyObject_EXTRA_INIT
-  1, &PyNone_Type
+    PyObject_HEAD_IMMORTAL_INIT(&PyNone_Type)
 };
 
 /* NotImplemented is an object that can be used to signal that an
@@ -2056,8 +2063,7 @@ static PyTypeObject PyNotImplemented_Type = {
 };
 
 PyObject _Py_NotImplementedStruct = {
-    _PyObject_EXTRA_INIT
-    1, &PyNotImplemented_Type
+    PyObject_HEAD_IMMORTAL_INIT(&PyNotImplemented_Type)
 };
 
 void
@@ -2198,6 +2204,20 @@ _Py_ReadyTypes(void)
         Py_FatalError("Can't initialize file type");
 }
 
+void
+_Py_SetImmortal(PyObject *op)
+{
+#if Py_IMMORTAL_OBJECTS
+    if (op == NULL || _Py_IsImmortal(op))
+        return;
+#ifdef Py_REF_DEBUG
+    /* The references op holds now will never be given back */
+    _Py_RefTotal -= op->ob_refcnt;
+#endif
+    op->ob_refcnt = _Py_IMMORTAL_REFCNT;
+#endif
+}
+
 
 #ifdef Py_TRACE_REFS
 
@@ -2316,27 +2336,6 @@ PyTypeObject *_Py_cobject_hack = &PyCObject_Type;
 Py_ssize_t (*_Py_abstract_hack)(PyObject *) = PyObject_Size;
 
 
-/* Python's malloc wrappers (see pymem.h) */
-
-void *
-PyMem_Malloc(size_t nbytes)
-{
-    return PyMem_MALLOC(nbytes);
-}
-
-void *
-PyMem_Realloc(void *p, size_t nbytes)
-{
-    return PyMem_REALLOC(p, nbytes);
-}
-
-void
-PyMem_Free(void *p)
-{
-    PyMem_FREE(p);
-}
-
-
 /* These methods are used to control infinite recursion in repr, str, print,
    etc.  Container objects that may recursively contain themselves,
    e.g. builtin dictionaries and lists, should used Py_ReprEnter() and
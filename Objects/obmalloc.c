@@ -1,5 +1,33 @@
 #include "Python.h"
 
+#if Py_TRACEMALLOC
+/* The allocation tracer, see pymem.h.  PyMem_Malloc() and PyObject_Malloc()
+ * report to it, and so do the debug wrappers in a PYMALLOC_DEBUG build, in
+ * which PyMem_Malloc() itself goes through them.
+ */
+_PyMem_TracerHooks *_PyMem_Tracer = NULL;
+
+#define TRACE_ALLOC(p, n) do {                                  \
+        _PyMem_TracerHooks *t_ = _PyMem_Tracer;                 \
+        if (t_ != NULL && (p) != NULL)                          \
+            t_->alloc((p), (n));                                \
+    } while (0)
+#define TRACE_REALLOC(a, q, n) do {                             \
+        _PyMem_TracerHooks *t_ = _PyMem_Tracer;                 \
+        if (t_ != NULL && (q) != NULL)                          \
+            t_->realloc((a), (q), (n));                         \
+    } while (0)
+#define TRACE_FREE(p) do {                                      \
+        _PyMem_TracerHooks *t_ = _PyMem_Tracer;                 \
+        if (t_ != NULL && (p) != NULL)                          \
+            t_->free(p);                                        \
+    } while (0)
+#else
+#define TRACE_ALLOC(p, n)
+#define TRACE_REALLOC(a, q, n)
+#define TRACE_FREE(p)
+#endif
+
 #ifdef WITH_PYMALLOC
 
 #ifdef WITH_VALGRIND
@@ -180,11 +208,20 @@ static int running_on_valgrind = -1;
  * space are referenced subsequently. So malloc'ing big blocks and not using
  * them does not mean "wasting memory". It's an addressable range wastage...
  *
- * Therefore, allocating arenas with malloc is not optimal, because there is
- * some address space wastage, but this is the most portable way to request
- * memory from the system across various platforms.
+ * Where mmap() is available, arenas are mapped directly instead (see
+ * USE_MMAP_ARENAS below): the address space goes back to the system as
+ * soon as an arena is freed, and the pages of free pools can be given back
+ * while the rest of the arena is still in use.  malloc() remains the
+ * portable fallback.
+ *
+ * ARENA_SIZE can be set at compile time.  It must be a multiple of
+ * POOL_SIZE; with mmap(), a multiple of HUGE_PAGE_SIZE makes the arenas
+ * huge page aligned, so that the system can back them with (transparent)
+ * huge pages.
  */
+#ifndef ARENA_SIZE
 #define ARENA_SIZE              (256 << 10)     /* 256KB */
+#endif
 
 #ifdef WITH_MEMORY_LIMITS
 #define MAX_ARENAS              (SMALL_MEMORY_LIMIT / ARENA_SIZE)
@@ -197,6 +234,60 @@ static int running_on_valgrind = -1;
 #define POOL_SIZE               SYSTEM_PAGE_SIZE        /* must be 2^N */
 #define POOL_SIZE_MASK          SYSTEM_PAGE_SIZE_MASK
 
+#if ARENA_SIZE % POOL_SIZE != 0
+#error "ARENA_SIZE must be a multiple of POOL_SIZE"
+#endif
+
+/*
+ * Get arenas from mmap() rather than malloc().  Pools that become free in
+ * an arena that is still in use are then released with madvise() once the
+ * arena has more than MAX_CACHED_POOLS of them, keeping the
+ * KEEP_CACHED_POOLS most recently freed ones for quick reuse.  Huge page
+ * arenas are only ever released as a whole, since releasing a single pool
+ * would split the huge page.  Compile with -DARENA_HUGETLB to ask for
+ * explicit huge pages (MAP_HUGETLB) first.
+ */
+#ifndef USE_MMAP_ARENAS
+#if !defined(MS_WINDOWS) && (defined(__unix__) || defined(__APPLE__))
+#define USE_MMAP_ARENAS 1
+#else
+#define USE_MMAP_ARENAS 0
+#endif
+#endif
+
+#define HUGE_PAGE_SIZE          (2 << 20)       /* 2MB */
+
+#if USE_MMAP_ARENAS
+#include <sys/mman.h>
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#if ARENA_SIZE % HUGE_PAGE_SIZE == 0
+#define ARENA_HUGE_PAGES 1
+#else
+#define ARENA_HUGE_PAGES 0
+#endif
+#if !ARENA_HUGE_PAGES && defined(MADV_DONTNEED)
+#define USE_POOL_RELEASE 1
+#endif
+#else
+#define ARENA_HUGE_PAGES 0
+#endif
+
+#ifndef USE_POOL_RELEASE
+#define USE_POOL_RELEASE 0
+#endif
+
+#if USE_POOL_RELEASE
+#define MAX_CACHED_POOLS        8
+#define KEEP_CACHED_POOLS       4
+/* one bit per pool in arena_object.released */
+#define POOLS_IN_ARENA          (ARENA_SIZE / POOL_SIZE)
+#define POOLMAP_BITS            (8 * SIZEOF_LONG)
+#define POOLMAP_WORDS           ((POOLS_IN_ARENA + POOLMAP_BITS - 1) / \
+                                 POOLMAP_BITS)
+#endif
+
 /*
  * -- End of tunable settings section --
  */
@@ -284,6 +375,18 @@ struct arena_object {
     /* Singly-linked list of available pools. */
     struct pool_header* freepools;
 
+#if USE_POOL_RELEASE
+    /* The number of pools in freepools. */
+    uint ncachedpools;
+
+    /* Free pools whose pages were given back to the system.  Their
+     * headers are gone, so they are tracked by this bitmap rather than
+     * by a list; nfreepools counts them too.
+     */
+    uint nreleasedpools;
+    ulong released[POOLMAP_WORDS];
+#endif
+
     /* Whenever this arena_object is not associated with an allocated
      * arena, the nextarena member is used to link all unassociated
      * arena_objects in the singly-linked `unused_arena_objects` list.
@@ -308,6 +411,15 @@ struct arena_object {
 
 #define DUMMY_SIZE_IDX          0xffff  /* size class of newly cached pools */
 
+#if USE_POOL_RELEASE
+#define ARENA_RELEASED_POOLS(ao)        ((ao)->nreleasedpools)
+#define POOL_IS_RELEASED(ao, i) \
+    ((ao)->released[(i) / POOLMAP_BITS] & (1UL << ((i) % POOLMAP_BITS)))
+#else
+#define ARENA_RELEASED_POOLS(ao)        0
+#define POOL_IS_RELEASED(ao, i)         0
+#endif
+
 /* Round pointer P down to the closest pool-aligned address <= P, as a poolp */
 #define POOL_ADDR(P) ((poolp)((uptr)(P) & ~(uptr)POOL_SIZE_MASK))
 
@@ -508,11 +620,151 @@ static struct arena_object* usable_arenas = NULL;
 /* Number of arenas allocated that haven't been free()'d. */
 static size_t narenas_currently_allocated = 0;
 
-#ifdef PYMALLOC_DEBUG
 /* Total number of times malloc() called to allocate an arena. */
 static size_t ntimes_arena_allocated = 0;
 /* High water mark (max value ever seen) for narenas_currently_allocated. */
 static size_t narenas_highwater = 0;
+
+/* Counters for sys._mallocstats(), cheap enough to keep all the time:
+ * blocks handed out and given back per size class, pools set up for a
+ * size class and pools emptied, and the requests passed on to the
+ * system allocator with the bytes they asked for.
+ */
+static struct {
+    size_t nmalloc;
+    size_t nfree;
+} class_counts[NB_SMALL_SIZE_CLASSES];
+static size_t ntimes_pool_initialized = 0;
+static size_t ntimes_pool_emptied = 0;
+static size_t nsystem_mallocs = 0;
+static size_t nsystem_reallocs = 0;
+static size_t nsystem_frees = 0;
+static size_t nsystem_bytes = 0;
+
+#if USE_POOL_RELEASE
+/* Number of pools currently released, and ever released. */
+static size_t npools_released = 0;
+static size_t ntimes_pool_released = 0;
+/* Releasing a pool is only safe if it covers whole system pages. */
+static int pool_release_enabled = -1;
+#endif
+
+/* Get the memory for an arena from the system; NULL if there is none. */
+static void *
+arena_map(void)
+{
+#if USE_MMAP_ARENAS
+    void *p;
+#if ARENA_HUGE_PAGES
+    uptr head;
+
+#if defined(ARENA_HUGETLB) && defined(MAP_HUGETLB)
+    p = mmap(NULL, ARENA_SIZE, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED)
+        return p;
+    /* no huge pages reserved:  fall back to transparent huge pages */
+#endif
+    /* Map one huge page more than needed and trim the mapping so that
+     * the arena starts at a huge page boundary.
+     */
+    p = mmap(NULL, ARENA_SIZE + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+        return NULL;
+    head = (HUGE_PAGE_SIZE - ((uptr)p & (HUGE_PAGE_SIZE - 1))) &
+           (HUGE_PAGE_SIZE - 1);
+    if (head != 0)
+        munmap(p, head);
+    munmap((char *)p + head + ARENA_SIZE, HUGE_PAGE_SIZE - head);
+    p = (char *)p + head;
+#ifdef MADV_HUGEPAGE
+    (void)madvise(p, ARENA_SIZE, MADV_HUGEPAGE);
+#endif
+    return p;
+#else
+    p = mmap(NULL, ARENA_SIZE, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return p == MAP_FAILED ? NULL : p;
+#endif
+#else
+    return malloc(ARENA_SIZE);
+#endif
+}
+
+/* Give an arena back to the system. */
+static void
+arena_unmap(void *p)
+{
+#if USE_MMAP_ARENAS
+    munmap(p, ARENA_SIZE);
+#else
+    free(p);
+#endif
+}
+
+#if USE_POOL_RELEASE
+#define POOL_INDEX(ao, pool)  ((uint)(((uptr)(pool) - (ao)->address) / \
+                                      POOL_SIZE))
+
+/* Release the pages of the free pools of arena `ao` beyond the first
+ * KEEP_CACHED_POOLS (the most recently freed ones).
+ */
+static void
+release_pools(struct arena_object *ao)
+{
+    poolp pool = ao->freepools;
+    poolp next;
+    uint i;
+
+    if (pool_release_enabled < 0) {
+#ifdef HAVE_SYSCONF
+        pool_release_enabled = sysconf(_SC_PAGESIZE) == POOL_SIZE;
+#else
+        pool_release_enabled = getpagesize() == POOL_SIZE;
+#endif
+    }
+    if (!pool_release_enabled)
+        return;
+    for (i = 1; i < KEEP_CACHED_POOLS; i++)
+        pool = pool->nextpool;
+    next = pool->nextpool;
+    pool->nextpool = NULL;
+    ao->ncachedpools = KEEP_CACHED_POOLS;
+    while (next != NULL) {
+        pool = next;
+        next = pool->nextpool;
+        i = POOL_INDEX(ao, pool);
+        assert(!POOL_IS_RELEASED(ao, i));
+        ao->released[i / POOLMAP_BITS] |= 1UL << (i % POOLMAP_BITS);
+        ++ao->nreleasedpools;
+        ++npools_released;
+        ++ntimes_pool_released;
+        (void)madvise((void *)pool, POOL_SIZE, MADV_DONTNEED);
+    }
+}
+
+/* Take a released pool of arena `ao` back into use. */
+static poolp
+reuse_released_pool(struct arena_object *ao)
+{
+    poolp pool;
+    uint i, bit;
+
+    assert(ao->nreleasedpools > 0);
+    for (i = 0; ao->released[i] == 0; i++)
+        assert(i < POOLMAP_WORDS);
+    for (bit = 0; !(ao->released[i] & (1UL << bit)); bit++)
+        ;
+    ao->released[i] &= ~(1UL << bit);
+    --ao->nreleasedpools;
+    --npools_released;
+    pool = (poolp)(ao->address + (uptr)(i * POOLMAP_BITS + bit) * POOL_SIZE);
+    /* The header was lost with the pages, set it up like a new pool. */
+    pool->arenaindex = ao - arenas;
+    pool->szidx = DUMMY_SIZE_IDX;
+    return pool;
+}
 #endif
 
 /* Allocate a new arena.  If we run out of memory, return NULL.  Else
@@ -577,7 +829,7 @@ new_arena(void)
     arenaobj = unused_arena_objects;
     unused_arena_objects = arenaobj->nextarena;
     assert(arenaobj->address == 0);
-    arenaobj->address = (uptr)malloc(ARENA_SIZE);
+    arenaobj->address = (uptr)arena_map();
     if (arenaobj->address == 0) {
         /* The allocation failed: return NULL after putting the
          * arenaobj back.
@@ -588,12 +840,15 @@ new_arena(void)
     }
 
     ++narenas_currently_allocated;
-#ifdef PYMALLOC_DEBUG
     ++ntimes_arena_allocated;
     if (narenas_currently_allocated > narenas_highwater)
         narenas_highwater = narenas_currently_allocated;
-#endif
     arenaobj->freepools = NULL;
+#if USE_POOL_RELEASE
+    arenaobj->ncachedpools = 0;
+    arenaobj->nreleasedpools = 0;
+    memset(arenaobj->released, 0, sizeof(arenaobj->released));
+#endif
     /* pool_address <- first pool-aligned address in the arena
        nfreepools <- number of whole pools that fit after alignment */
     arenaobj->pool_address = (block*)arenaobj->address;
@@ -742,9 +997,8 @@ int Py_ADDRESS_IN_RANGE(void *P, poolp pool) Py_NO_INLINE;
  * Unless the optimizer reorders everything, being too smart...
  */
 
-#undef PyObject_Malloc
-void *
-PyObject_Malloc(size_t nbytes)
+Py_LOCAL_INLINE(void *)
+pymalloc_malloc(size_t nbytes)
 {
     block *bp;
     poolp pool;
@@ -776,6 +1030,7 @@ PyObject_Malloc(size_t nbytes)
          * Most frequent paths first
          */
         size = (uint)(nbytes - 1) >> ALIGNMENT_SHIFT;
+        ++class_counts[size].nmalloc;
         pool = usedpools[size + size];
         if (pool != pool->nextpool) {
             /*
@@ -817,12 +1072,14 @@ PyObject_Malloc(size_t nbytes)
             /* No arena has a free pool:  allocate a new arena. */
 #ifdef WITH_MEMORY_LIMITS
             if (narenas_currently_allocated >= MAX_ARENAS) {
+                --class_counts[size].nmalloc;
                 UNLOCK();
                 goto redirect;
             }
 #endif
             usable_arenas = new_arena();
             if (usable_arenas == NULL) {
+                --class_counts[size].nmalloc;
                 UNLOCK();
                 goto redirect;
             }
@@ -836,6 +1093,15 @@ PyObject_Malloc(size_t nbytes)
         if (pool != NULL) {
             /* Unlink from cached pools. */
             usable_arenas->freepools = pool->nextpool;
+#if USE_POOL_RELEASE
+            --usable_arenas->ncachedpools;
+        }
+        else if (usable_arenas->nreleasedpools > 0) {
+            /* Or one the system has taken back. */
+            pool = reuse_released_pool(usable_arenas);
+        }
+        if (pool != NULL) {
+#endif
 
             /* This arena already had the smallest nfreepools
              * value, so decreasing nfreepools doesn't change
@@ -848,6 +1114,7 @@ PyObject_Malloc(size_t nbytes)
             if (usable_arenas->nfreepools == 0) {
                 /* Wholly allocated:  remove. */
                 assert(usable_arenas->freepools == NULL);
+                assert(ARENA_RELEASED_POOLS(usable_arenas) == 0);
                 assert(usable_arenas->nextarena == NULL ||
                        usable_arenas->nextarena->prevarena ==
                        usable_arenas);
@@ -865,11 +1132,13 @@ PyObject_Malloc(size_t nbytes)
                  * time.
                  */
                 assert(usable_arenas->freepools != NULL ||
+                       ARENA_RELEASED_POOLS(usable_arenas) != 0 ||
                        usable_arenas->pool_address <=
                        (block*)usable_arenas->address +
                            ARENA_SIZE - POOL_SIZE);
             }
         init_pool:
+            ++ntimes_pool_initialized;
             /* Frontlink to used pools. */
             next = usedpools[size + size]; /* == prev */
             pool->nextpool = next;
@@ -906,6 +1175,7 @@ PyObject_Malloc(size_t nbytes)
         /* Carve off a new pool. */
         assert(usable_arenas->nfreepools > 0);
         assert(usable_arenas->freepools == NULL);
+        assert(ARENA_RELEASED_POOLS(usable_arenas) == 0);
         pool = (poolp)usable_arenas->pool_address;
         assert((block*)pool <= (block*)usable_arenas->address +
                                ARENA_SIZE - POOL_SIZE);
@@ -940,14 +1210,15 @@ redirect:
      */
     if (nbytes == 0)
         nbytes = 1;
+    ++nsystem_mallocs;
+    nsystem_bytes += nbytes;
     return (void *)malloc(nbytes);
 }
 
 /* free */
 
-#undef PyObject_Free
-void
-PyObject_Free(void *p)
+Py_LOCAL_INLINE(void)
+pymalloc_free(void *p)
 {
     poolp pool;
     block *lastfree;
@@ -969,6 +1240,7 @@ PyObject_Free(void *p)
     if (Py_ADDRESS_IN_RANGE(p, pool)) {
         /* We allocated this address. */
         LOCK();
+        ++class_counts[pool->szidx].nfree;
         /* Link p to the start of the pool's freeblock list.  Since
          * the pool had at least the p block outstanding, the pool
          * wasn't empty (so it's already in a usedpools[] list, or
@@ -995,6 +1267,7 @@ PyObject_Free(void *p)
              * previously freed pools will be allocated later
              * (being not referenced, they are perhaps paged out).
              */
+            ++ntimes_pool_emptied;
             next = pool->nextpool;
             prev = pool->prevpool;
             next->prevpool = prev;
@@ -1007,6 +1280,11 @@ PyObject_Free(void *p)
             pool->nextpool = ao->freepools;
             ao->freepools = pool;
             nf = ++ao->nfreepools;
+#if USE_POOL_RELEASE
+            if (++ao->ncachedpools > MAX_CACHED_POOLS &&
+                nf != ao->ntotalpools)
+                release_pools(ao);
+#endif
 
             /* All the rest is arena management.  We just freed
              * a pool, and there are 4 cases for arena mgmt:
@@ -1054,7 +1332,10 @@ PyObject_Free(void *p)
                 unused_arena_objects = ao;
 
                 /* Free the entire arena. */
-                free((void *)ao->address);
+#if USE_POOL_RELEASE
+                npools_released -= ao->nreleasedpools;
+#endif
+                arena_unmap((void *)ao->address);
                 ao->address = 0;                        /* mark unassociated */
                 --narenas_currently_allocated;
 
@@ -1163,6 +1444,7 @@ PyObject_Free(void *p)
 redirect:
 #endif
     /* We didn't allocate this address. */
+    ++nsystem_frees;
     free(p);
 }
 
@@ -1171,9 +1453,8 @@ redirect:
  * return a non-NULL result.
  */
 
-#undef PyObject_Realloc
-void *
-PyObject_Realloc(void *p, size_t nbytes)
+Py_LOCAL_INLINE(void *)
+pymalloc_realloc(void *p, size_t nbytes)
 {
     void *bp;
     poolp pool;
@@ -1183,7 +1464,7 @@ PyObject_Realloc(void *p, size_t nbytes)
 #endif
 
     if (p == NULL)
-        return PyObject_Malloc(nbytes);
+        return pymalloc_malloc(nbytes);
 
     /*
      * Limit ourselves to PY_SSIZE_T_MAX bytes to prevent security holes.
@@ -1220,10 +1501,10 @@ PyObject_Realloc(void *p, size_t nbytes)
             }
             size = nbytes;
         }
-        bp = PyObject_Malloc(nbytes);
+        bp = pymalloc_malloc(nbytes);
         if (bp != NULL) {
             memcpy(bp, p, size);
-            PyObject_Free(p);
+            pymalloc_free(p);
         }
         return bp;
     }
@@ -1240,6 +1521,8 @@ PyObject_Realloc(void *p, size_t nbytes)
      * a memory fault can occur if we try to copy nbytes bytes starting
      * at p.  Instead we punt:  let C continue to manage this block.
      */
+    ++nsystem_reallocs;
+    nsystem_bytes += nbytes;
     if (nbytes)
         return realloc(p, nbytes);
     /* C doesn't define the result of realloc(p, 0) (it may or may not
@@ -1252,6 +1535,113 @@ PyObject_Realloc(void *p, size_t nbytes)
     return bp ? bp : p;
 }
 
+/* The public entry points:  pymalloc plus the allocation tracer. */
+
+#undef PyObject_Malloc
+void *
+PyObject_Malloc(size_t nbytes)
+{
+    void *p = pymalloc_malloc(nbytes);
+    TRACE_ALLOC(p, nbytes);
+    return p;
+}
+
+#undef PyObject_Free
+void
+PyObject_Free(void *p)
+{
+    TRACE_FREE(p);
+    pymalloc_free(p);
+}
+
+#undef PyObject_Realloc
+void *
+PyObject_Realloc(void *p, size_t nbytes)
+{
+    Py_uintptr_t oldaddr = (Py_uintptr_t)p;
+    void *q = pymalloc_realloc(p, nbytes);
+    TRACE_REALLOC(oldaddr, q, nbytes);
+    return q;
+}
+
+/* Fill in `st` with the state of the arenas:  their virtual and
+ * (estimated) resident size, and the pools and blocks of each size class.
+ * Used by sys._arenastats().
+ */
+void
+_PyObject_GetArenaStats(_PyArenaStats *st)
+{
+    uint i, j;
+
+    memset(st, 0, sizeof(*st));
+    st->arena_size = ARENA_SIZE;
+    st->pool_size = POOL_SIZE;
+    st->mmap = USE_MMAP_ARENAS;
+    st->huge_pages = ARENA_HUGE_PAGES;
+    st->nclasses = NB_SMALL_SIZE_CLASSES;
+    for (i = 0; i < NB_SMALL_SIZE_CLASSES; ++i)
+        st->class_size[i] = INDEX2SIZE(i);
+#if USE_POOL_RELEASE
+    st->ntimes_pool_released = ntimes_pool_released;
+#endif
+    for (i = 0; i < maxarenas; ++i) {
+        struct arena_object *ao = &arenas[i];
+        uptr base = ao->address;
+
+        if (base == 0)
+            continue;
+        st->narenas++;
+        st->released_pools += ARENA_RELEASED_POOLS(ao);
+        if (base & (uptr)POOL_SIZE_MASK) {
+            base &= ~(uptr)POOL_SIZE_MASK;
+            base += POOL_SIZE;
+        }
+        st->untouched_pools += (ao->address + ARENA_SIZE -
+                                (uptr)ao->pool_address) / POOL_SIZE;
+        for (j = 0; base < (uptr)ao->pool_address; ++j, base += POOL_SIZE) {
+            poolp p = (poolp)base;
+            if (POOL_IS_RELEASED(ao, j))
+                continue;
+            if (p->ref.count == 0) {
+                st->cached_pools++;
+                continue;
+            }
+            st->class_pools[p->szidx]++;
+            st->class_blocks[p->szidx] += p->ref.count;
+        }
+    }
+}
+
+/* Fill in `st` from the counters kept by the allocator.  Unlike
+ * _PyObject_GetArenaStats() this doesn't walk the arenas, so it is cheap
+ * enough to be sampled often.  Used by sys._mallocstats().
+ */
+void
+_PyObject_GetMallocStats(_PyMallocStats *st)
+{
+    uint i;
+
+    memset(st, 0, sizeof(*st));
+    st->small_request_threshold = SMALL_REQUEST_THRESHOLD;
+    st->arena_size = ARENA_SIZE;
+    st->pool_size = POOL_SIZE;
+    st->narenas = narenas_currently_allocated;
+    st->narenas_allocated = ntimes_arena_allocated;
+    st->narenas_highwater = narenas_highwater;
+    st->npools_initialized = ntimes_pool_initialized;
+    st->npools_emptied = ntimes_pool_emptied;
+    st->system_mallocs = nsystem_mallocs;
+    st->system_reallocs = nsystem_reallocs;
+    st->system_frees = nsystem_frees;
+    st->system_bytes = nsystem_bytes;
+    st->nclasses = NB_SMALL_SIZE_CLASSES;
+    for (i = 0; i < NB_SMALL_SIZE_CLASSES; ++i) {
+        st->class_size[i] = INDEX2SIZE(i);
+        st->class_mallocs[i] = class_counts[i].nmalloc;
+        st->class_frees[i] = class_counts[i].nfree;
+    }
+}
+
 #else   /* ! WITH_PYMALLOC */
 
 /*==========================================================================*/
@@ -1442,7 +1832,7 @@ _PyObject_DebugMallocApi(char id, size_t nbytes)
         /* overflow:  can't represent total as a size_t */
         return NULL;
 
-    p = (uchar *)PyObject_Malloc(total);
+    p = (uchar *)pymalloc_malloc(total);
     if (p == NULL)
         return NULL;
 
@@ -1459,6 +1849,7 @@ _PyObject_DebugMallocApi(char id, size_t nbytes)
     memset(tail, FORBIDDENBYTE, SST);
     write_size_t(tail + SST, serialno);
 
+    TRACE_ALLOC(p + 2*SST, nbytes);
     return p + 2*SST;
 }
 
@@ -1476,11 +1867,12 @@ _PyObject_DebugFreeApi(char api, void *p)
     if (p == NULL)
         return;
     _PyObject_DebugCheckAddressApi(api, p);
+    TRACE_FREE(p);
     nbytes = read_size_t(q);
     nbytes += 4*SST;
     if (nbytes > 0)
         memset(q, DEADBYTE, nbytes);
-    PyObject_Free(q);
+    pymalloc_free(q);
 }
 
 void *
@@ -1512,7 +1904,7 @@ _PyObject_DebugReallocApi(char api, void *p, size_t nbytes)
      * case we didn't get the chance to mark the old memory with DEADBYTE,
      * but we live with that.
      */
-    q = (uchar *)PyObject_Realloc(q - 2*SST, total);
+    q = (uchar *)pymalloc_realloc(q - 2*SST, total);
     if (q == NULL)
         return NULL;
 
@@ -1531,6 +1923,7 @@ _PyObject_DebugReallocApi(char api, void *p, size_t nbytes)
                nbytes - original_nbytes);
     }
 
+    TRACE_REALLOC((Py_uintptr_t)p, q, nbytes);
     return q;
 }
 
@@ -1798,9 +2191,12 @@ _PyObject_DebugMallocStats(void)
                     base < (uptr) arenas[i].pool_address;
                     ++j, base += POOL_SIZE) {
             poolp p = (poolp)base;
-            const uint sz = p->szidx;
+            uint sz;
             uint freeblocks;
 
+            if (POOL_IS_RELEASED(&arenas[i], j))
+                continue;
+            sz = p->szidx;
             if (p->ref.count == 0) {
                 /* currently unused */
                 assert(pool_is_in_list(p, arenas[i].freepools));
@@ -1860,6 +2256,9 @@ _PyObject_DebugMallocStats(void)
     total = printone("# bytes in allocated blocks", allocated_bytes);
     total += printone("# bytes in available blocks", available_bytes);
 
+#if USE_POOL_RELEASE
+    (void)printone("# pools released to the system", npools_released);
+#endif
     PyOS_snprintf(buf, sizeof(buf),
         "%u unused pools * %d bytes", numfreepools, POOL_SIZE);
     total += printone(buf, (size_t)numfreepools * POOL_SIZE);
@@ -1872,6 +2271,181 @@ _PyObject_DebugMallocStats(void)
 
 #endif  /* PYMALLOC_DEBUG */
 
+/* Python's malloc wrappers (see pymem.h).  They live here rather than in
+ * object.c because pgen links this file alone, and with allocation tracing
+ * the PyMem_ macros expand to calls to them.
+ */
+
+#if Py_TRACEMALLOC && !defined(PYMALLOC_DEBUG)
+void *
+PyMem_Malloc(size_t nbytes)
+{
+    void *p;
+
+    if (nbytes > (size_t)PY_SSIZE_T_MAX)
+        return NULL;
+    p = malloc(nbytes ? nbytes : 1);
+    TRACE_ALLOC(p, nbytes);
+    return p;
+}
+
+void *
+PyMem_Realloc(void *p, size_t nbytes)
+{
+    /* volatile keeps gcc from moving the read of p past realloc() */
+    volatile Py_uintptr_t oldaddr = (Py_uintptr_t)p;
+    void *q;
+
+    if (nbytes > (size_t)PY_SSIZE_T_MAX)
+        return NULL;
+    q = realloc(p, nbytes ? nbytes : 1);
+    TRACE_REALLOC(oldaddr, q, nbytes);
+    return q;
+}
+
+void
+PyMem_Free(void *p)
+{
+    TRACE_FREE(p);
+    free(p);
+}
+
+#else
+
+void *
+PyMem_Malloc(size_t nbytes)
+{
+    return PyMem_MALLOC(nbytes);
+}
+
+void *
+PyMem_Realloc(void *p, size_t nbytes)
+{
+    return PyMem_REALLOC(p, nbytes);
+}
+
+void
+PyMem_Free(void *p)
+{
+    PyMem_FREE(p);
+}
+#endif
+
+/*==========================================================================*/
+/* Cache of freed hash tables, see pymem.h.
+ *
+ * One list per table size, so that dicts and sets growing through 32, 128,
+ * 512... slots and dying in a loop don't go through malloc and free for every
+ * resize.  Dict and set tables are a power of two entries of 24 or 16 bytes
+ * (12 or 8 on 32-bit boxes), so only sizes of 2**i and 3 * 2**(i-1) bytes are
+ * cached, each in its own list.  A cached table is linked through its first
+ * word; the resize code zeroes the table anyway before use.  Tables of less
+ * than 2**(PyMem_TABLECACHE_MAXLOG+1) bytes are cached, at most
+ * PyMem_TABLECACHE_MAXLIST of each size and PyMem_TABLECACHE_MAXBYTES in
+ * total.  Callers hold the GIL.
+ */
+#ifndef PyMem_TABLECACHE_MAXLOG
+#define PyMem_TABLECACHE_MAXLOG 16
+#endif
+#ifndef PyMem_TABLECACHE_MAXLIST
+#define PyMem_TABLECACHE_MAXLIST 16
+#endif
+#ifndef PyMem_TABLECACHE_MAXBYTES
+#define PyMem_TABLECACHE_MAXBYTES (2 << 20)
+#endif
+static void *table_cache[2 * (PyMem_TABLECACHE_MAXLOG + 1)];
+static int table_cache_len[2 * (PyMem_TABLECACHE_MAXLOG + 1)];
+static size_t table_cache_bytes = 0;
+static size_t table_cache_hits = 0;
+static size_t table_cache_misses = 0;
+static size_t table_cache_discards = 0;
+
+/* Return the list for tables of nbytes bytes, or -1 if they aren't
+   cached. */
+static int
+table_cache_index(size_t nbytes)
+{
+    int i = 0;
+
+    assert(nbytes >= sizeof(void *));
+    while (((size_t)2 << i) <= nbytes)
+        if (++i > PyMem_TABLECACHE_MAXLOG)
+            return -1;
+    if (nbytes == (size_t)1 << i)
+        return 2 * i;
+    if (i > 0 && nbytes == (size_t)3 << (i - 1))
+        return 2 * i + 1;
+    return -1;
+}
+
+void *
+_PyMem_TableAlloc(size_t nbytes)
+{
+    int i = table_cache_index(nbytes);
+    void *table;
+
+    if (i >= 0 && (table = table_cache[i]) != NULL) {
+        table_cache[i] = *(void **)table;
+        table_cache_len[i]--;
+        table_cache_bytes -= nbytes;
+        table_cache_hits++;
+        return table;
+    }
+    table_cache_misses++;
+    return PyMem_MALLOC(nbytes);
+}
+
+void
+_PyMem_TableFree(void *table, size_t nbytes)
+{
+    int i = table_cache_index(nbytes);
+
+    if (i >= 0 && table_cache_len[i] < PyMem_TABLECACHE_MAXLIST &&
+        table_cache_bytes + nbytes <= PyMem_TABLECACHE_MAXBYTES) {
+        *(void **)table = table_cache[i];
+        table_cache[i] = table;
+        table_cache_len[i]++;
+        table_cache_bytes += nbytes;
+        return;
+    }
+    if (i >= 0)
+        table_cache_discards++;
+    PyMem_FREE(table);
+}
+
+int
+_PyMem_ClearTableCache(void)
+{
+    int i, ret = 0;
+
+    for (i = 0; i < 2 * (PyMem_TABLECACHE_MAXLOG + 1); i++) {
+        while (table_cache[i] != NULL) {
+            void *table = table_cache[i];
+            table_cache[i] = *(void **)table;
+            PyMem_FREE(table);
+            ret++;
+        }
+        table_cache_len[i] = 0;
+    }
+    table_cache_bytes = 0;
+    return ret;
+}
+
+void
+_PyMem_GetTableCacheStats(_PyTableCacheStats *st)
+{
+    int i;
+
+    st->hits = table_cache_hits;
+    st->misses = table_cache_misses;
+    st->discards = table_cache_discards;
+    st->ntables = 0;
+    for (i = 0; i < 2 * (PyMem_TABLECACHE_MAXLOG + 1); i++)
+        st->ntables += table_cache_len[i];
+    st->nbytes = table_cache_bytes;
+    st->max_bytes = PyMem_TABLECACHE_MAXBYTES;
+}
+
 #ifdef Py_USING_MEMORY_DEBUGGER
 /* Make this function last so gcc won't inline it since the definition is
  * after the reference.
@@ -10,20 +10,6 @@
 #include "Python.h"
 #include "structmember.h"
 
-/* Set a key error with the specified argument, wrapping it in a
- * tuple automatically so that tuple keys are not unpacked as the
- * exception arguments. */
-static void
-set_key_error(PyObject *arg)
-{
-    PyObject *tup;
-    tup = PyTuple_Pack(1, arg);
-    if (!tup)
-        return; /* caller will expect error to be set anyway */
-    PyErr_SetObject(PyExc_KeyError, tup);
-    Py_DECREF(tup);
-}
-
 /* This must be >= 1. */
 #define PERTURB_SHIFT 5
 
@@ -274,7 +260,7 @@ actually be smaller than the old one.
 static int
 set_table_resize(PySetObject *so, Py_ssize_t minused)
 {
-    Py_ssize_t newsize;
+    Py_ssize_t newsize, oldsize;
     setentry *oldtable, *newtable, *entry;
     Py_ssize_t i;
     int is_oldtable_malloced;
@@ -317,7 +303,10 @@ set_table_resize(PySetObject *so, Py_ssize_t minused)
         }
     }
     else {
-        newtable = PyMem_NEW(setentry, newsize);
+        if ((size_t)newsize > PY_SSIZE_T_MAX / sizeof(setentry))
+            newtable = NULL;
+        else
+            newtable = _PyMem_TableAlloc(sizeof(setentry) * newsize);
         if (newtable == NULL) {
             PyErr_NoMemory();
             return -1;
@@ -326,6 +315,7 @@ set_table_resize(PySetObject *so, Py_ssize_t minused)
 
     /* Make the set empty, using the new table. */
     assert(newtable != oldtable);
+    oldsize = so->mask + 1;
     so->table = newtable;
     so->mask = newsize - 1;
     memset(newtable, 0, sizeof(setentry) * newsize);
@@ -352,7 +342,7 @@ set_table_resize(PySetObject *so, Py_ssize_t minused)
     }
 
     if (is_oldtable_malloced)
-        PyMem_DEL(oldtable);
+        _PyMem_TableFree(oldtable, sizeof(setentry) * oldsize);
     return 0;
 }
 
@@ -454,13 +444,13 @@ set_clear_internal(PySetObject *so)
 {
     setentry *entry, *table;
     int table_is_malloced;
-    Py_ssize_t fill;
+    Py_ssize_t fill, size = so->mask + 1;
     setentry small_copy[PySet_MINSIZE];
 #ifdef Py_DEBUG
     Py_ssize_t i, n;
     assert (PyAnySet_Check(so));
 
-    n = so->mask + 1;
+    n = size;
     i = 0;
 #endif
 
@@ -509,7 +499,7 @@ set_clear_internal(PySetObject *so)
     }
 
     if (table_is_malloced)
-        PyMem_DEL(table);
+        _PyMem_TableFree(table, sizeof(setentry) * size);
     return 0;
 }
 
@@ -565,7 +555,7 @@ set_dealloc(PySetObject *so)
         }
     }
     if (so->table != so->smalltable)
-        PyMem_DEL(so->table);
+        _PyMem_TableFree(so->table, sizeof(setentry) * (so->mask + 1));
     if (numfree < PySet_MAXFREELIST && PyAnySet_CheckExact(so))
         free_list[numfree++] = so;
     else
@@ -1068,22 +1058,32 @@ frozenset_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         Py_DECREF(result);
     }
     /* The empty frozenset is a singleton */
-    if (emptyfrozenset == NULL)
+    if (emptyfrozenset == NULL) {
         emptyfrozenset = make_new_set(type, NULL);
+        _Py_SetImmortal(emptyfrozenset);
+    }
     Py_XINCREF(emptyfrozenset);
     return emptyfrozenset;
 }
 
-void
-PySet_Fini(void)
+int
+PySet_ClearFreeList(void)
 {
     PySetObject *so;
+    int ret = numfree;
 
     while (numfree) {
         numfree--;
         so = free_list[numfree];
         PyObject_GC_Del(so);
     }
+    return ret;
+}
+
+void
+PySet_Fini(void)
+{
+    (void)PySet_ClearFreeList();
     Py_CLEAR(dummy);
     Py_CLEAR(emptyfrozenset);
 }
@@ -1911,7 +1911,7 @@ set_remove(PySetObject *so, PyObject *key)
     }
 
     if (rv == DISCARD_NOTFOUND) {
-        set_key_error(key);
+        _PyErr_SetKeyError(key);
         return NULL;
     }
     Py_RETURN_NONE;
@@ -46,8 +46,7 @@ PyTypeObject PyEllipsis_Type = {
 };
 
 PyObject _Py_EllipsisObject = {
-    _PyObject_EXTRA_INIT
-    1, &PyEllipsis_Type
+    PyObject_HEAD_IMMORTAL_INIT(&PyEllipsis_Type)
 };
 
 
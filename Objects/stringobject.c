@@ -103,12 +103,14 @@ PyString_FromStringAndSize(const char *str, Py_ssize_t size)
         op = (PyStringObject *)t;
         nullstring = op;
         Py_INCREF(op);
+        _Py_SetImmortal((PyObject *)op);
     } else if (size == 1 && str != NULL) {
         PyObject *t = (PyObject *)op;
         PyString_InternInPlace(&t);
         op = (PyStringObject *)t;
         characters[*str & UCHAR_MAX] = op;
         Py_INCREF(op);
+        _Py_SetImmortal((PyObject *)op);
     }
     return (PyObject *) op;
 }
@@ -156,12 +158,14 @@ PyString_FromString(const char *str)
         op = (PyStringObject *)t;
         nullstring = op;
         Py_INCREF(op);
+        _Py_SetImmortal((PyObject *)op);
     } else if (size == 1) {
         PyObject *t = (PyObject *)op;
         PyString_InternInPlace(&t);
         op = (PyStringObject *)t;
         characters[*str & UCHAR_MAX] = op;
         Py_INCREF(op);
+        _Py_SetImmortal((PyObject *)op);
     }
     return (PyObject *) op;
 }
@@ -1257,7 +1261,7 @@ _PyString_Eq(PyObject *o1, PyObject *o2)
       && memcmp(a->ob_sval, b->ob_sval, Py_SIZE(a)) == 0;
 }
 
-#ifdef TABULATION_MAIN
+#if defined(TABULATION_MAIN) && !defined(TABULATION_SEEDED)
 #ifdef TABLE2
 #include "randtable2.c"
 #else
@@ -1500,14 +1504,16 @@ whitespace string is a separator and empty strings are removed\n\
 from the result.");
 
 static PyObject *
-string_split(PyStringObject *self, PyObject *args)
+string_split(PyStringObject *self, PyObject **args,
+             Py_ssize_t nargs, PyObject *kwnames)
 {
     Py_ssize_t len = PyString_GET_SIZE(self), n;
     Py_ssize_t maxsplit = -1;
     const char *s = PyString_AS_STRING(self), *sub;
     PyObject *subobj = Py_None;
 
-    if (!PyArg_ParseTuple(args, "|On:split", &subobj, &maxsplit))
+    if (!_PyArg_NoStackKeywords("split", kwnames) ||
+        !_PyArg_ParseStack(args, nargs, "|On:split", &subobj, &maxsplit))
         return NULL;
     if (maxsplit < 0)
         maxsplit = PY_SSIZE_T_MAX;
@@ -2867,14 +2873,16 @@ old replaced by new.  If the optional argument count is\n\
 given, only the first count occurrences are replaced.");
 
 static PyObject *
-string_replace(PyStringObject *self, PyObject *args)
+string_replace(PyStringObject *self, PyObject **args,
+               Py_ssize_t nargs, PyObject *kwnames)
 {
     Py_ssize_t count = -1;
     PyObject *from, *to;
     const char *from_s, *to_s;
     Py_ssize_t from_len, to_len;
 
-    if (!PyArg_ParseTuple(args, "OO|n:replace", &from, &to, &count))
+    if (!_PyArg_NoStackKeywords("replace", kwnames) ||
+        !_PyArg_ParseStack(args, nargs, "OO|n:replace", &from, &to, &count))
         return NULL;
 
     if (PyString_Check(from)) {
@@ -3685,7 +3693,7 @@ string_methods[] = {
     /* Counterparts of the obsolete stropmodule functions; except
        string.maketrans(). */
     {"join", (PyCFunction)string_join, METH_O, join__doc__},
-    {"split", (PyCFunction)string_split, METH_VARARGS, split__doc__},
+    {"split", (PyCFunction)string_split, METH_FASTCALL, split__doc__},
     {"rsplit", (PyCFunction)string_rsplit, METH_VARARGS, rsplit__doc__},
     {"lower", (PyCFunction)string_lower, METH_NOARGS, lower__doc__},
     {"upper", (PyCFunction)string_upper, METH_NOARGS, upper__doc__},
@@ -3705,7 +3713,7 @@ string_methods[] = {
     {"find", (PyCFunction)string_find, METH_VARARGS, find__doc__},
     {"index", (PyCFunction)string_index, METH_VARARGS, index__doc__},
     {"lstrip", (PyCFunction)string_lstrip, METH_VARARGS, lstrip__doc__},
-    {"replace", (PyCFunction)string_replace, METH_VARARGS, replace__doc__},
+    {"replace", (PyCFunction)string_replace, METH_FASTCALL, replace__doc__},
     {"rfind", (PyCFunction)string_rfind, METH_VARARGS, rfind__doc__},
     {"rindex", (PyCFunction)string_rindex, METH_VARARGS, rindex__doc__},
     {"rstrip", (PyCFunction)string_rstrip, METH_VARARGS, rstrip__doc__},
@@ -4815,6 +4823,7 @@ PyString_InternImmortal(PyObject **p)
     if (PyString_CHECK_INTERNED(*p) != SSTATE_INTERNED_IMMORTAL) {
         PyString_CHECK_INTERNED(*p) = SSTATE_INTERNED_IMMORTAL;
         Py_INCREF(*p);
+        _Py_SetImmortal(*p);
     }
 }
 
@@ -4829,6 +4838,19 @@ PyString_InternFromString(const char *cp)
     return s;
 }
 
+/* Like PyString_InternFromString(), for the identifiers that C code keeps
+   in static variables:  those are never freed anyway, so make them
+   immortal. */
+PyObject *
+_PyString_InternImmortalFromString(const char *cp)
+{
+    PyObject *s = PyString_FromString(cp);
+    if (s == NULL)
+        return NULL;
+    PyString_InternImmortal(&s);
+    return s;
+}
+
 void
 PyString_Fini(void)
 {
@@ -4841,6 +4863,20 @@ PyString_Fini(void)
     nullstring = NULL;
 }
 
+/* Make all the interned strings immortal, for gc.freeze() */
+void
+_PyString_ImmortalizeInterned(void)
+{
+    PyObject *key, *value;
+    Py_ssize_t pos = 0;
+
+    if (interned == NULL)
+        return;
+    _Py_SetImmortal(interned);
+    while (PyDict_Next(interned, &pos, &key, &value))
+        _Py_SetImmortal(key);
+}
+
 void _Py_ReleaseInternedStrings(void)
 {
     PyObject *keys;
@@ -93,11 +93,13 @@ PyTuple_New(register Py_ssize_t size)
     }
     for (i=0; i < size; i++)
         op->ob_item[i] = NULL;
+    _PyTuple_FORGET_HASH(op);
 #if PyTuple_MAXSAVESIZE > 0
     if (size == 0) {
         free_list[0] = op;
         ++numfree[0];
         Py_INCREF(op);          /* extra INCREF so that this is never freed */
+        _Py_SetImmortal((PyObject *)op);
     }
 #endif
 #ifdef SHOW_TRACK_COUNT
@@ -151,6 +153,7 @@ PyTuple_SetItem(register PyObject *op, register Py_ssize_t i, PyObject *newitem)
     p = ((PyTupleObject *)op) -> ob_item + i;
     olditem = *p;
     *p = newitem;
+    _PyTuple_FORGET_HASH(op);
     Py_XDECREF(olditem);
     return 0;
 }
@@ -336,26 +339,69 @@ Done:
      1330111, 1412633, 1165069, 1247599, 1495177, 1577699
 */
 
+/* The hash of a tuple mixes the hashes of its items with the lane
+   function of xxHash (multiply, rotate, multiply), so that tuples of
+   small ints, whose item hashes are small and close together, spread
+   over all the bits instead of clustering in a few slots.
+
+   Tuples don't otherwise know whether their hash can change, so it is
+   only cached if every item is of a type whose hash is fixed for the
+   life of the object.  The cache is the slot after the last item, which
+   tp_basicsize makes room for; NULL there (as tp_alloc leaves it) means
+   no hash is cached, so a hash of 0 is never cached.
+*/
+#if SIZEOF_LONG > 4
+#define XXPRIME_1 0x9E3779B185EBCA87UL
+#define XXPRIME_2 0xC2B2AE3D27D4EB4FUL
+#define XXPRIME_5 0x27D4EB2F165667C5UL
+#define XXROTATE(x) (((x) << 31) | ((x) >> 33))
+#else
+#define XXPRIME_1 2654435761UL
+#define XXPRIME_2 2246822519UL
+#define XXPRIME_5 374761393UL
+#define XXROTATE(x) (((x) << 13) | ((x) >> 19))
+#endif
+
+#define CACHED_HASH(op) (((PyTupleObject *)(op))->ob_item[Py_SIZE(op)])
+
+#define HAS_STABLE_HASH(op) \
+    (PyString_CheckExact(op) || PyInt_CheckExact(op) || \
+     PyLong_CheckExact(op) || PyFloat_CheckExact(op) || \
+     (op) == Py_None || PyBool_Check(op) || PyUnicode_CheckExact(op) || \
+     PyComplex_CheckExact(op) || PyFrozenSet_CheckExact(op) || \
+     (PyTuple_CheckExact(op) && CACHED_HASH(op) != NULL))
+
 static long
 tuplehash(PyTupleObject *v)
 {
-    register long x, y;
-    register Py_ssize_t len = Py_SIZE(v);
-    register PyObject **p;
-    long mult = 1000003L;
-    x = 0x345678L;
-    p = v->ob_item;
-    while (--len >= 0) {
-        y = PyObject_Hash(*p++);
-        if (y == -1)
+    register unsigned long acc, lane;
+    register Py_ssize_t i, len = Py_SIZE(v);
+    register PyObject *item;
+    int stable = 1;
+    long x;
+
+    if (CACHED_HASH(v) != NULL)
+        return (long)(Py_intptr_t)CACHED_HASH(v);
+    acc = XXPRIME_5;
+    for (i = 0; i < len; i++) {
+        item = v->ob_item[i];
+        x = PyObject_Hash(item);
+        if (x == -1)
             return -1;
-        x = (x ^ y) * mult;
-        /* the cast might truncate len; that doesn't change hash stability */
-        mult += (long)(82520L + len + len);
+        if (stable && !HAS_STABLE_HASH(item))
+            stable = 0;
+        lane = (unsigned long)x;
+        acc += lane * XXPRIME_2;
+        acc = XXROTATE(acc);
+        acc *= XXPRIME_1;
     }
-    x += 97531L;
+    /* Add the length so that () and (x,) with hash(x) == 0 differ */
+    acc += (unsigned long)len ^ (XXPRIME_5 ^ 3527539UL);
+    x = (long)acc;
     if (x == -1)
-        x = -2;
+        x = 1546275796;
+    if (stable && x != 0)
+        CACHED_HASH(v) = (PyObject *)(Py_intptr_t)x;
     return x;
 }
 
@@ -796,7 +842,7 @@ static PyObject *tuple_iter(PyObject *seq);
 PyTypeObject PyTuple_Type = {
     PyVarObject_HEAD_INIT(&PyType_Type, 0)
     "tuple",
-    sizeof(PyTupleObject) - sizeof(PyObject *),
+    sizeof(PyTupleObject),          /* one item slot holds the hash */
     sizeof(PyObject *),
     (destructor)tupledealloc,                   /* tp_dealloc */
     (printfunc)tupleprint,                      /* tp_print */
@@ -889,10 +935,11 @@ _PyTuple_Resize(PyObject **pv, Py_ssize_t newsize)
         return -1;
     }
     _Py_NewReference((PyObject *) sv);
-    /* Zero out items added by growing */
+    /* Zero out items added by growing, and the cached hash */
     if (newsize > oldsize)
         memset(&sv->ob_item[oldsize], 0,
                sizeof(*sv->ob_item) * (newsize - oldsize));
+    _PyTuple_FORGET_HASH(sv);
     *pv = (PyObject *) sv;
     _PyObject_GC_TRACK(sv);
     return 0;
@@ -33,6 +33,12 @@ struct method_cache_entry {
 static struct method_cache_entry method_cache[1 << MCACHE_SIZE_EXP];
 static unsigned int next_version_tag = 0;
 
+/* Incremented whenever version tags start over from 0, so that caches
+   keyed by tp_version_tag outside of this file (the LOAD_ATTR and
+   STORE_ATTR caches in ceval.c) can tell a reused tag from the one
+   they recorded. */
+unsigned int _PyType_VersionTagEpoch = 0;
+
 unsigned int
 PyType_ClearCache(void)
 {
@@ -45,6 +51,7 @@ PyType_ClearCache(void)
         method_cache[i].value = NULL;
     }
     next_version_tag = 0;
+    _PyType_VersionTagEpoch++;
     /* mark all version tags as invalid */
     PyType_Modified(&PyBaseObject_Type);
     return cur_version_tag;
@@ -170,6 +177,7 @@ assign_version_tag(PyTypeObject *type)
             method_cache[i].name = Py_None;
             Py_INCREF(Py_None);
         }
+        _PyType_VersionTagEpoch++;
         /* mark all version tags as invalid */
         PyType_Modified(&PyBaseObject_Type);
         return 1;
@@ -186,6 +194,14 @@ assign_version_tag(PyTypeObject *type)
     return 1;
 }
 
+/* Give the type a valid tp_version_tag if it doesn't have one yet, for
+   caches outside of this file.  Returns 1 if the tag is valid. */
+int
+_PyType_AssignVersionTag(PyTypeObject *type)
+{
+    return assign_version_tag(type) &&
+        PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG);
+}
 
 static PyMemberDef type_members[] = {
     {"__basicsize__", T_PYSSIZET, offsetof(PyTypeObject,tp_basicsize),READONLY},
@@ -1179,7 +1195,7 @@ lookup_maybe(PyObject *self, char *attrstr, PyObject **attrobj)
     PyObject *res;
 
     if (*attrobj == NULL) {
-        *attrobj = PyString_InternFromString(attrstr);
+        *attrobj = _PyString_InternImmortalFromString(attrstr);
         if (*attrobj == NULL)
             return NULL;
     }
@@ -1799,7 +1815,7 @@ get_dict_descriptor(PyTypeObject *type)
     PyObject *descr;
 
     if (dict_str == NULL) {
-        dict_str = PyString_InternFromString("__dict__");
+        dict_str = _PyString_InternImmortalFromString("__dict__");
         if (dict_str == NULL)
             return NULL;
     }
@@ -2516,6 +2532,14 @@ _PyType_Lookup(PyTypeObject *type, PyObject *name)
     return res;
 }
 
+static PyObject *
+no_attribute_message(PyObject *type, PyObject *name)
+{
+    return PyString_FromFormat("type object '%.50s' has no attribute '%.400s'",
+                               ((PyTypeObject *)type)->tp_name,
+                               PyString_AS_STRING(name));
+}
+
 /* This is similar to PyObject_GenericGetAttr(),
    but uses _PyType_Lookup() instead of just looking in type->tp_dict. */
 static PyObject *
@@ -2587,9 +2611,8 @@ type_getattro(PyTypeObject *type, PyObject *name)
     }
 
     /* Give up */
-    PyErr_Format(PyExc_AttributeError,
-                     "type object '%.50s' has no attribute '%.400s'",
-                     type->tp_name, PyString_AS_STRING(name));
+    _PyErr_SetDeferred(PyExc_AttributeError, no_attribute_message,
+                       (PyObject *)type, name);
     return NULL;
 }
 
@@ -2916,7 +2939,7 @@ object_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         if (sorted_methods == NULL)
             goto error;
         if (comma == NULL) {
-            comma = PyString_InternFromString(", ");
+            comma = _PyString_InternImmortalFromString(", ");
             if (comma == NULL)
                 goto error;
         }
@@ -3128,7 +3151,7 @@ import_copyreg(void)
     static PyObject *copyreg_str;
 
     if (!copyreg_str) {
-        copyreg_str = PyString_InternFromString("copy_reg");
+        copyreg_str = _PyString_InternImmortalFromString("copy_reg");
         if (copyreg_str == NULL)
             return NULL;
     }
@@ -4938,7 +4961,7 @@ slot_sq_item(PyObject *self, Py_ssize_t i)
     descrgetfunc f;
 
     if (getitem_str == NULL) {
-        getitem_str = PyString_InternFromString("__getitem__");
+        getitem_str = _PyString_InternImmortalFromString("__getitem__");
         if (getitem_str == NULL)
             return NULL;
     }
@@ -5452,13 +5475,13 @@ slot_tp_getattr_hook(PyObject *self, PyObject *name)
     static PyObject *getattr_str = NULL;
 
     if (getattr_str == NULL) {
-        getattr_str = PyString_InternFromString("__getattr__");
+        getattr_str = _PyString_InternImmortalFromString("__getattr__");
         if (getattr_str == NULL)
             return NULL;
     }
     if (getattribute_str == NULL) {
         getattribute_str =
-            PyString_InternFromString("__getattribute__");
+            _PyString_InternImmortalFromString("__getattribute__");
         if (getattribute_str == NULL)
             return NULL;
     }
@@ -5614,7 +5637,7 @@ slot_tp_descr_get(PyObject *self, PyObject *obj, PyObject *type)
     static PyObject *get_str = NULL;
 
     if (get_str == NULL) {
-        get_str = PyString_InternFromString("__get__");
+        get_str = _PyString_InternImmortalFromString("__get__");
         if (get_str == NULL)
             return NULL;
     }
@@ -5684,7 +5707,7 @@ slot_tp_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_ssize_t i, n;
 
     if (new_str == NULL) {
-        new_str = PyString_InternFromString("__new__");
+        new_str = _PyString_InternImmortalFromString("__new__");
         if (new_str == NULL)
             return NULL;
     }
@@ -6225,7 +6248,7 @@ init_slotdefs(void)
     if (initialized)
         return;
     for (p = slotdefs; p->name; p++) {
-        p->name_strobj = PyString_InternFromString(p->name);
+        p->name_strobj = _PyString_InternImmortalFromString(p->name);
         if (!p->name_strobj)
             Py_FatalError("Out of memory interning slotdef names");
     }
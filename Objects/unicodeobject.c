@@ -463,6 +463,7 @@ PyObject *PyUnicode_FromUnicode(const Py_UNICODE *u,
                     return NULL;
                 unicode->str[0] = *u;
                 unicode_latin1[*u] = unicode;
+                _Py_SetImmortal((PyObject *)unicode);
             }
             Py_INCREF(unicode);
             return (PyObject *)unicode;
@@ -512,6 +513,7 @@ PyObject *PyUnicode_FromStringAndSize(const char *u, Py_ssize_t size)
                     return NULL;
                 unicode->str[0] = Py_CHARMASK(*u);
                 unicode_latin1[Py_CHARMASK(*u)] = unicode;
+                _Py_SetImmortal((PyObject *)unicode);
             }
             Py_INCREF(unicode);
             return (PyObject *)unicode;
@@ -8883,6 +8885,7 @@ void _PyUnicode_Init(void)
     unicode_empty = _PyUnicode_New(0);
     if (!unicode_empty)
         return;
+    _Py_SetImmortal((PyObject *)unicode_empty);
 
     strcpy(unicode_default_encoding, "ascii");
     for (i = 0; i < 256; i++)
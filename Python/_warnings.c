@@ -706,11 +706,19 @@ warnings_warn_explicit(PyObject *self, PyObject *args, PyObject *kwds)
 
 
 /* Function to issue a warning message; may raise an exception. */
+/* Number of warnings issued from C, whatever the filters did with them.
+   The code cache in pythonrun.c uses it to tell whether compiling some
+   source warned. */
+long _PyErr_WarnCount = 0;
+
 int
 PyErr_WarnEx(PyObject *category, const char *text, Py_ssize_t stack_level)
 {
     PyObject *res;
-    PyObject *message = PyString_FromString(text);
+    PyObject *message;
+
+    _PyErr_WarnCount++;
+    message = PyString_FromString(text);
     if (message == NULL)
         return -1;
 
@@ -749,6 +757,7 @@ PyErr_WarnExplicit(PyObject *category, const char *text,
     PyObject *module = NULL;
     int ret = -1;
 
+    _PyErr_WarnCount++;
     if (message == NULL || filename == NULL)
         goto exit;
     if (module_str != NULL) {
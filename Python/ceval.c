@@ -96,6 +96,35 @@ void dump_tsc(int opcode, int ticked, uint64 inst0, uint64 inst1,
 /* Turn this on if your compiler chokes on the big switch: */
 /* #define CASE_TOO_BIG 1 */
 
+/* Computed GOTOs, or
+       the-optimization-commonly-but-improperly-known-as-"threaded code"
+   using gcc's labels-as-values extension
+   (http://gcc.gnu.org/onlinedocs/gcc/Labels-as-Values.html).
+
+   The traditional bytecode evaluation loop uses a "switch" statement,
+   which decent compilers will optimize as a single indirect branch
+   instruction combined with a lookup table of jump addresses.  All
+   opcodes then share that one indirect branch, so the CPU's branch
+   predictor has little to go on.  With computed gotos every opcode
+   ends with its own indirect jump through opcode_targets[] (generated
+   from Lib/opcode.py by Python/makeopcodetargets.py), which the
+   predictor can learn per opcode.
+
+   Enabled by default with gcc and clang; build with
+   EXTRA_CFLAGS=-DUSE_COMPUTED_GOTOS=0 to get the switch back.  The
+   dynamic execution profile counts opcodes in the switch, so it
+   always uses the switch. */
+#ifndef USE_COMPUTED_GOTOS
+#if defined(__GNUC__) && !defined(DYNAMIC_EXECUTION_PROFILE)
+#define USE_COMPUTED_GOTOS 1
+#else
+#define USE_COMPUTED_GOTOS 0
+#endif
+#endif
+#if USE_COMPUTED_GOTOS && defined(DYNAMIC_EXECUTION_PROFILE)
+#error "Computed gotos are not compatible with DYNAMIC_EXECUTION_PROFILE"
+#endif
+
 #ifdef Py_DEBUG
 /* For debugging the interpreter: */
 #define LLTRACE  1      /* Low-level trace feature */
@@ -110,6 +139,7 @@ static PyObject * call_function(PyObject ***, int, uint64*, uint64*);
 #else
 static PyObject * call_function(PyObject ***, int);
 #endif
+static PyObject * fast_cfunction(PyObject *, PyObject **, int, int);
 static PyObject * fast_function(PyObject *, PyObject ***, int, int, int);
 static PyObject * do_call(PyObject *, PyObject ***, int, int);
 static PyObject * ext_do_call(PyObject *, PyObject ***, int, int, int);
@@ -169,6 +199,33 @@ static long dxp[256];
 #endif
 #endif
 
+/* Runtime opcode profile, switched on and off with sys.setopcodeprofile().
+   Counts every executed opcode, every pair of consecutive opcodes in a
+   frame and, in co_opcounts, every executed instruction offset of each
+   code object.  The code objects that have counters are kept alive in
+   profiled_codes until the profile is reset. */
+static int _Py_OpcodeProfiling = 0;
+static unsigned long opcode_counts[256];
+static unsigned long opcode_pairs[256][256];
+static PyObject *profiled_codes = NULL;
+
+static void profile_opcode(PyCodeObject *, int, int, int);
+
+/* Inline caches for LOAD_ATTR and STORE_ATTR.  Each of these
+   instructions in a code object gets a PyAttrCacheEntry (see code.h)
+   in co_attrcache, allocated the first time one of them runs.  The
+   entry records, for the type of the last object seen there, whether
+   PyObject_GenericGetAttr() or PyObject_GenericSetAttr() found the
+   attribute as a data descriptor, a __slots__ member, a method (any
+   other attribute of the type) or an entry of the instance dict, and
+   for the latter the slot of ma_table that held it.  While the type
+   keeps its tp_version_tag the next execution goes there directly,
+   without _PyType_Lookup() and, on a hit, without hashing and probing
+   the instance dict. */
+static PyObject * load_attr(PyCodeObject *, int, PyObject *, PyObject *);
+static int store_attr(PyCodeObject *, int, PyObject *, PyObject *,
+                      PyObject *);
+
 /* Function call profile */
 #ifdef CALL_PROFILE
 #define PCALL_NUM 11
@@ -233,36 +290,40 @@ PyEval_GetCallStats(PyObject *self)
 #endif
 #include "pythread.h"
 
-static PyThread_type_lock interpreter_lock = 0; /* This is the GIL */
 static PyThread_type_lock pending_lock = 0; /* for pending calls */
 static long main_thread = 0;
 
+#include "ceval_gil.h"
+
 int
 PyEval_ThreadsInitialized(void)
 {
-    return interpreter_lock != 0;
+    return gil_created();
 }
 
 void
 PyEval_InitThreads(void)
 {
-    if (interpreter_lock)
+    if (gil_created())
         return;
-    interpreter_lock = PyThread_allocate_lock();
-    PyThread_acquire_lock(interpreter_lock, 1);
+    create_gil();
+    take_gil(PyThreadState_GET(), 0);
     main_thread = PyThread_get_thread_ident();
 }
 
 void
 PyEval_AcquireLock(void)
 {
-    PyThread_acquire_lock(interpreter_lock, 1);
+    take_gil(_PyThreadState_Current, 0);
 }
 
 void
 PyEval_ReleaseLock(void)
 {
-    PyThread_release_lock(interpreter_lock);
+    /* This function must succeed when the current thread state is NULL,
+       so don't use PyThreadState_GET(), which is a fatal error in debug
+       builds then. */
+    drop_gil(_PyThreadState_Current);
 }
 
 void
@@ -271,8 +332,8 @@ PyEval_AcquireThread(PyThreadState *tstate)
     if (tstate == NULL)
         Py_FatalError("PyEval_AcquireThread: NULL new thread state");
     /* Check someone has called PyEval_InitThreads() to create the lock */
-    assert(interpreter_lock);
-    PyThread_acquire_lock(interpreter_lock, 1);
+    assert(gil_created());
+    take_gil(tstate, 0);
     if (PyThreadState_Swap(tstate) != NULL)
         Py_FatalError(
             "PyEval_AcquireThread: non-NULL old thread state");
@@ -285,7 +346,7 @@ PyEval_ReleaseThread(PyThreadState *tstate)
         Py_FatalError("PyEval_ReleaseThread: NULL thread state");
     if (PyThreadState_Swap(NULL) != tstate)
         Py_FatalError("PyEval_ReleaseThread: wrong thread state");
-    PyThread_release_lock(interpreter_lock);
+    drop_gil(tstate);
 }
 
 /* This function is called from PyOS_AfterFork to ensure that newly
@@ -299,20 +360,16 @@ PyEval_ReInitThreads(void)
     PyObject *threading, *result;
     PyThreadState *tstate;
 
-    if (!interpreter_lock)
+    if (!gil_created())
         return;
-    /*XXX Can't use PyThread_free_lock here because it does too
-      much error-checking.  Doing this cleanly would require
-      adding a new function to each thread_*.h.  Instead, just
-      create a new lock and waste a little bit of memory */
-    interpreter_lock = PyThread_allocate_lock();
+    recreate_gil();
     pending_lock = PyThread_allocate_lock();
-    PyThread_acquire_lock(interpreter_lock, 1);
+    tstate = PyThreadState_GET();
+    take_gil(tstate, 0);
     main_thread = PyThread_get_thread_ident();
 
     /* Update the threading module with the new state.
      */
-    tstate = PyThreadState_GET();
     threading = PyMapping_GetItemString(tstate->interp->modules,
                                         "threading");
     if (threading == NULL) {
@@ -327,6 +384,21 @@ PyEval_ReInitThreads(void)
         Py_DECREF(result);
     Py_DECREF(threading);
 }
+
+/* Defined here because they use the static globals of ceval_gil.h */
+PyObject *
+_Py_GetGILStats(PyObject *self, PyObject *args)
+{
+    PyObject *result;
+    int reset = 0;
+
+    if (!PyArg_ParseTuple(args, "|i:getgilstats", &reset))
+        return NULL;
+    result = get_gil_stats();
+    if (result != NULL && reset)
+        reset_gil_stats();
+    return result;
+}
 #endif
 
 /* Functions save_thread and restore_thread are always defined so
@@ -340,8 +412,8 @@ PyEval_SaveThread(void)
     if (tstate == NULL)
         Py_FatalError("PyEval_SaveThread: NULL tstate");
 #ifdef WITH_THREAD
-    if (interpreter_lock)
-        PyThread_release_lock(interpreter_lock);
+    if (gil_created())
+        drop_gil(tstate);
 #endif
     return tstate;
 }
@@ -352,11 +424,8 @@ PyEval_RestoreThread(PyThreadState *tstate)
     if (tstate == NULL)
         Py_FatalError("PyEval_RestoreThread: NULL tstate");
 #ifdef WITH_THREAD
-    if (interpreter_lock) {
-        int err = errno;
-        PyThread_acquire_lock(interpreter_lock, 1);
-        errno = err;
-    }
+    if (gil_created())
+        take_gil(tstate, 1);
 #endif
     PyThreadState_Swap(tstate);
 }
@@ -692,6 +761,7 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
     register PyObject **stack_pointer;  /* Next free slot in value stack */
     register unsigned char *next_instr;
     register int opcode;        /* Current opcode */
+    int lastop = -1;            /* Previous opcode, for the opcode profile */
     register int oparg;         /* Current opcode argument, if any */
     register enum why_code why; /* Reason for block stack unwind */
     register int err;           /* Error status -- nonzero if error */
@@ -781,6 +851,132 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
 #define JUMPTO(x)       (next_instr = first_instr + (x))
 #define JUMPBY(x)       (next_instr += (x))
 
+/* Opcode dispatch macros
+
+   Every opcode starts with TARGET(op).  Opcodes that share a body
+   (SLICE+0..3, SETUP_LOOP/EXCEPT/FINALLY, ...) use TARGET_WITH_IMPL and
+   jump to a label in front of that body, so that each one still sets
+   its own opcode and fetches its own argument.
+
+   An opcode that is done continues with DISPATCH(), which runs the
+   periodic checks at the top of the loop every _Py_CheckInterval
+   instructions.  FAST_DISPATCH() skips them, like the old
+   "goto fast_next_opcode".  With computed gotos both jump straight
+   to the next opcode unless tracing is possible or the opcode profile
+   is on, in which case they go through fast_next_opcode and the
+   switch. */
+
+#if USE_COMPUTED_GOTOS
+/* Import the static jump table */
+#include "opcode_targets.h"
+
+#define TARGET(op) \
+        TARGET_##op: \
+        opcode = op; \
+        if (HAS_ARG(op)) \
+            oparg = NEXTARG(); \
+        case op:
+
+#define TARGET_WITH_IMPL(op, impl) \
+        TARGET_##op: \
+        opcode = op; \
+        if (HAS_ARG(op)) \
+            oparg = NEXTARG(); \
+        case op: \
+        goto impl;
+
+#ifdef LLTRACE
+#define FAST_DISPATCH() \
+    { \
+        if (!lltrace && !(_Py_TracingPossible | _Py_OpcodeProfiling)) { \
+            f->f_lasti = INSTR_OFFSET(); \
+            goto *opcode_targets[*next_instr++]; \
+        } \
+        goto fast_next_opcode; \
+    }
+#else
+#define FAST_DISPATCH() \
+    { \
+        if (!(_Py_TracingPossible | _Py_OpcodeProfiling)) { \
+            f->f_lasti = INSTR_OFFSET(); \
+            goto *opcode_targets[*next_instr++]; \
+        } \
+        goto fast_next_opcode; \
+    }
+#endif
+
+#define DISPATCH() \
+    { \
+        if (--_Py_Ticker >= 0) { \
+            FAST_DISPATCH(); \
+        } \
+        _Py_Ticker++; \
+        continue; \
+    }
+#else
+#define TARGET(op) \
+        case op:
+
+#define TARGET_WITH_IMPL(op, impl) \
+        /* silence compiler warnings about `impl` unused */ \
+        if (0) goto impl; \
+        case op:
+
+#define DISPATCH()      continue
+#define FAST_DISPATCH() goto fast_next_opcode
+#endif
+
+/* Superinstructions
+
+   The peephole optimizer replaces the first opcode of some frequent
+   pairs (LOAD_FAST LOAD_ATTR, COMPARE_OP POP_JUMP_IF_FALSE, ...) with a
+   combined opcode, but leaves the second instruction in place.  The
+   combined opcode runs the first instruction and then FUSE_NEXT(op)
+   jumps straight into the handler of the second one, saving a trip
+   through the dispatch.  Jumps to the second instruction still work,
+   and the code offsets and line numbers are unchanged.
+
+   While tracing, lltrace or the opcode profile are on (and always with
+   DYNAMIC_EXECUTION_PROFILE), the second instruction goes through the
+   normal dispatch instead, so that it gets its own line events and
+   counts. */
+
+#ifdef LLTRACE
+#define CAN_FUSE() \
+    (!lltrace && !(_Py_TracingPossible | _Py_OpcodeProfiling))
+#else
+#define CAN_FUSE() (!(_Py_TracingPossible | _Py_OpcodeProfiling))
+#endif
+
+#if defined(DYNAMIC_EXECUTION_PROFILE)
+#define FUSE_NEXT(op) \
+    { \
+        if (0) goto PRED_##op; \
+        FAST_DISPATCH(); \
+    }
+#elif USE_COMPUTED_GOTOS
+#define FUSE_NEXT(op) \
+    { \
+        if (0) goto PRED_##op; \
+        if (CAN_FUSE()) { \
+            f->f_lasti = INSTR_OFFSET(); \
+            next_instr++; \
+            goto TARGET_##op; \
+        } \
+        FAST_DISPATCH(); \
+    }
+#else
+#define FUSE_NEXT(op) \
+    { \
+        if (CAN_FUSE()) { \
+            f->f_lasti = INSTR_OFFSET(); \
+            opcode = op; \
+            goto PRED_##op; \
+        } \
+        FAST_DISPATCH(); \
+    }
+#endif
+
 /* OpCode prediction macros
     Some opcodes tend to come in pairs thus making it possible to
     predict the second code when the first is run.  For example,
@@ -801,12 +997,18 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
     predictions turned-on and interpret the results as if some opcodes
     had been combined or turn-off predictions so that the opcode frequency
     counter updates for both opcodes.
+
+    With computed gotos every opcode already has its own indirect jump,
+    which the branch predictor learns by itself, so the predictions
+    are turned off.  The runtime opcode profile (sys.setopcodeprofile())
+    skips the predictions while it is on.
 */
 
-#ifdef DYNAMIC_EXECUTION_PROFILE
+#if defined(DYNAMIC_EXECUTION_PROFILE) || USE_COMPUTED_GOTOS
 #define PREDICT(op)             if (0) goto PRED_##op
 #else
-#define PREDICT(op)             if (*next_instr == op) goto PRED_##op
+#define PREDICT(op) \
+    if (*next_instr == op && !_Py_OpcodeProfiling) goto PRED_##op
 #endif
 
 #define PREDICTED(op)           PRED_##op: next_instr++
@@ -1008,31 +1210,30 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                     _Py_Ticker = 0;
             }
 #ifdef WITH_THREAD
-            if (interpreter_lock) {
+            if (GIL_DROP_REQUESTED()) {
                 /* Give another thread a chance */
 
                 if (PyThreadState_Swap(NULL) != tstate)
                     Py_FatalError("ceval: tstate mix-up");
-                PyThread_release_lock(interpreter_lock);
+                drop_gil(tstate);
 
                 /* Other threads may run now */
 
-                PyThread_acquire_lock(interpreter_lock, 1);
+                take_gil(tstate, 0);
                 if (PyThreadState_Swap(tstate) != NULL)
                     Py_FatalError("ceval: orphan tstate");
-
-                /* Check for thread interrupts */
-
-                if (tstate->async_exc != NULL) {
-                    x = tstate->async_exc;
-                    tstate->async_exc = NULL;
-                    PyErr_SetNone(x);
-                    Py_DECREF(x);
-                    why = WHY_EXCEPTION;
-                    goto on_error;
-                }
             }
 #endif
+            /* Check for thread interrupts */
+
+            if (tstate->async_exc != NULL) {
+                x = tstate->async_exc;
+                tstate->async_exc = NULL;
+                PyErr_SetNone(x);
+                Py_DECREF(x);
+                why = WHY_EXCEPTION;
+                goto on_error;
+            }
         }
 
     fast_next_opcode:
@@ -1077,6 +1278,10 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
 #endif
         dxp[opcode]++;
 #endif
+        if (_Py_OpcodeProfiling) {
+            profile_opcode(co, f->f_lasti, lastop, opcode);
+            lastop = opcode;
+        }
 
 #ifdef LLTRACE
         /* Instruction tracing */
@@ -1105,55 +1310,79 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
 
         /* case STOP_CODE: this is an error! */
 
-        case NOP:
-            goto fast_next_opcode;
+        TARGET(NOP)
+            FAST_DISPATCH();
 
-        case LOAD_FAST:
+        PREDICTED_WITH_ARG(LOAD_FAST);
+        TARGET(LOAD_FAST)
             x = GETLOCAL(oparg);
             if (x != NULL) {
                 Py_INCREF(x);
                 PUSH(x);
-                goto fast_next_opcode;
+                FAST_DISPATCH();
             }
+          unbound_local_error:
             format_exc_check_arg(PyExc_UnboundLocalError,
                 UNBOUNDLOCAL_ERROR_MSG,
                 PyTuple_GetItem(co->co_varnames, oparg));
             break;
 
-        case LOAD_CONST:
+        TARGET(LOAD_FAST_LOAD_FAST)
+            x = GETLOCAL(oparg);
+            if (x == NULL)
+                goto unbound_local_error;
+            Py_INCREF(x);
+            PUSH(x);
+            FUSE_NEXT(LOAD_FAST);
+
+        TARGET(LOAD_FAST_LOAD_ATTR)
+            x = GETLOCAL(oparg);
+            if (x == NULL)
+                goto unbound_local_error;
+            Py_INCREF(x);
+            PUSH(x);
+            FUSE_NEXT(LOAD_ATTR);
+
+        TARGET(LOAD_CONST)
             x = GETITEM(consts, oparg);
             Py_INCREF(x);
             PUSH(x);
-            goto fast_next_opcode;
+            FAST_DISPATCH();
+
+        TARGET(LOAD_CONST_RETURN_VALUE)
+            x = GETITEM(consts, oparg);
+            Py_INCREF(x);
+            PUSH(x);
+            FUSE_NEXT(RETURN_VALUE);
 
         PREDICTED_WITH_ARG(STORE_FAST);
-        case STORE_FAST:
+        TARGET(STORE_FAST)
             v = POP();
             SETLOCAL(oparg, v);
-            goto fast_next_opcode;
+            FAST_DISPATCH();
 
-        case POP_TOP:
+        TARGET(POP_TOP)
             v = POP();
             Py_DECREF(v);
-            goto fast_next_opcode;
+            FAST_DISPATCH();
 
-        case ROT_TWO:
+        TARGET(ROT_TWO)
             v = TOP();
             w = SECOND();
             SET_TOP(w);
             SET_SECOND(v);
-            goto fast_next_opcode;
+            FAST_DISPATCH();
 
-        case ROT_THREE:
+        TARGET(ROT_THREE)
             v = TOP();
             w = SECOND();
             x = THIRD();
             SET_TOP(w);
             SET_SECOND(x);
             SET_THIRD(v);
-            goto fast_next_opcode;
+            FAST_DISPATCH();
 
-        case ROT_FOUR:
+        TARGET(ROT_FOUR)
             u = TOP();
             v = SECOND();
             w = THIRD();
@@ -1162,15 +1391,15 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             SET_SECOND(w);
             SET_THIRD(x);
             SET_FOURTH(u);
-            goto fast_next_opcode;
+            FAST_DISPATCH();
 
-        case DUP_TOP:
+        TARGET(DUP_TOP)
             v = TOP();
             Py_INCREF(v);
             PUSH(v);
-            goto fast_next_opcode;
+            FAST_DISPATCH();
 
-        case DUP_TOPX:
+        TARGET(DUP_TOPX)
             if (oparg == 2) {
                 x = TOP();
                 Py_INCREF(x);
@@ -1179,7 +1408,7 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                 STACKADJ(2);
                 SET_TOP(x);
                 SET_SECOND(w);
-                goto fast_next_opcode;
+                FAST_DISPATCH();
             } else if (oparg == 3) {
                 x = TOP();
                 Py_INCREF(x);
@@ -1191,84 +1420,84 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                 SET_TOP(x);
                 SET_SECOND(w);
                 SET_THIRD(v);
-                goto fast_next_opcode;
+                FAST_DISPATCH();
             }
             Py_FatalError("invalid argument to DUP_TOPX"
                           " (bytecode corruption?)");
             /* Never returns, so don't bother to set why. */
             break;
 
-        case UNARY_POSITIVE:
+        TARGET(UNARY_POSITIVE)
             v = TOP();
             x = PyNumber_Positive(v);
             Py_DECREF(v);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case UNARY_NEGATIVE:
+        TARGET(UNARY_NEGATIVE)
             v = TOP();
             x = PyNumber_Negative(v);
             Py_DECREF(v);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case UNARY_NOT:
+        TARGET(UNARY_NOT)
             v = TOP();
             err = PyObject_IsTrue(v);
             Py_DECREF(v);
             if (err == 0) {
                 Py_INCREF(Py_True);
                 SET_TOP(Py_True);
-                continue;
+                DISPATCH();
             }
             else if (err > 0) {
                 Py_INCREF(Py_False);
                 SET_TOP(Py_False);
                 err = 0;
-                continue;
+                DISPATCH();
             }
             STACKADJ(-1);
             break;
 
-        case UNARY_CONVERT:
+        TARGET(UNARY_CONVERT)
             v = TOP();
             x = PyObject_Repr(v);
             Py_DECREF(v);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case UNARY_INVERT:
+        TARGET(UNARY_INVERT)
             v = TOP();
             x = PyNumber_Invert(v);
             Py_DECREF(v);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case BINARY_POWER:
+        TARGET(BINARY_POWER)
             w = POP();
             v = TOP();
             x = PyNumber_Power(v, w, Py_None);
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case BINARY_MULTIPLY:
+        TARGET(BINARY_MULTIPLY)
             w = POP();
             v = TOP();
             x = PyNumber_Multiply(v, w);
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case BINARY_DIVIDE:
+        TARGET(BINARY_DIVIDE)
             if (!_Py_QnewFlag) {
                 w = POP();
                 v = TOP();
@@ -1276,32 +1505,32 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                 Py_DECREF(v);
                 Py_DECREF(w);
                 SET_TOP(x);
-                if (x != NULL) continue;
+                if (x != NULL) DISPATCH();
                 break;
             }
             /* -Qnew is in effect:  fall through to
                BINARY_TRUE_DIVIDE */
-        case BINARY_TRUE_DIVIDE:
+        TARGET(BINARY_TRUE_DIVIDE)
             w = POP();
             v = TOP();
             x = PyNumber_TrueDivide(v, w);
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case BINARY_FLOOR_DIVIDE:
+        TARGET(BINARY_FLOOR_DIVIDE)
             w = POP();
             v = TOP();
             x = PyNumber_FloorDivide(v, w);
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case BINARY_MODULO:
+        TARGET(BINARY_MODULO)
             w = POP();
             v = TOP();
             if (PyString_CheckExact(v))
@@ -1311,10 +1540,10 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case BINARY_ADD:
+        TARGET(BINARY_ADD)
             w = POP();
             v = TOP();
             if (PyInt_CheckExact(v) && PyInt_CheckExact(w)) {
@@ -1343,10 +1572,10 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
           skip_decref_vx:
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case BINARY_SUBTRACT:
+        TARGET(BINARY_SUBTRACT)
             w = POP();
             v = TOP();
             if (PyInt_CheckExact(v) && PyInt_CheckExact(w)) {
@@ -1368,10 +1597,10 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case BINARY_SUBSCR:
+        TARGET(BINARY_SUBSCR)
             w = POP();
             v = TOP();
             if (PyList_CheckExact(v) && PyInt_CheckExact(w)) {
@@ -1392,102 +1621,102 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case BINARY_LSHIFT:
+        TARGET(BINARY_LSHIFT)
             w = POP();
             v = TOP();
             x = PyNumber_Lshift(v, w);
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case BINARY_RSHIFT:
+        TARGET(BINARY_RSHIFT)
             w = POP();
             v = TOP();
             x = PyNumber_Rshift(v, w);
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case BINARY_AND:
+        TARGET(BINARY_AND)
             w = POP();
             v = TOP();
             x = PyNumber_And(v, w);
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case BINARY_XOR:
+        TARGET(BINARY_XOR)
             w = POP();
             v = TOP();
             x = PyNumber_Xor(v, w);
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case BINARY_OR:
+        TARGET(BINARY_OR)
             w = POP();
             v = TOP();
             x = PyNumber_Or(v, w);
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case LIST_APPEND:
+        TARGET(LIST_APPEND)
             w = POP();
             v = PEEK(oparg);
             err = PyList_Append(v, w);
             Py_DECREF(w);
             if (err == 0) {
                 PREDICT(JUMP_ABSOLUTE);
-                continue;
+                DISPATCH();
             }
             break;
 
-        case SET_ADD:
+        TARGET(SET_ADD)
             w = POP();
             v = stack_pointer[-oparg];
             err = PySet_Add(v, w);
             Py_DECREF(w);
             if (err == 0) {
                 PREDICT(JUMP_ABSOLUTE);
-                continue;
+                DISPATCH();
             }
             break;
 
-        case INPLACE_POWER:
+        TARGET(INPLACE_POWER)
             w = POP();
             v = TOP();
             x = PyNumber_InPlacePower(v, w, Py_None);
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case INPLACE_MULTIPLY:
+        TARGET(INPLACE_MULTIPLY)
             w = POP();
             v = TOP();
             x = PyNumber_InPlaceMultiply(v, w);
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case INPLACE_DIVIDE:
+        TARGET(INPLACE_DIVIDE)
             if (!_Py_QnewFlag) {
                 w = POP();
                 v = TOP();
@@ -1495,42 +1724,42 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                 Py_DECREF(v);
                 Py_DECREF(w);
                 SET_TOP(x);
-                if (x != NULL) continue;
+                if (x != NULL) DISPATCH();
                 break;
             }
             /* -Qnew is in effect:  fall through to
                INPLACE_TRUE_DIVIDE */
-        case INPLACE_TRUE_DIVIDE:
+        TARGET(INPLACE_TRUE_DIVIDE)
             w = POP();
             v = TOP();
             x = PyNumber_InPlaceTrueDivide(v, w);
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case INPLACE_FLOOR_DIVIDE:
+        TARGET(INPLACE_FLOOR_DIVIDE)
             w = POP();
             v = TOP();
             x = PyNumber_InPlaceFloorDivide(v, w);
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case INPLACE_MODULO:
+        TARGET(INPLACE_MODULO)
             w = POP();
             v = TOP();
             x = PyNumber_InPlaceRemainder(v, w);
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case INPLACE_ADD:
+        TARGET(INPLACE_ADD)
             w = POP();
             v = TOP();
             if (PyInt_CheckExact(v) && PyInt_CheckExact(w)) {
@@ -1557,10 +1786,10 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
           skip_decref_v:
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case INPLACE_SUBTRACT:
+        TARGET(INPLACE_SUBTRACT)
             w = POP();
             v = TOP();
             if (PyInt_CheckExact(v) && PyInt_CheckExact(w)) {
@@ -1580,63 +1809,64 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case INPLACE_LSHIFT:
+        TARGET(INPLACE_LSHIFT)
             w = POP();
             v = TOP();
             x = PyNumber_InPlaceLshift(v, w);
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case INPLACE_RSHIFT:
+        TARGET(INPLACE_RSHIFT)
             w = POP();
             v = TOP();
             x = PyNumber_InPlaceRshift(v, w);
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case INPLACE_AND:
+        TARGET(INPLACE_AND)
             w = POP();
             v = TOP();
             x = PyNumber_InPlaceAnd(v, w);
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case INPLACE_XOR:
+        TARGET(INPLACE_XOR)
             w = POP();
             v = TOP();
             x = PyNumber_InPlaceXor(v, w);
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case INPLACE_OR:
+        TARGET(INPLACE_OR)
             w = POP();
             v = TOP();
             x = PyNumber_InPlaceOr(v, w);
             Py_DECREF(v);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case SLICE+0:
-        case SLICE+1:
-        case SLICE+2:
-        case SLICE+3:
+        TARGET_WITH_IMPL(SLICE, _slice)
+        TARGET_WITH_IMPL(SLICE_1, _slice)
+        TARGET_WITH_IMPL(SLICE_2, _slice)
+        TARGET_WITH_IMPL(SLICE_3, _slice)
+        _slice:
             if ((opcode-SLICE) & 2)
                 w = POP();
             else
@@ -1651,13 +1881,14 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             Py_XDECREF(v);
             Py_XDECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case STORE_SLICE+0:
-        case STORE_SLICE+1:
-        case STORE_SLICE+2:
-        case STORE_SLICE+3:
+        TARGET_WITH_IMPL(STORE_SLICE, _store_slice)
+        TARGET_WITH_IMPL(STORE_SLICE_1, _store_slice)
+        TARGET_WITH_IMPL(STORE_SLICE_2, _store_slice)
+        TARGET_WITH_IMPL(STORE_SLICE_3, _store_slice)
+        _store_slice:
             if ((opcode-STORE_SLICE) & 2)
                 w = POP();
             else
@@ -1673,13 +1904,14 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             Py_DECREF(u);
             Py_XDECREF(v);
             Py_XDECREF(w);
-            if (err == 0) continue;
+            if (err == 0) DISPATCH();
             break;
 
-        case DELETE_SLICE+0:
-        case DELETE_SLICE+1:
-        case DELETE_SLICE+2:
-        case DELETE_SLICE+3:
+        TARGET_WITH_IMPL(DELETE_SLICE, _delete_slice)
+        TARGET_WITH_IMPL(DELETE_SLICE_1, _delete_slice)
+        TARGET_WITH_IMPL(DELETE_SLICE_2, _delete_slice)
+        TARGET_WITH_IMPL(DELETE_SLICE_3, _delete_slice)
+        _delete_slice:
             if ((opcode-DELETE_SLICE) & 2)
                 w = POP();
             else
@@ -1694,10 +1926,10 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             Py_DECREF(u);
             Py_XDECREF(v);
             Py_XDECREF(w);
-            if (err == 0) continue;
+            if (err == 0) DISPATCH();
             break;
 
-        case STORE_SUBSCR:
+        TARGET(STORE_SUBSCR)
             w = TOP();
             v = SECOND();
             u = THIRD();
@@ -1707,10 +1939,10 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             Py_DECREF(u);
             Py_DECREF(v);
             Py_DECREF(w);
-            if (err == 0) continue;
+            if (err == 0) DISPATCH();
             break;
 
-        case DELETE_SUBSCR:
+        TARGET(DELETE_SUBSCR)
             w = TOP();
             v = SECOND();
             STACKADJ(-2);
@@ -1718,10 +1950,10 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             err = PyObject_DelItem(v, w);
             Py_DECREF(v);
             Py_DECREF(w);
-            if (err == 0) continue;
+            if (err == 0) DISPATCH();
             break;
 
-        case PRINT_EXPR:
+        TARGET(PRINT_EXPR)
             v = POP();
             w = PySys_GetObject("displayhook");
             if (w == NULL) {
@@ -1745,11 +1977,11 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             Py_XDECREF(x);
             break;
 
-        case PRINT_ITEM_TO:
+        TARGET(PRINT_ITEM_TO)
             w = stream = POP();
             /* fall through to PRINT_ITEM */
 
-        case PRINT_ITEM:
+        TARGET(PRINT_ITEM)
             v = POP();
             if (stream == NULL || stream == Py_None) {
                 w = PySys_GetObject("stdout");
@@ -1796,14 +2028,14 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             Py_XDECREF(stream);
             stream = NULL;
             if (err == 0)
-                continue;
+                DISPATCH();
             break;
 
-        case PRINT_NEWLINE_TO:
+        TARGET(PRINT_NEWLINE_TO)
             w = stream = POP();
             /* fall through to PRINT_NEWLINE */
 
-        case PRINT_NEWLINE:
+        TARGET(PRINT_NEWLINE)
             if (stream == NULL || stream == Py_None) {
                 w = PySys_GetObject("stdout");
                 if (w == NULL) {
@@ -1829,7 +2061,7 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
 #ifdef CASE_TOO_BIG
         default: switch (opcode) {
 #endif
-        case RAISE_VARARGS:
+        TARGET(RAISE_VARARGS)
             u = v = w = NULL;
             switch (oparg) {
             case 3:
@@ -1851,27 +2083,28 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             }
             break;
 
-        case LOAD_LOCALS:
+        TARGET(LOAD_LOCALS)
             if ((x = f->f_locals) != NULL) {
                 Py_INCREF(x);
                 PUSH(x);
-                continue;
+                DISPATCH();
             }
             PyErr_SetString(PyExc_SystemError, "no locals");
             break;
 
-        case RETURN_VALUE:
+        PREDICTED(RETURN_VALUE);
+        TARGET(RETURN_VALUE)
             retval = POP();
             why = WHY_RETURN;
             goto fast_block_end;
 
-        case YIELD_VALUE:
+        TARGET(YIELD_VALUE)
             retval = POP();
             f->f_stacktop = stack_pointer;
             why = WHY_YIELD;
             goto fast_yield;
 
-        case EXEC_STMT:
+        TARGET(EXEC_STMT)
             w = TOP();
             v = SECOND();
             u = THIRD();
@@ -1884,7 +2117,7 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             Py_DECREF(w);
             break;
 
-        case POP_BLOCK:
+        TARGET(POP_BLOCK)
             {
                 PyTryBlock *b = PyFrame_BlockPop(f);
                 while (STACK_LEVEL() > b->b_level) {
@@ -1892,10 +2125,10 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                     Py_DECREF(v);
                 }
             }
-            continue;
+            DISPATCH();
 
         PREDICTED(END_FINALLY);
-        case END_FINALLY:
+        TARGET(END_FINALLY)
             v = POP();
             if (PyInt_Check(v)) {
                 why = (enum why_code) PyInt_AS_LONG(v);
@@ -1920,7 +2153,7 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             Py_DECREF(v);
             break;
 
-        case BUILD_CLASS:
+        TARGET(BUILD_CLASS)
             u = TOP();
             v = SECOND();
             w = THIRD();
@@ -1932,7 +2165,7 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             Py_DECREF(w);
             break;
 
-        case STORE_NAME:
+        TARGET(STORE_NAME)
             w = GETITEM(names, oparg);
             v = POP();
             if ((x = f->f_locals) != NULL) {
@@ -1941,7 +2174,7 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                 else
                     err = PyObject_SetItem(x, w, v);
                 Py_DECREF(v);
-                if (err == 0) continue;
+                if (err == 0) DISPATCH();
                 break;
             }
             PyErr_Format(PyExc_SystemError,
@@ -1949,7 +2182,7 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                          PyObject_REPR(w));
             break;
 
-        case DELETE_NAME:
+        TARGET(DELETE_NAME)
             w = GETITEM(names, oparg);
             if ((x = f->f_locals) != NULL) {
                 if ((err = PyObject_DelItem(x, w)) != 0)
@@ -1964,7 +2197,7 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             break;
 
         PREDICTED_WITH_ARG(UNPACK_SEQUENCE);
-        case UNPACK_SEQUENCE:
+        TARGET(UNPACK_SEQUENCE)
             v = POP();
             if (PyTuple_CheckExact(v) &&
                 PyTuple_GET_SIZE(v) == oparg) {
@@ -1976,7 +2209,7 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                     PUSH(w);
                 }
                 Py_DECREF(v);
-                continue;
+                DISPATCH();
             } else if (PyList_CheckExact(v) &&
                        PyList_GET_SIZE(v) == oparg) {
                 PyObject **items = \
@@ -1996,18 +2229,18 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             Py_DECREF(v);
             break;
 
-        case STORE_ATTR:
+        TARGET(STORE_ATTR)
             w = GETITEM(names, oparg);
             v = TOP();
             u = SECOND();
             STACKADJ(-2);
-            err = PyObject_SetAttr(v, w, u); /* v.w = u */
+            err = store_attr(co, f->f_lasti, v, w, u); /* v.w = u */
             Py_DECREF(v);
             Py_DECREF(u);
-            if (err == 0) continue;
+            if (err == 0) DISPATCH();
             break;
 
-        case DELETE_ATTR:
+        TARGET(DELETE_ATTR)
             w = GETITEM(names, oparg);
             v = POP();
             err = PyObject_SetAttr(v, w, (PyObject *)NULL);
@@ -2015,22 +2248,22 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             Py_DECREF(v);
             break;
 
-        case STORE_GLOBAL:
+        TARGET(STORE_GLOBAL)
             w = GETITEM(names, oparg);
             v = POP();
             err = PyDict_SetItem(f->f_globals, w, v);
             Py_DECREF(v);
-            if (err == 0) continue;
+            if (err == 0) DISPATCH();
             break;
 
-        case DELETE_GLOBAL:
+        TARGET(DELETE_GLOBAL)
             w = GETITEM(names, oparg);
             if ((err = PyDict_DelItem(f->f_globals, w)) != 0)
                 format_exc_check_arg(
                     PyExc_NameError, GLOBAL_NAME_ERROR_MSG, w);
             break;
 
-        case LOAD_NAME:
+        TARGET(LOAD_NAME)
             w = GETITEM(names, oparg);
             if ((v = f->f_locals) == NULL) {
                 PyErr_Format(PyExc_SystemError,
@@ -2066,9 +2299,11 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                 Py_INCREF(x);
             }
             PUSH(x);
-            continue;
+            DISPATCH();
 
-        case LOAD_GLOBAL:
+        TARGET_WITH_IMPL(LOAD_GLOBAL_CALL_FUNCTION, _load_global)
+        TARGET(LOAD_GLOBAL)
+        _load_global:
             w = GETITEM(names, oparg);
             if (PyString_CheckExact(w)) {
                 /* Inline the PyDict_GetItem() calls.
@@ -2085,11 +2320,8 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                         break;
                     }
                     x = e->me_value;
-                    if (x != NULL) {
-                        Py_INCREF(x);
-                        PUSH(x);
-                        continue;
-                    }
+                    if (x != NULL)
+                        goto load_global_found;
                     d = (PyDictObject *)(f->f_builtins);
                     e = d->ma_lookup(d, w, hash);
                     if (e == NULL) {
@@ -2097,11 +2329,8 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                         break;
                     }
                     x = e->me_value;
-                    if (x != NULL) {
-                        Py_INCREF(x);
-                        PUSH(x);
-                        continue;
-                    }
+                    if (x != NULL)
+                        goto load_global_found;
                     goto load_global_error;
                 }
             }
@@ -2117,15 +2346,18 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                     break;
                 }
             }
+          load_global_found:
             Py_INCREF(x);
             PUSH(x);
-            continue;
+            if (opcode == LOAD_GLOBAL_CALL_FUNCTION)
+                FUSE_NEXT(CALL_FUNCTION);
+            DISPATCH();
 
-        case DELETE_FAST:
+        TARGET(DELETE_FAST)
             x = GETLOCAL(oparg);
             if (x != NULL) {
                 SETLOCAL(oparg, NULL);
-                continue;
+                DISPATCH();
             }
             format_exc_check_arg(
                 PyExc_UnboundLocalError,
@@ -2134,19 +2366,19 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                 );
             break;
 
-        case LOAD_CLOSURE:
+        TARGET(LOAD_CLOSURE)
             x = freevars[oparg];
             Py_INCREF(x);
             PUSH(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case LOAD_DEREF:
+        TARGET(LOAD_DEREF)
             x = freevars[oparg];
             w = PyCell_Get(x);
             if (w != NULL) {
                 PUSH(w);
-                continue;
+                DISPATCH();
             }
             err = -1;
             /* Don't stomp existing exception */
@@ -2167,14 +2399,14 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             }
             break;
 
-        case STORE_DEREF:
+        TARGET(STORE_DEREF)
             w = POP();
             x = freevars[oparg];
             PyCell_Set(x, w);
             Py_DECREF(w);
-            continue;
+            DISPATCH();
 
-        case BUILD_TUPLE:
+        TARGET(BUILD_TUPLE)
             x = PyTuple_New(oparg);
             if (x != NULL) {
                 for (; --oparg >= 0;) {
@@ -2182,11 +2414,11 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                     PyTuple_SET_ITEM(x, oparg, w);
                 }
                 PUSH(x);
-                continue;
+                DISPATCH();
             }
             break;
 
-        case BUILD_LIST:
+        TARGET(BUILD_LIST)
             x =  PyList_New(oparg);
             if (x != NULL) {
                 for (; --oparg >= 0;) {
@@ -2194,11 +2426,11 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                     PyList_SET_ITEM(x, oparg, w);
                 }
                 PUSH(x);
-                continue;
+                DISPATCH();
             }
             break;
 
-        case BUILD_SET:
+        TARGET(BUILD_SET)
             x = PySet_New(NULL);
             if (x != NULL) {
                 for (; --oparg >= 0;) {
@@ -2212,18 +2444,18 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                     break;
                 }
                 PUSH(x);
-                continue;
+                DISPATCH();
             }
             break;
 
 
-        case BUILD_MAP:
+        TARGET(BUILD_MAP)
             x = _PyDict_NewPresized((Py_ssize_t)oparg);
             PUSH(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case STORE_MAP:
+        TARGET(STORE_MAP)
             w = TOP();     /* key */
             u = SECOND();  /* value */
             v = THIRD();   /* dict */
@@ -2232,10 +2464,10 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             err = PyDict_SetItem(v, w, u);  /* v[w] = u */
             Py_DECREF(u);
             Py_DECREF(w);
-            if (err == 0) continue;
+            if (err == 0) DISPATCH();
             break;
 
-        case MAP_ADD:
+        TARGET(MAP_ADD)
             w = TOP();     /* key */
             u = SECOND();  /* value */
             STACKADJ(-2);
@@ -2246,20 +2478,23 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             Py_DECREF(w);
             if (err == 0) {
                 PREDICT(JUMP_ABSOLUTE);
-                continue;
+                DISPATCH();
             }
             break;
 
-        case LOAD_ATTR:
+        PREDICTED_WITH_ARG(LOAD_ATTR);
+        TARGET(LOAD_ATTR)
             w = GETITEM(names, oparg);
             v = TOP();
-            x = PyObject_GetAttr(v, w);
+            x = load_attr(co, f->f_lasti, v, w);
             Py_DECREF(v);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case COMPARE_OP:
+        TARGET_WITH_IMPL(COMPARE_OP_POP_JUMP_IF_FALSE, _compare_op)
+        TARGET(COMPARE_OP)
+        _compare_op:
             w = POP();
             v = TOP();
             if (PyInt_CheckExact(w) && PyInt_CheckExact(v)) {
@@ -2290,11 +2525,13 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             Py_DECREF(w);
             SET_TOP(x);
             if (x == NULL) break;
+            if (opcode == COMPARE_OP_POP_JUMP_IF_FALSE)
+                FUSE_NEXT(POP_JUMP_IF_FALSE);
             PREDICT(POP_JUMP_IF_FALSE);
             PREDICT(POP_JUMP_IF_TRUE);
-            continue;
+            DISPATCH();
 
-        case IMPORT_NAME:
+        TARGET(IMPORT_NAME)
             w = GETITEM(names, oparg);
             x = PyDict_GetItemString(f->f_builtins, "__import__");
             if (x == NULL) {
@@ -2335,10 +2572,10 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             READ_TIMESTAMP(intr1);
             Py_DECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case IMPORT_STAR:
+        TARGET(IMPORT_STAR)
             v = POP();
             PyFrame_FastToLocals(f);
             if ((x = f->f_locals) == NULL) {
@@ -2351,34 +2588,34 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             READ_TIMESTAMP(intr1);
             PyFrame_LocalsToFast(f, 0);
             Py_DECREF(v);
-            if (err == 0) continue;
+            if (err == 0) DISPATCH();
             break;
 
-        case IMPORT_FROM:
+        TARGET(IMPORT_FROM)
             w = GETITEM(names, oparg);
             v = TOP();
             READ_TIMESTAMP(intr0);
             x = import_from(v, w);
             READ_TIMESTAMP(intr1);
             PUSH(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case JUMP_FORWARD:
+        TARGET(JUMP_FORWARD)
             JUMPBY(oparg);
-            goto fast_next_opcode;
+            FAST_DISPATCH();
 
         PREDICTED_WITH_ARG(POP_JUMP_IF_FALSE);
-        case POP_JUMP_IF_FALSE:
+        TARGET(POP_JUMP_IF_FALSE)
             w = POP();
             if (w == Py_True) {
                 Py_DECREF(w);
-                goto fast_next_opcode;
+                FAST_DISPATCH();
             }
             if (w == Py_False) {
                 Py_DECREF(w);
                 JUMPTO(oparg);
-                goto fast_next_opcode;
+                FAST_DISPATCH();
             }
             err = PyObject_IsTrue(w);
             Py_DECREF(w);
@@ -2388,19 +2625,19 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                 JUMPTO(oparg);
             else
                 break;
-            continue;
+            DISPATCH();
 
         PREDICTED_WITH_ARG(POP_JUMP_IF_TRUE);
-        case POP_JUMP_IF_TRUE:
+        TARGET(POP_JUMP_IF_TRUE)
             w = POP();
             if (w == Py_False) {
                 Py_DECREF(w);
-                goto fast_next_opcode;
+                FAST_DISPATCH();
             }
             if (w == Py_True) {
                 Py_DECREF(w);
                 JUMPTO(oparg);
-                goto fast_next_opcode;
+                FAST_DISPATCH();
             }
             err = PyObject_IsTrue(w);
             Py_DECREF(w);
@@ -2412,18 +2649,18 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                 ;
             else
                 break;
-            continue;
+            DISPATCH();
 
-        case JUMP_IF_FALSE_OR_POP:
+        TARGET(JUMP_IF_FALSE_OR_POP)
             w = TOP();
             if (w == Py_True) {
                 STACKADJ(-1);
                 Py_DECREF(w);
-                goto fast_next_opcode;
+                FAST_DISPATCH();
             }
             if (w == Py_False) {
                 JUMPTO(oparg);
-                goto fast_next_opcode;
+                FAST_DISPATCH();
             }
             err = PyObject_IsTrue(w);
             if (err > 0) {
@@ -2435,18 +2672,18 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                 JUMPTO(oparg);
             else
                 break;
-            continue;
+            DISPATCH();
 
-        case JUMP_IF_TRUE_OR_POP:
+        TARGET(JUMP_IF_TRUE_OR_POP)
             w = TOP();
             if (w == Py_False) {
                 STACKADJ(-1);
                 Py_DECREF(w);
-                goto fast_next_opcode;
+                FAST_DISPATCH();
             }
             if (w == Py_True) {
                 JUMPTO(oparg);
-                goto fast_next_opcode;
+                FAST_DISPATCH();
             }
             err = PyObject_IsTrue(w);
             if (err > 0) {
@@ -2459,10 +2696,10 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             }
             else
                 break;
-            continue;
+            DISPATCH();
 
         PREDICTED_WITH_ARG(JUMP_ABSOLUTE);
-        case JUMP_ABSOLUTE:
+        TARGET(JUMP_ABSOLUTE)
             JUMPTO(oparg);
 #if FAST_LOOPS
             /* Enabling this path speeds-up all while and for-loops by bypassing
@@ -2472,12 +2709,12 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                the speed-up and do not need break checking inside tight loops (ones
                that contain only instructions ending with goto fast_next_opcode).
             */
-            goto fast_next_opcode;
+            FAST_DISPATCH();
 #else
-            continue;
+            DISPATCH();
 #endif
 
-        case GET_ITER:
+        TARGET(GET_ITER)
             /* before: [obj]; after [getiter(obj)] */
             v = TOP();
             x = PyObject_GetIter(v);
@@ -2485,13 +2722,13 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             if (x != NULL) {
                 SET_TOP(x);
                 PREDICT(FOR_ITER);
-                continue;
+                DISPATCH();
             }
             STACKADJ(-1);
             break;
 
         PREDICTED_WITH_ARG(FOR_ITER);
-        case FOR_ITER:
+        TARGET(FOR_ITER)
             /* before: [iter]; after: [iter, iter()] *or* [] */
             v = TOP();
             x = (*v->ob_type->tp_iternext)(v);
@@ -2499,7 +2736,7 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                 PUSH(x);
                 PREDICT(STORE_FAST);
                 PREDICT(UNPACK_SEQUENCE);
-                continue;
+                DISPATCH();
             }
             if (PyErr_Occurred()) {
                 if (!PyErr_ExceptionMatches(
@@ -2511,13 +2748,13 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             x = v = POP();
             Py_DECREF(v);
             JUMPBY(oparg);
-            continue;
+            DISPATCH();
 
-        case BREAK_LOOP:
+        TARGET(BREAK_LOOP)
             why = WHY_BREAK;
             goto fast_block_end;
 
-        case CONTINUE_LOOP:
+        TARGET(CONTINUE_LOOP)
             retval = PyInt_FromLong(oparg);
             if (!retval) {
                 x = NULL;
@@ -2526,9 +2763,10 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             why = WHY_CONTINUE;
             goto fast_block_end;
 
-        case SETUP_LOOP:
-        case SETUP_EXCEPT:
-        case SETUP_FINALLY:
+        TARGET_WITH_IMPL(SETUP_LOOP, _setup_finally)
+        TARGET_WITH_IMPL(SETUP_EXCEPT, _setup_finally)
+        TARGET_WITH_IMPL(SETUP_FINALLY, _setup_finally)
+        _setup_finally:
             /* NOTE: If you add any new block-setup opcodes that
                are not try/except/finally handlers, you may need
                to update the PyGen_NeedsFinalizing() function.
@@ -2536,9 +2774,9 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
 
             PyFrame_BlockSetup(f, opcode, INSTR_OFFSET() + oparg,
                                STACK_LEVEL());
-            continue;
+            DISPATCH();
 
-        case SETUP_WITH:
+        TARGET(SETUP_WITH)
         {
             static PyObject *exit, *enter;
             w = TOP();
@@ -2564,10 +2802,10 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
                                STACK_LEVEL());
 
             PUSH(x);
-            continue;
+            DISPATCH();
         }
 
-        case WITH_CLEANUP:
+        TARGET(WITH_CLEANUP)
         {
             /* At the top of the stack are 1-3 values indicating
                how/why we entered the finally clause:
@@ -2655,7 +2893,8 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             break;
         }
 
-        case CALL_FUNCTION:
+        PREDICTED_WITH_ARG(CALL_FUNCTION);
+        TARGET(CALL_FUNCTION)
         {
             PyObject **sp;
             PCALL(PCALL_ALL);
@@ -2668,13 +2907,14 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             stack_pointer = sp;
             PUSH(x);
             if (x != NULL)
-                continue;
+                DISPATCH();
             break;
         }
 
-        case CALL_FUNCTION_VAR:
-        case CALL_FUNCTION_KW:
-        case CALL_FUNCTION_VAR_KW:
+        TARGET_WITH_IMPL(CALL_FUNCTION_VAR, _call_function_var_kw)
+        TARGET_WITH_IMPL(CALL_FUNCTION_KW, _call_function_var_kw)
+        TARGET_WITH_IMPL(CALL_FUNCTION_VAR_KW, _call_function_var_kw)
+        _call_function_var_kw:
         {
             int na = oparg & 0xff;
             int nk = (oparg>>8) & 0xff;
@@ -2713,11 +2953,11 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             }
             PUSH(x);
             if (x != NULL)
-                continue;
+                DISPATCH();
             break;
         }
 
-        case MAKE_FUNCTION:
+        TARGET(MAKE_FUNCTION)
             v = POP(); /* code object */
             x = PyFunction_New(v, f->f_globals);
             Py_DECREF(v);
@@ -2739,7 +2979,7 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             PUSH(x);
             break;
 
-        case MAKE_CLOSURE:
+        TARGET(MAKE_CLOSURE)
         {
             v = POP(); /* code object */
             x = PyFunction_New(v, f->f_globals);
@@ -2774,7 +3014,7 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             break;
         }
 
-        case BUILD_SLICE:
+        TARGET(BUILD_SLICE)
             if (oparg == 3)
                 w = POP();
             else
@@ -2786,14 +3026,17 @@ PyEval_EvalFrameEx(PyFrameObject *f, int throwflag)
             Py_DECREF(v);
             Py_XDECREF(w);
             SET_TOP(x);
-            if (x != NULL) continue;
+            if (x != NULL) DISPATCH();
             break;
 
-        case EXTENDED_ARG:
+        TARGET(EXTENDED_ARG)
             opcode = NEXTOP();
             oparg = oparg<<16 | NEXTARG();
             goto dispatch_opcode;
 
+#if USE_COMPUTED_GOTOS
+        _unknown_opcode:
+#endif
         default:
             fprintf(stderr,
                 "XXX lineno: %d, opcode: %d\n",
@@ -3993,12 +4236,19 @@ call_function(PyObject ***pp_stack, int oparg
     /* Always dispatch PyCFunction first, because these are
        presumed to be the most frequent callable object.
     */
-    if (PyCFunction_Check(func) && nk == 0) {
+    if (PyCFunction_Check(func) &&
+        (nk == 0 || PyCFunction_GET_FLAGS(func) & METH_FASTCALL)) {
         int flags = PyCFunction_GET_FLAGS(func);
         PyThreadState *tstate = PyThreadState_GET();
 
         PCALL(PCALL_CFUNCTION);
-        if (flags & (METH_NOARGS | METH_O)) {
+        if (flags & METH_FASTCALL) {
+            /* The arguments stay on the stack */
+            READ_TIMESTAMP(*pintr0);
+            C_TRACE(x, fast_cfunction(func, pfunc + 1, na, nk));
+            READ_TIMESTAMP(*pintr1);
+        }
+        else if (flags & (METH_NOARGS | METH_O)) {
             PyCFunction meth = PyCFunction_GET_FUNCTION(func);
             PyObject *self = PyCFunction_GET_SELF(func);
             if (flags & METH_NOARGS && na == 0) {
@@ -4058,6 +4308,50 @@ call_function(PyObject ***pp_stack, int oparg
     return x;
 }
 
+/* Call the METH_FASTCALL function func with the na positional
+   arguments and nk keyword/value pairs in stack.  Without keywords the
+   function gets the stack itself, otherwise the values are copied after
+   the positional arguments into a temporary array. */
+
+#define FASTCALL_SMALL_STACK 8
+
+static PyObject *
+fast_cfunction(PyObject *func, PyObject **stack, int na, int nk)
+{
+    _PyCFunctionFast meth = (_PyCFunctionFast)PyCFunction_GET_FUNCTION(func);
+    PyObject *self = PyCFunction_GET_SELF(func);
+    PyObject *small_stack[FASTCALL_SMALL_STACK];
+    PyObject **args, *kwnames, *key, *x;
+    int i;
+
+    if (nk == 0)
+        return (*meth)(self, stack, na, NULL);
+    kwnames = PyTuple_New(nk);
+    if (kwnames == NULL)
+        return NULL;
+    args = small_stack;
+    if (na + nk > FASTCALL_SMALL_STACK) {
+        args = PyMem_New(PyObject *, na + nk);
+        if (args == NULL) {
+            Py_DECREF(kwnames);
+            return PyErr_NoMemory();
+        }
+    }
+    for (i = 0; i < na; i++)
+        args[i] = stack[i];
+    for (i = 0; i < nk; i++) {
+        key = stack[na + 2*i];
+        Py_INCREF(key);
+        PyTuple_SET_ITEM(kwnames, i, key);
+        args[na + i] = stack[na + 2*i + 1];
+    }
+    x = (*meth)(self, args, na, kwnames);
+    if (args != small_stack)
+        PyMem_Free(args);
+    Py_DECREF(kwnames);
+    return x;
+}
+
 /* The fast_function() function optimize calls for which no argument
    tuple is necessary; the objects are passed directly from the stack.
    For the simplest case -- a function that takes only positional
@@ -4901,3 +5195,473 @@ _Py_GetDXProfile(PyObject *self, PyObject *args)
 }
 
 #endif
+
+/* Runtime opcode profile */
+
+static void
+profile_opcode(PyCodeObject *co, int offset, int lastop, int opcode)
+{
+    opcode_counts[opcode]++;
+    if (lastop >= 0)
+        opcode_pairs[lastop][opcode]++;
+    if (co->co_opcounts == NULL) {
+        Py_ssize_t n = PyString_GET_SIZE(co->co_code);
+        unsigned long *counts;
+
+        if (profiled_codes == NULL) {
+            profiled_codes = PyList_New(0);
+            if (profiled_codes == NULL) {
+                PyErr_Clear();
+                return;
+            }
+        }
+        counts = (unsigned long *)PyMem_Malloc(n * sizeof(unsigned long));
+        if (counts == NULL)
+            return;
+        memset(counts, 0, n * sizeof(unsigned long));
+        if (PyList_Append(profiled_codes, (PyObject *)co) < 0) {
+            /* The profile is best effort, don't fail the frame */
+            PyErr_Clear();
+            PyMem_Free(counts);
+            return;
+        }
+        co->co_opcounts = counts;
+    }
+    co->co_opcounts[offset]++;
+}
+
+static void
+reset_opcode_profile(void)
+{
+    Py_ssize_t i;
+
+    memset(opcode_counts, 0, sizeof(opcode_counts));
+    memset(opcode_pairs, 0, sizeof(opcode_pairs));
+    if (profiled_codes == NULL)
+        return;
+    for (i = 0; i < PyList_GET_SIZE(profiled_codes); i++) {
+        PyCodeObject *co = (PyCodeObject *)PyList_GET_ITEM(profiled_codes, i);
+        PyMem_Free(co->co_opcounts);
+        co->co_opcounts = NULL;
+    }
+    Py_CLEAR(profiled_codes);
+}
+
+/* Add key: PyInt(count) to dict d; steals the reference to key */
+static int
+add_count(PyObject *d, PyObject *key, unsigned long count)
+{
+    PyObject *value;
+    int err;
+
+    if (key == NULL)
+        return -1;
+    value = PyInt_FromSize_t((size_t)count);
+    if (value == NULL) {
+        Py_DECREF(key);
+        return -1;
+    }
+    err = PyDict_SetItem(d, key, value);
+    Py_DECREF(key);
+    Py_DECREF(value);
+    return err;
+}
+
+static PyObject *
+get_opcode_profile(void)
+{
+    PyObject *result, *counts, *pairs, *offsets;
+    Py_ssize_t i, j, n;
+
+    result = PyDict_New();
+    if (result == NULL)
+        return NULL;
+
+    counts = PyList_New(256);
+    if (counts == NULL || PyDict_SetItemString(result, "opcodes", counts))
+        goto error;
+    Py_DECREF(counts);
+    for (i = 0; i < 256; i++) {
+        PyObject *x = PyInt_FromSize_t((size_t)opcode_counts[i]);
+        if (x == NULL)
+            goto error_nocounts;
+        PyList_SET_ITEM(counts, i, x);
+    }
+    counts = NULL;
+
+    pairs = PyDict_New();
+    if (pairs == NULL || PyDict_SetItemString(result, "pairs", pairs)) {
+        Py_XDECREF(pairs);
+        goto error_nocounts;
+    }
+    Py_DECREF(pairs);
+    for (i = 0; i < 256; i++) {
+        for (j = 0; j < 256; j++) {
+            if (opcode_pairs[i][j] == 0)
+                continue;
+            if (add_count(pairs, Py_BuildValue("(nn)", i, j),
+                          opcode_pairs[i][j]) < 0)
+                goto error_nocounts;
+        }
+    }
+
+    offsets = PyDict_New();
+    if (offsets == NULL || PyDict_SetItemString(result, "offsets", offsets)) {
+        Py_XDECREF(offsets);
+        goto error_nocounts;
+    }
+    Py_DECREF(offsets);
+    n = profiled_codes == NULL ? 0 : PyList_GET_SIZE(profiled_codes);
+    for (i = 0; i < n; i++) {
+        PyCodeObject *co = (PyCodeObject *)PyList_GET_ITEM(profiled_codes, i);
+        PyObject *hot = PyDict_New();
+        if (hot == NULL ||
+            PyDict_SetItem(offsets, (PyObject *)co, hot) < 0) {
+            Py_XDECREF(hot);
+            goto error_nocounts;
+        }
+        Py_DECREF(hot);
+        for (j = 0; j < PyString_GET_SIZE(co->co_code); j++) {
+            if (co->co_opcounts[j] == 0)
+                continue;
+            if (add_count(hot, PyInt_FromSsize_t(j),
+                          co->co_opcounts[j]) < 0)
+                goto error_nocounts;
+        }
+    }
+    return result;
+
+  error:
+    Py_XDECREF(counts);
+  error_nocounts:
+    Py_DECREF(result);
+    return NULL;
+}
+
+PyObject *
+_Py_SetOpcodeProfile(PyObject *self, PyObject *args)
+{
+    PyObject *flag;
+
+    if (!PyArg_ParseTuple(args, "O:setopcodeprofile", &flag))
+        return NULL;
+    switch (PyObject_IsTrue(flag)) {
+    case -1:
+        return NULL;
+    case 0:
+        _Py_OpcodeProfiling = 0;
+        break;
+    default:
+        _Py_OpcodeProfiling = 1;
+        break;
+    }
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+PyObject *
+_Py_GetOpcodeProfile(PyObject *self, PyObject *args)
+{
+    PyObject *result;
+    int reset = 0;
+
+    if (!PyArg_ParseTuple(args, "|i:getopcodeprofile", &reset))
+        return NULL;
+    result = get_opcode_profile();
+    if (result != NULL && reset)
+        reset_opcode_profile();
+    return result;
+}
+
+/* LOAD_ATTR and STORE_ATTR inline caches */
+
+#define ATTR_CACHE_UNUSED   0
+#define ATTR_CACHE_DESCR    1   /* data descriptor on the type */
+#define ATTR_CACHE_SLOT     2   /* __slots__ member at offset ac_hint */
+#define ATTR_CACHE_METHOD   3   /* other attribute of the type, the
+                                   instances have no __dict__ */
+#define ATTR_CACHE_DICT     4   /* instance dict, then ac_descr if any */
+
+#define ATTR_CACHE_NOINDEX  USHRT_MAX
+
+static PyAttrCache *
+new_attrcache(PyCodeObject *co)
+{
+    unsigned char *code = (unsigned char *)PyString_AS_STRING(co->co_code);
+    Py_ssize_t i, n = PyString_GET_SIZE(co->co_code);
+    Py_ssize_t nentries = 0;
+    PyAttrCache *cache;
+    int op;
+
+    for (i = 0; i < n; i += HAS_ARG(op) ? 3 : 1) {
+        op = code[i];
+        if ((op == LOAD_ATTR || op == STORE_ATTR) &&
+            nentries < ATTR_CACHE_NOINDEX)
+            nentries++;
+    }
+    if (nentries == 0)
+        nentries = 1;
+    cache = (PyAttrCache *)PyMem_Malloc(
+        sizeof(PyAttrCache) + (nentries - 1) * sizeof(PyAttrCacheEntry) +
+        n * sizeof(unsigned short));
+    if (cache == NULL)
+        return NULL;
+    memset(cache->ac_entries, 0, nentries * sizeof(PyAttrCacheEntry));
+    cache->ac_epoch = _PyType_VersionTagEpoch;
+    cache->ac_size = (int)nentries;
+    cache->ac_index = (unsigned short *)(cache->ac_entries + nentries);
+    for (i = 0; i < n; i++)
+        cache->ac_index[i] = ATTR_CACHE_NOINDEX;
+    nentries = 0;
+    for (i = 0; i < n; i += HAS_ARG(op) ? 3 : 1) {
+        op = code[i];
+        if ((op == LOAD_ATTR || op == STORE_ATTR) &&
+            nentries < ATTR_CACHE_NOINDEX) {
+            /* f_lasti of an instruction with EXTENDED_ARG points to
+               the EXTENDED_ARG */
+            if (i >= 3 && code[i - 3] == EXTENDED_ARG)
+                cache->ac_index[i - 3] = (unsigned short)nentries;
+            cache->ac_index[i] = (unsigned short)nentries++;
+        }
+    }
+    co->co_attrcache = cache;
+    return cache;
+}
+
+/* Return the cache entry of the instruction at offset, or NULL if it
+   has none */
+static PyAttrCacheEntry *
+attrcache_entry(PyCodeObject *co, int offset)
+{
+    PyAttrCache *cache = co->co_attrcache;
+    int i;
+
+    if (cache == NULL) {
+        cache = new_attrcache(co);
+        if (cache == NULL)
+            return NULL;
+    }
+    if (cache->ac_epoch != _PyType_VersionTagEpoch) {
+        /* Version tags were handed out again from 0, forget them */
+        for (i = 0; i < cache->ac_size; i++)
+            cache->ac_entries[i].ac_kind = ATTR_CACHE_UNUSED;
+        cache->ac_epoch = _PyType_VersionTagEpoch;
+    }
+    i = cache->ac_index[offset];
+    if (i == ATTR_CACHE_NOINDEX)
+        return NULL;
+    return &cache->ac_entries[i];
+}
+
+Py_LOCAL_INLINE(int)
+attrcache_valid(PyAttrCacheEntry *e, PyTypeObject *tp)
+{
+    PyTypeObject *dtp = e->ac_descr_type;
+
+    if (e->ac_version != tp->tp_version_tag ||
+        !PyType_HasFeature(tp, Py_TPFLAGS_VALID_VERSION_TAG) ||
+        e->ac_kind == ATTR_CACHE_UNUSED)
+        return 0;
+    /* Whether a heap type descriptor has __get__ and __set__ can change
+       without touching the type the descriptor was found on */
+    return dtp == NULL ||
+        (Py_TYPE(e->ac_descr) == dtp &&
+         dtp->tp_version_tag == e->ac_descr_version &&
+         PyType_HasFeature(dtp, Py_TPFLAGS_VALID_VERSION_TAG));
+}
+
+/* Look up name in the cache entry for v, the way PyObject_GenericGetAttr()
+   (or PyObject_GenericSetAttr() if store is true) would.  Returns 0 if
+   the attribute can't be cached, then the generic code has to run. */
+static int
+fill_attrcache(PyAttrCacheEntry *e, PyTypeObject *tp, PyObject *v,
+               PyObject *name, int store)
+{
+    PyObject *descr;
+    PyTypeObject *dtp = NULL;
+    PyMemberDef *member;
+    int data = 0;
+
+    e->ac_kind = ATTR_CACHE_UNUSED;
+    if (!PyString_CheckExact(name) ||
+        ((PyStringObject *)name)->ob_shash == -1 ||
+        tp->tp_dict == NULL || tp->tp_dictoffset < 0)
+        return 0;
+    descr = _PyType_Lookup(tp, name);
+    if (!_PyType_AssignVersionTag(tp))
+        return 0;
+    if (descr != NULL) {
+        dtp = Py_TYPE(descr);
+        if (PyType_HasFeature(dtp, Py_TPFLAGS_HAVE_CLASS))
+            data = store ? dtp->tp_descr_set != NULL :
+                dtp->tp_descr_get != NULL && PyDescr_IsData(descr);
+        if (PyType_HasFeature(dtp, Py_TPFLAGS_HEAPTYPE)) {
+            if (!_PyType_AssignVersionTag(dtp))
+                return 0;
+            e->ac_descr_version = dtp->tp_version_tag;
+        }
+        else
+            dtp = NULL;
+    }
+    e->ac_version = tp->tp_version_tag;
+    e->ac_descr = descr;
+    e->ac_descr_type = dtp;
+    e->ac_hint = 0;
+    if (data) {
+        e->ac_kind = ATTR_CACHE_DESCR;
+        if (Py_TYPE(descr) == &PyMemberDescr_Type &&
+            PyObject_TypeCheck(v, ((PyMemberDescrObject *)descr)->d_type)) {
+            member = ((PyMemberDescrObject *)descr)->d_member;
+            if (member->type == T_OBJECT_EX &&
+                (store ? member->flags == 0 :
+                 !(member->flags & READ_RESTRICTED))) {
+                e->ac_kind = ATTR_CACHE_SLOT;
+                e->ac_hint = member->offset;
+            }
+        }
+    }
+    else if (tp->tp_dictoffset != 0)
+        e->ac_kind = ATTR_CACHE_DICT;
+    else if (!store)
+        e->ac_kind = ATTR_CACHE_METHOD;
+    return e->ac_kind != ATTR_CACHE_UNUSED;
+}
+
+/* Return the active entry for name in the instance dict mp, trying the
+   slot the entry found it in last time first */
+static PyDictEntry *
+attrcache_dict_entry(PyDictObject *mp, PyObject *name, PyAttrCacheEntry *e)
+{
+    PyDictEntry *ep;
+
+    if (e->ac_hint <= mp->ma_mask) {
+        ep = &mp->ma_table[e->ac_hint];
+        if (ep->me_key == name && ep->me_value != NULL)
+            return ep;
+    }
+    ep = (mp->ma_lookup)(mp, name, ((PyStringObject *)name)->ob_shash);
+    if (ep == NULL) {
+        /* Like PyDict_GetItem(), ignore errors */
+        PyErr_Clear();
+        return NULL;
+    }
+    if (ep->me_value == NULL)
+        return NULL;
+    e->ac_hint = ep - mp->ma_table;
+    return ep;
+}
+
+static PyObject *
+load_attr(PyCodeObject *co, int offset, PyObject *v, PyObject *name)
+{
+    PyTypeObject *tp = Py_TYPE(v);
+    PyAttrCacheEntry *e;
+    PyObject *descr, *dict, *res;
+    PyDictEntry *ep;
+    descrgetfunc f;
+
+    if (tp->tp_getattro != PyObject_GenericGetAttr ||
+        (e = attrcache_entry(co, offset)) == NULL)
+        return PyObject_GetAttr(v, name);
+    if (!attrcache_valid(e, tp) && !fill_attrcache(e, tp, v, name, 0))
+        return PyObject_GetAttr(v, name);
+    descr = e->ac_descr;
+    switch (e->ac_kind) {
+    case ATTR_CACHE_SLOT:
+        res = *(PyObject **)((char *)v + e->ac_hint);
+        if (res == NULL)
+            break;      /* the generic code raises AttributeError */
+        Py_INCREF(res);
+        return res;
+    case ATTR_CACHE_DESCR:
+        Py_INCREF(descr);
+        res = Py_TYPE(descr)->tp_descr_get(descr, v, (PyObject *)tp);
+        Py_DECREF(descr);
+        return res;
+    case ATTR_CACHE_METHOD:
+    case ATTR_CACHE_DICT:
+        f = NULL;
+        if (descr != NULL) {
+            if (PyType_HasFeature(Py_TYPE(descr), Py_TPFLAGS_HAVE_CLASS))
+                f = Py_TYPE(descr)->tp_descr_get;
+            /* The instance dict lookup can run code that changes the
+               type, hold on to the attribute like the generic code */
+            Py_INCREF(descr);
+        }
+        if (e->ac_kind == ATTR_CACHE_DICT) {
+            dict = *(PyObject **)((char *)v + tp->tp_dictoffset);
+            if (dict != NULL && PyDict_Check(dict)) {
+                ep = attrcache_dict_entry((PyDictObject *)dict, name, e);
+                if (ep != NULL) {
+                    res = ep->me_value;
+                    Py_INCREF(res);
+                    Py_XDECREF(descr);
+                    return res;
+                }
+            }
+        }
+        if (descr == NULL)
+            break;      /* the generic code raises AttributeError */
+        if (f != NULL) {
+            res = f(descr, v, (PyObject *)tp);
+            Py_DECREF(descr);
+            return res;
+        }
+        return descr;
+    }
+    return PyObject_GetAttr(v, name);
+}
+
+static int
+store_attr(PyCodeObject *co, int offset, PyObject *v, PyObject *name,
+           PyObject *value)
+{
+    PyTypeObject *tp = Py_TYPE(v);
+    PyAttrCacheEntry *e;
+    PyObject *descr, *dict, *old;
+    PyObject **addr;
+    PyDictEntry *ep;
+    int err;
+
+    if (tp->tp_setattro != PyObject_GenericSetAttr ||
+        (e = attrcache_entry(co, offset)) == NULL)
+        return PyObject_SetAttr(v, name, value);
+    if (!attrcache_valid(e, tp) && !fill_attrcache(e, tp, v, name, 1))
+        return PyObject_SetAttr(v, name, value);
+    descr = e->ac_descr;
+    switch (e->ac_kind) {
+    case ATTR_CACHE_SLOT:
+        addr = (PyObject **)((char *)v + e->ac_hint);
+        old = *addr;
+        Py_INCREF(value);
+        *addr = value;
+        Py_XDECREF(old);
+        return 0;
+    case ATTR_CACHE_DESCR:
+        Py_INCREF(descr);
+        err = Py_TYPE(descr)->tp_descr_set(descr, v, value);
+        Py_DECREF(descr);
+        return err;
+    case ATTR_CACHE_DICT:
+        dict = *(PyObject **)((char *)v + tp->tp_dictoffset);
+        if (dict == NULL || !PyDict_Check(dict))
+            break;
+        ep = attrcache_dict_entry((PyDictObject *)dict, name, e);
+        if (ep == NULL) {
+            Py_INCREF(dict);
+            err = PyDict_SetItem(dict, name, value);
+            Py_DECREF(dict);
+            return err;
+        }
+        /* Replace the value in place, as insertdict() does */
+        if (!_PyObject_GC_IS_TRACKED(dict) &&
+            _PyObject_GC_MAY_BE_TRACKED(value))
+            _PyObject_GC_TRACK(dict);
+        old = ep->me_value;
+        Py_INCREF(value);
+        ep->me_value = value;
+        Py_DECREF(old);
+        return 0;
+    }
+    return PyObject_SetAttr(v, name, value);
+}
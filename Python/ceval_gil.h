@@ -0,0 +1,452 @@
+/*
+ * Implementation of the Global Interpreter Lock (GIL).
+ *
+ * Included by ceval.c, inside its WITH_THREAD section.
+ */
+
+#include <errno.h>
+
+/* Notes about the implementation:
+
+   - With pthreads, the GIL is a boolean variable (gil_locked) protected
+     by a mutex (gil_mutex), with a condition variable (gil_cond) on
+     which threads wait for it to be released.
+
+   - A thread holding the GIL keeps it until it blocks (e.g. in
+     Py_BEGIN_ALLOW_THREADS) or until another thread asks for it: a
+     thread waiting for the GIL waits on gil_cond for at most the switch
+     interval (see sys.setswitchinterval(), 5 ms by default).  If the GIL
+     has not changed hands in the meantime, it sets gil_drop_request
+     and zeroes _Py_Ticker, so that the running thread does the periodic
+     checks of the eval loop on its next instruction, sees the request
+     and drops the GIL.
+
+     _Py_Ticker is decremented by the running thread without any
+     locking, so the zeroing can be lost; the request is then seen at
+     the next periodic check, at most _Py_CheckInterval instructions
+     later.  sys.setcheckinterval() still sets how often the pending
+     calls and signals are checked, it no longer decides when threads
+     switch.
+
+   - A thread coming back from a blocking call (PyEval_RestoreThread(),
+     i.e. the end of a Py_BEGIN_ALLOW_THREADS block) sets the drop request
+     at once if the GIL is held, instead of after a switch interval.
+     Such a thread was usually waiting for I/O, a lock or a timer and
+     has little to do before it blocks again; making it wait behind a
+     CPU-bound thread for a whole interval would add the interval to the
+     latency of every I/O operation.  While it waits, it goes before the
+     threads that merely wait for their turn (gil_priority_waiters).
+     Threads that lost the GIL to a drop request still wait for the
+     interval, so CPU-bound threads switch every interval, not every
+     instruction.
+
+   - A thread that drops the GIL because of a drop request waits on
+     switch_cond until some other thread has taken it (FORCE_SWITCHING).
+     Without that, the dropping thread, which was running and is hot in
+     the CPU, would usually take the GIL back before the waiting thread
+     is even scheduled: the waiting (often I/O-bound) thread would starve
+     behind a CPU-bound one ("convoy effect").
+
+   - Compiling with -DUSE_COND_GIL=0, and on platforms without pthreads,
+     the GIL is a plain PyThread lock as before: the running thread drops
+     and re-acquires it at every periodic check, the switch interval is
+     ignored and there are no forced switches.
+
+   - Both implementations record how many times and how long threads
+     waited for and held the GIL, see sys.getgilstats().  The counters
+     are updated by the thread holding the GIL, except forced_switches
+     which is updated under switch_mutex.
+*/
+
+#ifndef _POSIX_THREADS
+/* This means pthreads are not implemented in libc headers, hence the macro
+   not present in unistd.h. But they still can be implemented as an external
+   library (e.g. gnu pth in pthread emulation) */
+# ifdef HAVE_PTHREAD_H
+#  include <pthread.h> /* _POSIX_THREADS */
+# endif
+#endif
+
+#ifndef USE_COND_GIL
+#ifdef _POSIX_THREADS
+#define USE_COND_GIL 1
+#else
+#define USE_COND_GIL 0
+#endif
+#endif
+
+/* Statistics, see sys.getgilstats() */
+static struct {
+    unsigned long switches;         /* GIL taken by another thread than the
+                                       one that held it last */
+    unsigned long drop_requests;    /* requests from waiting threads */
+    unsigned long forced_switches;  /* drops that waited for a switch */
+    unsigned long waits;            /* acquisitions that had to wait */
+    double wait_time, max_wait_time;
+    double hold_time, max_hold_time;
+} gil_stats;
+
+static double gil_taken_at = 0.0;
+
+#ifdef GETTIMEOFDAY_NO_TZ
+#define GETTIMEOFDAY(ptv) gettimeofday(ptv)
+#else
+#define GETTIMEOFDAY(ptv) gettimeofday(ptv, (struct timezone *)NULL)
+#endif
+
+static double
+gil_time(void)
+{
+#ifdef HAVE_GETTIMEOFDAY
+    struct timeval t;
+    GETTIMEOFDAY(&t);
+    return (double)t.tv_sec + t.tv_usec * 1e-6;
+#else
+    return 0.0;
+#endif
+}
+
+static void
+gil_record_wait(double t0)
+{
+    double waited = gil_time() - t0;
+    if (waited < 0.0)
+        waited = 0.0;
+    gil_stats.waits++;
+    gil_stats.wait_time += waited;
+    if (waited > gil_stats.max_wait_time)
+        gil_stats.max_wait_time = waited;
+}
+
+static void
+gil_record_hold(void)
+{
+    double held = gil_time() - gil_taken_at;
+    if (held < 0.0)
+        held = 0.0;
+    gil_stats.hold_time += held;
+    if (held > gil_stats.max_hold_time)
+        gil_stats.max_hold_time = held;
+}
+
+/* Microseconds, see sys.setswitchinterval() */
+#define DEFAULT_INTERVAL 5000
+static unsigned long gil_interval = DEFAULT_INTERVAL;
+#define INTERVAL (gil_interval >= 1 ? gil_interval : 1)
+
+static PyThreadState *volatile gil_last_holder = NULL;
+
+#if USE_COND_GIL
+
+#include <pthread.h>
+
+#define FORCE_SWITCHING
+
+/* -1 until create_gil() is called, then 0 or 1 */
+static volatile int gil_locked = -1;
+/* Incremented each time the GIL changes hands */
+static volatile unsigned long gil_switch_number = 0;
+/* Set by a thread that waited for the GIL for the switch interval, or
+   that came back from a blocking call and found it held */
+static volatile int gil_drop_request = 0;
+/* Threads back from a blocking call waiting for the GIL, under gil_mutex */
+static int gil_priority_waiters = 0;
+
+static pthread_mutex_t gil_mutex;
+static pthread_cond_t gil_cond;
+#ifdef FORCE_SWITCHING
+/* Held by the thread dropping the GIL until another one takes it */
+static pthread_mutex_t switch_mutex;
+static pthread_cond_t switch_cond;
+#endif
+
+#define GIL_DROP_REQUESTED() (gil_drop_request)
+
+#define SET_GIL_DROP_REQUEST() \
+    do { \
+        gil_drop_request = 1; \
+        _Py_Ticker = 0; \
+    } while (0)
+
+#define RESET_GIL_DROP_REQUEST() \
+    do { \
+        gil_drop_request = 0; \
+    } while (0)
+
+#define MUTEX_INIT(mut) \
+    if (pthread_mutex_init(&(mut), NULL)) { \
+        Py_FatalError("pthread_mutex_init(" #mut ") failed"); }
+#define MUTEX_LOCK(mut) \
+    if (pthread_mutex_lock(&(mut))) { \
+        Py_FatalError("pthread_mutex_lock(" #mut ") failed"); }
+#define MUTEX_UNLOCK(mut) \
+    if (pthread_mutex_unlock(&(mut))) { \
+        Py_FatalError("pthread_mutex_unlock(" #mut ") failed"); }
+
+#define COND_INIT(cond) \
+    if (pthread_cond_init(&(cond), NULL)) { \
+        Py_FatalError("pthread_cond_init(" #cond ") failed"); }
+#define COND_SIGNAL(cond) \
+    if (pthread_cond_signal(&(cond))) { \
+        Py_FatalError("pthread_cond_signal(" #cond ") failed"); }
+#define COND_BROADCAST(cond) \
+    if (pthread_cond_broadcast(&(cond))) { \
+        Py_FatalError("pthread_cond_broadcast(" #cond ") failed"); }
+#define COND_WAIT(cond, mut) \
+    if (pthread_cond_wait(&(cond), &(mut))) { \
+        Py_FatalError("pthread_cond_wait(" #cond ") failed"); }
+
+/* Wait on cond for at most the given number of microseconds; return 1
+   if the wait timed out */
+static int
+cond_timed_wait(pthread_cond_t *cond, pthread_mutex_t *mut,
+                unsigned long microseconds)
+{
+    struct timeval now;
+    struct timespec deadline;
+    long usec;
+    int r;
+
+    GETTIMEOFDAY(&now);
+    usec = now.tv_usec + (long)(microseconds % 1000000);
+    deadline.tv_sec = now.tv_sec + microseconds / 1000000 + usec / 1000000;
+    deadline.tv_nsec = (usec % 1000000) * 1000;
+    r = pthread_cond_timedwait(cond, mut, &deadline);
+    if (r == ETIMEDOUT)
+        return 1;
+    if (r)
+        Py_FatalError("pthread_cond_timedwait(gil_cond) failed");
+    return 0;
+}
+
+static int
+gil_created(void)
+{
+    return gil_locked >= 0;
+}
+
+static void
+create_gil(void)
+{
+    MUTEX_INIT(gil_mutex);
+#ifdef FORCE_SWITCHING
+    MUTEX_INIT(switch_mutex);
+#endif
+    COND_INIT(gil_cond);
+#ifdef FORCE_SWITCHING
+    COND_INIT(switch_cond);
+#endif
+    gil_last_holder = NULL;
+    gil_drop_request = 0;
+    gil_priority_waiters = 0;
+    gil_locked = 0;
+}
+
+/* After fork(), the child re-creates the GIL: the mutexes may have been
+   held by threads that do not exist in the child */
+static void
+recreate_gil(void)
+{
+    create_gil();
+}
+
+static void
+drop_gil(PyThreadState *tstate)
+{
+    if (gil_locked != 1)
+        Py_FatalError("drop_gil: GIL is not locked");
+    /* tstate is NULL when the current thread state was just deleted.
+       Otherwise, threads may have been switched under our feet with
+       PyThreadState_Swap(). */
+    if (tstate != NULL)
+        gil_last_holder = tstate;
+    gil_record_hold();
+
+    MUTEX_LOCK(gil_mutex);
+    gil_locked = 0;
+    /* A signal could wake a thread that has to let a priority waiter go
+       first, and the priority waiter would sleep on */
+    if (gil_priority_waiters) {
+        COND_BROADCAST(gil_cond);
+    }
+    else {
+        COND_SIGNAL(gil_cond);
+    }
+    MUTEX_UNLOCK(gil_mutex);
+
+#ifdef FORCE_SWITCHING
+    if (gil_drop_request && tstate != NULL) {
+        MUTEX_LOCK(switch_mutex);
+        /* Not switched yet => wait */
+        if (gil_last_holder == tstate) {
+            RESET_GIL_DROP_REQUEST();
+            /* NOTE: if COND_WAIT does not atomically start waiting when
+               releasing the mutex, another thread can run through, take
+               the GIL and drop it again, and reset the condition
+               before we even had a chance to wait for it. */
+            COND_WAIT(switch_cond, switch_mutex);
+            gil_stats.forced_switches++;
+        }
+        MUTEX_UNLOCK(switch_mutex);
+    }
+#endif
+}
+
+/* after_blocking is true when called from PyEval_RestoreThread() */
+static void
+take_gil(PyThreadState *tstate, int after_blocking)
+{
+    int err;
+    int waited = 0;
+    int priority = 0;
+    unsigned long drop_requests = 0;
+    double t0 = 0.0;
+
+    err = errno;
+    MUTEX_LOCK(gil_mutex);
+
+    if (gil_locked || gil_priority_waiters) {
+        waited = 1;
+        t0 = gil_time();
+        if (after_blocking) {
+            priority = 1;
+            gil_priority_waiters++;
+            if (gil_locked) {
+                SET_GIL_DROP_REQUEST();
+                drop_requests++;
+            }
+        }
+    }
+    while (gil_locked || (!priority && gil_priority_waiters)) {
+        unsigned long saved_switchnum = gil_switch_number;
+        int timed_out = cond_timed_wait(&gil_cond, &gil_mutex, INTERVAL);
+        /* If we timed out and no switch occurred in the meantime, it is
+           time to ask the GIL-holding thread to drop it. */
+        if (timed_out && gil_locked &&
+            gil_switch_number == saved_switchnum) {
+            SET_GIL_DROP_REQUEST();
+            drop_requests++;
+        }
+    }
+    if (priority)
+        gil_priority_waiters--;
+
+#ifdef FORCE_SWITCHING
+    /* This mutex must be taken before modifying gil_last_holder (see
+       drop_gil()). */
+    MUTEX_LOCK(switch_mutex);
+#endif
+    /* We now hold the GIL */
+    gil_locked = 1;
+
+    if (tstate != gil_last_holder) {
+        gil_last_holder = tstate;
+        ++gil_switch_number;
+        gil_stats.switches++;
+    }
+
+#ifdef FORCE_SWITCHING
+    COND_SIGNAL(switch_cond);
+    MUTEX_UNLOCK(switch_mutex);
+#endif
+    if (gil_drop_request)
+        RESET_GIL_DROP_REQUEST();
+    MUTEX_UNLOCK(gil_mutex);
+
+    gil_stats.drop_requests += drop_requests;
+    if (waited)
+        gil_record_wait(t0);
+    gil_taken_at = gil_time();
+    errno = err;
+}
+
+#else /* !USE_COND_GIL */
+
+static PyThread_type_lock interpreter_lock = 0;
+
+#define GIL_DROP_REQUESTED() (interpreter_lock != 0)
+
+static int
+gil_created(void)
+{
+    return interpreter_lock != 0;
+}
+
+static void
+create_gil(void)
+{
+    interpreter_lock = PyThread_allocate_lock();
+    gil_last_holder = NULL;
+}
+
+/* XXX Can't use PyThread_free_lock here because it does too much
+   error-checking.  Doing this cleanly would require adding a new
+   function to each thread_*.h.  Instead, just create a new lock and
+   waste a little bit of memory */
+static void
+recreate_gil(void)
+{
+    create_gil();
+}
+
+static void
+drop_gil(PyThreadState *tstate)
+{
+    if (tstate != NULL)
+        gil_last_holder = tstate;
+    gil_record_hold();
+    PyThread_release_lock(interpreter_lock);
+}
+
+static void
+take_gil(PyThreadState *tstate, int after_blocking)
+{
+    int err = errno;
+
+    if (!PyThread_acquire_lock(interpreter_lock, NOWAIT_LOCK)) {
+        double t0 = gil_time();
+        PyThread_acquire_lock(interpreter_lock, WAIT_LOCK);
+        gil_record_wait(t0);
+    }
+    if (tstate != gil_last_holder) {
+        gil_last_holder = tstate;
+        gil_stats.switches++;
+    }
+    gil_taken_at = gil_time();
+    errno = err;
+}
+
+#endif /* USE_COND_GIL */
+
+void
+_PyEval_SetSwitchInterval(unsigned long microseconds)
+{
+    gil_interval = microseconds;
+}
+
+unsigned long
+_PyEval_GetSwitchInterval(void)
+{
+    return gil_interval;
+}
+
+static PyObject *
+get_gil_stats(void)
+{
+    return Py_BuildValue("{sksksksksdsdsdsd}",
+                         "switches", gil_stats.switches,
+                         "drop_requests", gil_stats.drop_requests,
+                         "forced_switches", gil_stats.forced_switches,
+                         "waits", gil_stats.waits,
+                         "wait_time", gil_stats.wait_time,
+                         "max_wait_time", gil_stats.max_wait_time,
+                         "hold_time", gil_stats.hold_time,
+                         "max_hold_time", gil_stats.max_hold_time);
+}
+
+static void
+reset_gil_stats(void)
+{
+    memset(&gil_stats, 0, sizeof(gil_stats));
+    gil_taken_at = gil_time();
+}
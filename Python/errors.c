@@ -26,6 +26,7 @@ PyErr_Restore(PyObject *type, PyObject *value, PyObject *traceback)
 {
     PyThreadState *tstate = PyThreadState_GET();
     PyObject *oldtype, *oldvalue, *oldtraceback;
+    PyObject *oldargs[2] = {NULL, NULL};
 
     if (traceback != NULL && !PyTraceBack_Check(traceback)) {
         /* XXX Should never happen -- fatal error instead? */
@@ -44,9 +45,78 @@ PyErr_Restore(PyObject *type, PyObject *value, PyObject *traceback)
     tstate->curexc_value = value;
     tstate->curexc_traceback = traceback;
 
+    if (tstate->curexc_build != NULL) {
+        /* Drop the deferred value of the replaced exception */
+        tstate->curexc_build = NULL;
+        oldargs[0] = tstate->curexc_args[0];
+        oldargs[1] = tstate->curexc_args[1];
+        tstate->curexc_args[0] = NULL;
+        tstate->curexc_args[1] = NULL;
+    }
+
     Py_XDECREF(oldtype);
     Py_XDECREF(oldvalue);
     Py_XDECREF(oldtraceback);
+    Py_XDECREF(oldargs[0]);
+    Py_XDECREF(oldargs[1]);
+}
+
+/* Raising an exception that the caller tests and clears is common:
+   hasattr(), getattr() with a default, __getattr__ hooks and lookups of
+   optional special methods all do it.  Building the value of such an
+   exception, often a formatted message, is wasted work.  With
+   _PyErr_SetDeferred() only the type is set; build(a, b) is kept in the
+   thread state and called when PyErr_Fetch() gives the value away.  The
+   value is whatever PyErr_SetObject() would have been passed, so the
+   exception looks the same once normalized. */
+void
+_PyErr_SetDeferred(PyObject *type, PyObject *(*build)(PyObject *, PyObject *),
+                   PyObject *a, PyObject *b)
+{
+    PyThreadState *tstate;
+
+    Py_INCREF(type);
+    PyErr_Restore(type, NULL, NULL);
+    tstate = PyThreadState_GET();
+    Py_XINCREF(a);
+    Py_XINCREF(b);
+    tstate->curexc_build = build;
+    tstate->curexc_args[0] = a;
+    tstate->curexc_args[1] = b;
+}
+
+/* Give the pending exception of tstate its deferred value.  If building it
+   fails, the new error replaces the exception. */
+static void
+build_deferred_value(PyThreadState *tstate)
+{
+    PyObject *a = tstate->curexc_args[0], *b = tstate->curexc_args[1];
+    PyObject *value;
+
+    tstate->curexc_args[0] = NULL;
+    tstate->curexc_args[1] = NULL;
+    value = tstate->curexc_build(a, b);
+    tstate->curexc_build = NULL;
+    Py_XDECREF(a);
+    Py_XDECREF(b);
+    if (value != NULL) {
+        assert(tstate->curexc_value == NULL);
+        tstate->curexc_value = value;
+    }
+}
+
+static PyObject *
+key_error_value(PyObject *key, PyObject *unused)
+{
+    /* Wrap the key in a tuple so that a tuple key is not unpacked as the
+       exception arguments */
+    return PyTuple_Pack(1, key);
+}
+
+void
+_PyErr_SetKeyError(PyObject *key)
+{
+    _PyErr_SetDeferred(PyExc_KeyError, key_error_value, key, NULL);
 }
 
 void
@@ -248,6 +318,8 @@ PyErr_Fetch(PyObject **p_type, PyObject **p_value, PyObject **p_traceback)
 {
     PyThreadState *tstate = PyThreadState_GET();
 
+    if (tstate->curexc_build != NULL)
+        build_deferred_value(tstate);
     *p_type = tstate->curexc_type;
     *p_value = tstate->curexc_value;
     *p_traceback = tstate->curexc_traceback;
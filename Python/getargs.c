@@ -26,8 +26,15 @@ PyAPI_FUNC(int) _PyArg_ParseTupleAndKeywords_SizeT(PyObject *, PyObject *,
                                                   const char *, char **, ...);
 PyAPI_FUNC(PyObject *) _Py_BuildValue_SizeT(const char *, ...);
 PyAPI_FUNC(int) _PyArg_VaParse_SizeT(PyObject *, char *, va_list);
+PyAPI_FUNC(int) _PyArg_ParseStack_SizeT(PyObject **, Py_ssize_t,
+                                        const char *, ...);
 PyAPI_FUNC(int) _PyArg_VaParseTupleAndKeywords_SizeT(PyObject *, PyObject *,
                                               const char *, char **, va_list);
+PyAPI_FUNC(int) _PyArg_ParseTupleAndKeywordsFast_SizeT(PyObject *, PyObject *,
+                                              struct _PyArg_Parser *, ...);
+PyAPI_FUNC(int) _PyArg_ParseStackAndKeywords_SizeT(PyObject **, Py_ssize_t,
+                                              PyObject *,
+                                              struct _PyArg_Parser *, ...);
 #endif
 
 #define FLAG_COMPAT 1
@@ -36,6 +43,8 @@ PyAPI_FUNC(int) _PyArg_VaParseTupleAndKeywords_SizeT(PyObject *, PyObject *,
 
 /* Forward */
 static int vgetargs1(PyObject *, const char *, va_list *, int);
+static int vgetargs1_impl(PyObject *, PyObject **, Py_ssize_t,
+                          const char *, va_list *, int);
 static void seterror(int, const char *, int *, const char *, const char *);
 static char *convertitem(PyObject *, const char **, va_list *, int, int *,
                          char *, size_t, PyObject **);
@@ -48,6 +57,9 @@ static int getbuffer(PyObject *, Py_buffer *, char**);
 
 static int vgetargskeywords(PyObject *, PyObject *,
                             const char *, char **, va_list *, int);
+static int vgetargskeywordsfast(PyObject **, Py_ssize_t, PyObject *,
+                                PyObject *, struct _PyArg_Parser *,
+                                va_list *, int);
 static char *skipitem(const char **, va_list *, int);
 
 int
@@ -100,6 +112,34 @@ _PyArg_ParseTuple_SizeT(PyObject *args, char *format, ...)
 }
 
 
+/* Like PyArg_ParseTuple(), for the nargs arguments in the C array args
+   that METH_FASTCALL functions get instead of a tuple */
+int
+_PyArg_ParseStack(PyObject **args, Py_ssize_t nargs, const char *format, ...)
+{
+    int retval;
+    va_list va;
+
+    va_start(va, format);
+    retval = vgetargs1_impl(NULL, args, nargs, format, &va, 0);
+    va_end(va);
+    return retval;
+}
+
+int
+_PyArg_ParseStack_SizeT(PyObject **args, Py_ssize_t nargs,
+                        const char *format, ...)
+{
+    int retval;
+    va_list va;
+
+    va_start(va, format);
+    retval = vgetargs1_impl(NULL, args, nargs, format, &va, FLAG_SIZE_T);
+    va_end(va);
+    return retval;
+}
+
+
 int
 PyArg_VaParse(PyObject *args, const char *format, va_list va)
 {
@@ -211,6 +251,28 @@ cleanreturn(int retval, PyObject *freelist)
 
 static int
 vgetargs1(PyObject *args, const char *format, va_list *p_va, int flags)
+{
+    PyObject **stack = NULL;
+    Py_ssize_t nargs = 0;
+
+    if (!(flags & FLAG_COMPAT)) {
+        assert(args != NULL);
+        if (!PyTuple_Check(args)) {
+            PyErr_SetString(PyExc_SystemError,
+                "new style getargs format but argument is not a tuple");
+            return 0;
+        }
+        stack = &PyTuple_GET_ITEM(args, 0);
+        nargs = PyTuple_GET_SIZE(args);
+    }
+    return vgetargs1_impl(args, stack, nargs, format, p_va, flags);
+}
+
+/* compat_args is the single argument of PyArg_Parse(), without
+   FLAG_COMPAT the arguments are the nargs items of stack */
+static int
+vgetargs1_impl(PyObject *compat_args, PyObject **stack, Py_ssize_t nargs,
+               const char *format, va_list *p_va, int flags)
 {
     char msgbuf[256];
     int levels[32];
@@ -226,7 +288,7 @@ vgetargs1(PyObject *args, const char *format, va_list *p_va, int flags)
     PyObject *freelist = NULL;
     int compat = flags & FLAG_COMPAT;
 
-    assert(compat || (args != (PyObject*)NULL));
+    assert(compat || nargs == 0 || stack != NULL);
     flags = flags & ~FLAG_COMPAT;
 
     while (endfmt == 0) {
@@ -281,7 +343,7 @@ vgetargs1(PyObject *args, const char *format, va_list *p_va, int flags)
 
     if (compat) {
         if (max == 0) {
-            if (args == NULL)
+            if (compat_args == NULL)
                 return 1;
             PyOS_snprintf(msgbuf, sizeof(msgbuf),
                           "%.200s%s takes no arguments",
@@ -291,7 +353,7 @@ vgetargs1(PyObject *args, const char *format, va_list *p_va, int flags)
             return 0;
         }
         else if (min == 1 && max == 1) {
-            if (args == NULL) {
+            if (compat_args == NULL) {
                 PyOS_snprintf(msgbuf, sizeof(msgbuf),
                       "%.200s%s takes at least one argument",
                           fname==NULL ? "function" : fname,
@@ -299,7 +361,7 @@ vgetargs1(PyObject *args, const char *format, va_list *p_va, int flags)
                 PyErr_SetString(PyExc_TypeError, msgbuf);
                 return 0;
             }
-            msg = convertitem(args, &format, p_va, flags, levels,
+            msg = convertitem(compat_args, &format, p_va, flags, levels,
                               msgbuf, sizeof(msgbuf), &freelist);
             if (msg == NULL)
                 return cleanreturn(1, freelist);
@@ -313,13 +375,7 @@ vgetargs1(PyObject *args, const char *format, va_list *p_va, int flags)
         }
     }
 
-    if (!PyTuple_Check(args)) {
-        PyErr_SetString(PyExc_SystemError,
-            "new style getargs format but argument is not a tuple");
-        return 0;
-    }
-
-    len = PyTuple_GET_SIZE(args);
+    len = nargs;
 
     if (len < min || max < len) {
         if (message == NULL) {
@@ -342,7 +398,7 @@ vgetargs1(PyObject *args, const char *format, va_list *p_va, int flags)
     for (i = 0; i < len; i++) {
         if (*format == '|')
             format++;
-        msg = convertitem(PyTuple_GET_ITEM(args, i), &format, p_va,
+        msg = convertitem(stack[i], &format, p_va,
                           flags, levels, msgbuf,
                           sizeof(msgbuf), &freelist);
         if (msg) {
@@ -1687,6 +1743,376 @@ vgetargskeywords(PyObject *args, PyObject *keywords, const char *format,
 }
 
 
+/* Precompiled keyword parsers (struct _PyArg_Parser).  The format is
+   checked and the keyword names are interned once, on the first call;
+   vgetargskeywordsfast() then looks the keywords up with the interned
+   names, which for a dict of keyword arguments built from identifiers
+   in the caller's code usually matches by identity. */
+
+int
+_PyArg_ParseTupleAndKeywordsFast(PyObject *args, PyObject *keywords,
+                                 struct _PyArg_Parser *parser, ...)
+{
+    int retval;
+    va_list va;
+
+    if ((args == NULL || !PyTuple_Check(args)) ||
+        (keywords != NULL && !PyDict_Check(keywords)) ||
+        parser == NULL)
+    {
+        PyErr_BadInternalCall();
+        return 0;
+    }
+
+    va_start(va, parser);
+    retval = vgetargskeywordsfast(&PyTuple_GET_ITEM(args, 0),
+                                  PyTuple_GET_SIZE(args), keywords, NULL,
+                                  parser, &va, 0);
+    va_end(va);
+    return retval;
+}
+
+int
+_PyArg_ParseTupleAndKeywordsFast_SizeT(PyObject *args, PyObject *keywords,
+                                       struct _PyArg_Parser *parser, ...)
+{
+    int retval;
+    va_list va;
+
+    if ((args == NULL || !PyTuple_Check(args)) ||
+        (keywords != NULL && !PyDict_Check(keywords)) ||
+        parser == NULL)
+    {
+        PyErr_BadInternalCall();
+        return 0;
+    }
+
+    va_start(va, parser);
+    retval = vgetargskeywordsfast(&PyTuple_GET_ITEM(args, 0),
+                                  PyTuple_GET_SIZE(args), keywords, NULL,
+                                  parser, &va, FLAG_SIZE_T);
+    va_end(va);
+    return retval;
+}
+
+/* The same for a METH_FASTCALL function: the values of the keyword
+   arguments follow the nargs positional ones in args, their names are
+   in the kwnames tuple (or kwnames is NULL) */
+int
+_PyArg_ParseStackAndKeywords(PyObject **args, Py_ssize_t nargs,
+                             PyObject *kwnames,
+                             struct _PyArg_Parser *parser, ...)
+{
+    int retval;
+    va_list va;
+
+    if ((kwnames != NULL && !PyTuple_Check(kwnames)) ||
+        parser == NULL)
+    {
+        PyErr_BadInternalCall();
+        return 0;
+    }
+
+    va_start(va, parser);
+    retval = vgetargskeywordsfast(args, nargs, NULL, kwnames,
+                                  parser, &va, 0);
+    va_end(va);
+    return retval;
+}
+
+int
+_PyArg_ParseStackAndKeywords_SizeT(PyObject **args, Py_ssize_t nargs,
+                                   PyObject *kwnames,
+                                   struct _PyArg_Parser *parser, ...)
+{
+    int retval;
+    va_list va;
+
+    if ((kwnames != NULL && !PyTuple_Check(kwnames)) ||
+        parser == NULL)
+    {
+        PyErr_BadInternalCall();
+        return 0;
+    }
+
+    va_start(va, parser);
+    retval = vgetargskeywordsfast(args, nargs, NULL, kwnames,
+                                  parser, &va, FLAG_SIZE_T);
+    va_end(va);
+    return retval;
+}
+
+/* Initialized parsers, so that _PyArg_Fini() can release their names */
+static struct _PyArg_Parser *static_arg_parsers = NULL;
+
+static int
+parser_init(struct _PyArg_Parser *parser)
+{
+    const char * const *keywords;
+    const char *format, *msg;
+    int i, len, min;
+    PyObject *kwtuple;
+
+    assert(parser->format != NULL);
+    assert(parser->keywords != NULL);
+    if (parser->kwtuple != NULL)
+        return 1;
+
+    keywords = parser->keywords;
+    for (len = 0; keywords[len]; len++)
+        continue;
+
+    /* Same checks as vgetargskeywords() does on every call */
+    min = INT_MAX;
+    format = parser->format;
+    for (i = 0; i < len; i++) {
+        if (*format == '|') {
+            min = i;
+            format++;
+        }
+        if (IS_END_OF_FORMAT(*format)) {
+            PyErr_Format(PyExc_RuntimeError,
+                         "More keyword list entries (%d) than "
+                         "format specifiers (%d)", len, i);
+            return 0;
+        }
+        msg = skipitem(&format, NULL, 0);
+        if (msg) {
+            PyErr_Format(PyExc_RuntimeError, "%s: '%s'", msg,
+                         format);
+            return 0;
+        }
+    }
+    if (*format == '|' && min == INT_MAX) {
+        min = len;
+        format++;
+    }
+    if (!IS_END_OF_FORMAT(*format)) {
+        PyErr_Format(PyExc_RuntimeError,
+            "more argument specifiers than keyword list entries "
+            "(remaining format:'%s')", format);
+        return 0;
+    }
+
+    kwtuple = PyTuple_New(len);
+    if (kwtuple == NULL)
+        return 0;
+    for (i = 0; i < len; i++) {
+        PyObject *name = PyString_InternFromString(keywords[i]);
+        if (name == NULL) {
+            Py_DECREF(kwtuple);
+            return 0;
+        }
+        PyTuple_SET_ITEM(kwtuple, i, name);
+    }
+    if (parser->kwtuple != NULL) {
+        /* Initialized by another thread while the GC ran finalizers */
+        Py_DECREF(kwtuple);
+        return 1;
+    }
+
+    parser->fname = NULL;
+    parser->custom_msg = NULL;
+    if (*format == ':')
+        parser->fname = format + 1;
+    else if (*format == ';')
+        parser->custom_msg = format + 1;
+    parser->min = (min == INT_MAX) ? len : min;
+    parser->max = len;
+    parser->kwtuple = kwtuple;
+
+    parser->next = static_arg_parsers;
+    static_arg_parsers = parser;
+    return 1;
+}
+
+/* Look up key in the kwnames of a METH_FASTCALL call, by identity
+   first: both are interned in the common case.  Other names match
+   the way they would as keys of a dict of keyword arguments. */
+static PyObject *
+find_keyword(PyObject *kwnames, PyObject **kwstack, PyObject *key)
+{
+    Py_ssize_t i, nkwargs;
+
+    nkwargs = PyTuple_GET_SIZE(kwnames);
+    for (i = 0; i < nkwargs; i++) {
+        if (PyTuple_GET_ITEM(kwnames, i) == key)
+            return kwstack[i];
+    }
+    for (i = 0; i < nkwargs; i++) {
+        PyObject *kwname = PyTuple_GET_ITEM(kwnames, i);
+        int cmp;
+        if (PyString_Check(kwname)) {
+            if (_PyString_Eq(kwname, key))
+                return kwstack[i];
+            continue;
+        }
+        cmp = PyObject_RichCompareBool(kwname, key, Py_EQ);
+        if (cmp > 0)
+            return kwstack[i];
+        if (cmp < 0)
+            PyErr_Clear();
+    }
+    return NULL;
+}
+
+static int
+vgetargskeywordsfast(PyObject **args, Py_ssize_t nargs,
+                     PyObject *keywords, PyObject *kwnames,
+                     struct _PyArg_Parser *parser,
+                     va_list *p_va, int flags)
+{
+    char msgbuf[512];
+    int levels[32];
+    const char *format, *msg;
+    PyObject *kwtuple, *keyword;
+    int i, len;
+    Py_ssize_t nkeywords;
+    PyObject *freelist = NULL, *current_arg;
+    PyObject **kwstack = NULL;
+
+    assert(keywords == NULL || PyDict_Check(keywords));
+    assert(kwnames == NULL || PyTuple_Check(kwnames));
+    assert(keywords == NULL || kwnames == NULL);
+    assert(parser != NULL);
+    assert(p_va != NULL);
+
+    if (!parser_init(parser))
+        return 0;
+
+    kwtuple = parser->kwtuple;
+    len = parser->max;
+
+    if (keywords != NULL) {
+        nkeywords = PyDict_Size(keywords);
+    }
+    else if (kwnames != NULL) {
+        nkeywords = PyTuple_GET_SIZE(kwnames);
+        kwstack = args + nargs;
+    }
+    else {
+        nkeywords = 0;
+    }
+    if (nargs + nkeywords > len) {
+        PyErr_Format(PyExc_TypeError, "%s%s takes at most %d "
+                     "argument%s (%d given)",
+                     (parser->fname == NULL) ? "function" : parser->fname,
+                     (parser->fname == NULL) ? "" : "()",
+                     len,
+                     (len == 1) ? "" : "s",
+                     (int)(nargs + nkeywords));
+        return 0;
+    }
+
+    format = parser->format;
+    for (i = 0; i < len; i++) {
+        keyword = PyTuple_GET_ITEM(kwtuple, i);
+        if (*format == '|')
+            format++;
+        current_arg = NULL;
+        if (nkeywords) {
+            if (keywords != NULL)
+                current_arg = PyDict_GetItem(keywords, keyword);
+            else
+                current_arg = find_keyword(kwnames, kwstack, keyword);
+        }
+        if (current_arg) {
+            --nkeywords;
+            if (i < nargs) {
+                /* arg present in tuple and in dict */
+                PyErr_Format(PyExc_TypeError,
+                             "Argument given by name ('%s') "
+                             "and position (%d)",
+                             parser->keywords[i], i+1);
+                return cleanreturn(0, freelist);
+            }
+        }
+        else if (i < nargs)
+            current_arg = args[i];
+
+        if (current_arg) {
+            msg = convertitem(current_arg, &format, p_va, flags,
+                levels, msgbuf, sizeof(msgbuf), &freelist);
+            if (msg) {
+                seterror(i+1, msg, levels, parser->fname,
+                         parser->custom_msg);
+                return cleanreturn(0, freelist);
+            }
+            continue;
+        }
+
+        if (i < parser->min) {
+            PyErr_Format(PyExc_TypeError, "Required argument "
+                         "'%s' (pos %d) not found",
+                         parser->keywords[i], i+1);
+            return cleanreturn(0, freelist);
+        }
+        /* all required args fulfilled and no keyword args left */
+        if (!nkeywords)
+            return cleanreturn(1, freelist);
+
+        /* We are into optional args, skip thru to any remaining
+         * keyword args; parser_init() checked the format already */
+        skipitem(&format, p_va, flags);
+    }
+
+    /* make sure there are no extraneous keyword arguments */
+    if (nkeywords > 0) {
+        PyObject *key, *value;
+        Py_ssize_t pos = 0;
+        for (;;) {
+            int match = 0;
+            if (keywords != NULL) {
+                if (!PyDict_Next(keywords, &pos, &key, &value))
+                    break;
+            }
+            else {
+                if (pos >= PyTuple_GET_SIZE(kwnames))
+                    break;
+                key = PyTuple_GET_ITEM(kwnames, pos++);
+            }
+            if (!PyString_Check(key)) {
+                PyErr_SetString(PyExc_TypeError,
+                                "keywords must be strings");
+                return cleanreturn(0, freelist);
+            }
+            for (i = 0; i < len; i++) {
+                keyword = PyTuple_GET_ITEM(kwtuple, i);
+                if (key == keyword || _PyString_Eq(key, keyword)) {
+                    match = 1;
+                    break;
+                }
+            }
+            if (!match) {
+                PyErr_Format(PyExc_TypeError,
+                             "'%s' is an invalid keyword "
+                             "argument for this function",
+                             PyString_AS_STRING(key));
+                return cleanreturn(0, freelist);
+            }
+        }
+    }
+
+    return cleanreturn(1, freelist);
+}
+
+void
+_PyArg_Fini(void)
+{
+    struct _PyArg_Parser *parser = static_arg_parsers, *next;
+
+    while (parser != NULL) {
+        next = parser->next;
+        Py_CLEAR(parser->kwtuple);
+        parser->next = NULL;
+        parser = next;
+    }
+    static_arg_parsers = NULL;
+}
+
+
+/* Skip one format unit.  p_va may be NULL to only advance the format,
+   which is how a _PyArg_Parser checks its format on first use. */
 static char *
 skipitem(const char **p_format, va_list *p_va, int flags)
 {
@@ -1717,13 +2143,15 @@ skipitem(const char **p_format, va_list *p_va, int flags)
 #endif
     case 'c': /* char */
         {
-            (void) va_arg(*p_va, void *);
+            if (p_va != NULL)
+                (void) va_arg(*p_va, void *);
             break;
         }
 
     case 'n': /* Py_ssize_t */
         {
-            (void) va_arg(*p_va, Py_ssize_t *);
+            if (p_va != NULL)
+                (void) va_arg(*p_va, Py_ssize_t *);
             break;
         }
 
@@ -1731,7 +2159,8 @@ skipitem(const char **p_format, va_list *p_va, int flags)
 
     case 'e': /* string with encoding */
         {
-            (void) va_arg(*p_va, const char *);
+            if (p_va != NULL)
+                (void) va_arg(*p_va, const char *);
             if (!(*format == 's' || *format == 't'))
                 /* after 'e', only 's' and 't' is allowed */
                 goto err;
@@ -1747,14 +2176,17 @@ skipitem(const char **p_format, va_list *p_va, int flags)
     case 't': /* buffer, read-only */
     case 'w': /* buffer, read-write */
         {
-            (void) va_arg(*p_va, char **);
+            if (p_va != NULL)
+                (void) va_arg(*p_va, char **);
             if (*format == '#') {
-                if (flags & FLAG_SIZE_T)
-                    (void) va_arg(*p_va, Py_ssize_t *);
-                else
-                    (void) va_arg(*p_va, int *);
+                if (p_va != NULL) {
+                    if (flags & FLAG_SIZE_T)
+                        (void) va_arg(*p_va, Py_ssize_t *);
+                    else
+                        (void) va_arg(*p_va, int *);
+                }
                 format++;
-            } else if ((c == 's' || c == 'z') && *format == '*') {
+            } else if ((c == 's' || c == 'z' || c == 'w') && *format == '*') {
                 format++;
             }
             break;
@@ -1767,7 +2199,8 @@ skipitem(const char **p_format, va_list *p_va, int flags)
     case 'U': /* unicode string object */
 #endif
         {
-            (void) va_arg(*p_va, PyObject **);
+            if (p_va != NULL)
+                (void) va_arg(*p_va, PyObject **);
             break;
         }
 
@@ -1775,17 +2208,22 @@ skipitem(const char **p_format, va_list *p_va, int flags)
         {
             if (*format == '!') {
                 format++;
-                (void) va_arg(*p_va, PyTypeObject*);
-                (void) va_arg(*p_va, PyObject **);
+                if (p_va != NULL) {
+                    (void) va_arg(*p_va, PyTypeObject*);
+                    (void) va_arg(*p_va, PyObject **);
+                }
             }
             else if (*format == '&') {
                 typedef int (*converter)(PyObject *, void *);
-                (void) va_arg(*p_va, converter);
-                (void) va_arg(*p_va, void *);
+                if (p_va != NULL) {
+                    (void) va_arg(*p_va, converter);
+                    (void) va_arg(*p_va, void *);
+                }
                 format++;
             }
             else {
-                (void) va_arg(*p_va, PyObject **);
+                if (p_va != NULL)
+                    (void) va_arg(*p_va, PyObject **);
             }
             break;
         }
@@ -1821,27 +2259,15 @@ err:
 }
 
 
-int
-PyArg_UnpackTuple(PyObject *args, const char *name, Py_ssize_t min, Py_ssize_t max, ...)
+static int
+unpack_stack(PyObject **args, Py_ssize_t l, const char *name,
+             Py_ssize_t min, Py_ssize_t max, va_list vargs)
 {
-    Py_ssize_t i, l;
+    Py_ssize_t i;
     PyObject **o;
-    va_list vargs;
-
-#ifdef HAVE_STDARG_PROTOTYPES
-    va_start(vargs, max);
-#else
-    va_start(vargs);
-#endif
 
     assert(min >= 0);
     assert(min <= max);
-    if (!PyTuple_Check(args)) {
-        PyErr_SetString(PyExc_SystemError,
-            "PyArg_UnpackTuple() argument list is not a tuple");
-        return 0;
-    }
-    l = PyTuple_GET_SIZE(args);
     if (l < min) {
         if (name != NULL)
             PyErr_Format(
@@ -1854,7 +2280,6 @@ PyArg_UnpackTuple(PyObject *args, const char *name, Py_ssize_t min, Py_ssize_t m
                 "unpacked tuple should have %s%zd elements,"
                 " but has %zd",
                 (min == max ? "" : "at least "), min, l);
-        va_end(vargs);
         return 0;
     }
     if (l > max) {
@@ -1869,17 +2294,57 @@ PyArg_UnpackTuple(PyObject *args, const char *name, Py_ssize_t min, Py_ssize_t m
                 "unpacked tuple should have %s%zd elements,"
                 " but has %zd",
                 (min == max ? "" : "at most "), max, l);
-        va_end(vargs);
         return 0;
     }
     for (i = 0; i < l; i++) {
         o = va_arg(vargs, PyObject **);
-        *o = PyTuple_GET_ITEM(args, i);
+        *o = args[i];
     }
-    va_end(vargs);
     return 1;
 }
 
+int
+PyArg_UnpackTuple(PyObject *args, const char *name, Py_ssize_t min, Py_ssize_t max, ...)
+{
+    int retval;
+    va_list vargs;
+
+#ifdef HAVE_STDARG_PROTOTYPES
+    va_start(vargs, max);
+#else
+    va_start(vargs);
+#endif
+
+    if (!PyTuple_Check(args)) {
+        PyErr_SetString(PyExc_SystemError,
+            "PyArg_UnpackTuple() argument list is not a tuple");
+        va_end(vargs);
+        return 0;
+    }
+    retval = unpack_stack(&PyTuple_GET_ITEM(args, 0), PyTuple_GET_SIZE(args),
+                          name, min, max, vargs);
+    va_end(vargs);
+    return retval;
+}
+
+/* PyArg_UnpackTuple() for the arguments of a METH_FASTCALL function */
+int
+_PyArg_UnpackStack(PyObject **args, Py_ssize_t nargs, const char *name,
+                   Py_ssize_t min, Py_ssize_t max, ...)
+{
+    int retval;
+    va_list vargs;
+
+#ifdef HAVE_STDARG_PROTOTYPES
+    va_start(vargs, max);
+#else
+    va_start(vargs);
+#endif
+    retval = unpack_stack(args, nargs, name, min, max, vargs);
+    va_end(vargs);
+    return retval;
+}
+
 
 /* For type constructors that don't take keyword args
  *
@@ -1902,6 +2367,25 @@ _PyArg_NoKeywords(const char *funcname, PyObject *kw)
                     funcname);
     return 0;
 }
+
+/* For METH_FASTCALL functions that don't take keyword args: returns 1 if
+   kwnames, the tuple of keyword names passed to them, is NULL or empty */
+int
+_PyArg_NoStackKeywords(const char *funcname, PyObject *kwnames)
+{
+    if (kwnames == NULL)
+        return 1;
+    if (!PyTuple_CheckExact(kwnames)) {
+        PyErr_BadInternalCall();
+        return 0;
+    }
+    if (PyTuple_GET_SIZE(kwnames) == 0)
+        return 1;
+
+    PyErr_Format(PyExc_TypeError, "%.200s() takes no keyword arguments",
+                 funcname);
+    return 0;
+}
 #ifdef __cplusplus
 };
 #endif
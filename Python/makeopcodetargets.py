@@ -0,0 +1,85 @@
+#! /usr/bin/env python
+"""Generate C code for the jump table of the threaded code interpreter
+(for compilers supporting computed gotos or "labels-as-values", such as gcc).
+
+The table is built from Lib/opcode.py and checked against the values
+defined in Include/opcode.h, so that a new opcode added to one but not
+the other is caught when the table is regenerated.
+"""
+
+import os
+import re
+import sys
+
+
+def load_opcode_module(srcdir):
+    ns = {}
+    path = os.path.join(srcdir, 'Lib', 'opcode.py')
+    f = open(path)
+    try:
+        exec(compile(f.read(), path, 'exec'), ns)
+    finally:
+        f.close()
+    return ns
+
+
+def read_opcode_h(srcdir):
+    defines = {}
+    f = open(os.path.join(srcdir, 'Include', 'opcode.h'))
+    try:
+        for line in f:
+            m = re.match(r'#define\s+(\w+)\s+(\d+)', line)
+            if m:
+                defines[m.group(1)] = int(m.group(2))
+    finally:
+        f.close()
+    return defines
+
+
+def target_name(name):
+    # "SLICE+0" is the SLICE case in ceval.c, "SLICE+1" is SLICE_1 etc.
+    if '+' in name:
+        base, offset = name.split('+')
+        if offset == '0':
+            return base
+        return '%s_%s' % (base, offset)
+    return name
+
+
+def write_contents(f, srcdir):
+    """Write C code contents to the target file object.
+    """
+    opcode = load_opcode_module(srcdir)
+    defines = read_opcode_h(srcdir)
+    targets = ['_unknown_opcode'] * 256
+    for name, op in opcode['opmap'].items():
+        if defines.get(target_name(name)) != op:
+            raise ValueError('%s is %d in Lib/opcode.py but not in '
+                             'Include/opcode.h' % (name, op))
+        if name == 'STOP_CODE':
+            # Not a real instruction, the switch handles it as unknown
+            continue
+        targets[op] = 'TARGET_%s' % target_name(name)
+    f.write('/* This file is generated by Python/makeopcodetargets.py */\n')
+    f.write('static void *opcode_targets[256] = {\n')
+    f.write(',\n'.join(['    &&%s' % s for s in targets]))
+    f.write('\n};\n')
+
+
+def main():
+    if len(sys.argv) >= 3:
+        raise SystemExit('Too many arguments')
+    srcdir = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    if len(sys.argv) == 2:
+        path = sys.argv[1]
+    else:
+        path = os.path.join(srcdir, 'Python', 'opcode_targets.h')
+    f = open(path, 'w')
+    try:
+        write_contents(f, srcdir)
+    finally:
+        f.close()
+
+
+if __name__ == '__main__':
+    main()
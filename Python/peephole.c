@@ -291,6 +291,43 @@ markblocks(unsigned char *code, Py_ssize_t len)
     return blocks;
 }
 
+/* Replace the first opcode of frequent instruction pairs with a
+   superinstruction that also runs the second one (see FUSE_NEXT in
+   ceval.c).  The second instruction is left as it is, so jumps to it,
+   the code size and the line number table stay valid, and the pairs
+   may overlap.  This is the last pass: the other transformations do
+   not know the combined opcodes. */
+static void
+emit_superinstructions(unsigned char *codestr, Py_ssize_t codelen)
+{
+    Py_ssize_t i;
+    int next;
+
+    for (i = 0; i + 3 < codelen; i += CODESIZE(codestr[i])) {
+        next = codestr[i+3];
+        switch (codestr[i]) {
+            case LOAD_FAST:
+                if (next == LOAD_FAST)
+                    codestr[i] = LOAD_FAST_LOAD_FAST;
+                else if (next == LOAD_ATTR)
+                    codestr[i] = LOAD_FAST_LOAD_ATTR;
+                break;
+            case LOAD_CONST:
+                if (next == RETURN_VALUE)
+                    codestr[i] = LOAD_CONST_RETURN_VALUE;
+                break;
+            case COMPARE_OP:
+                if (next == POP_JUMP_IF_FALSE)
+                    codestr[i] = COMPARE_OP_POP_JUMP_IF_FALSE;
+                break;
+            case LOAD_GLOBAL:
+                if (next == CALL_FUNCTION)
+                    codestr[i] = LOAD_GLOBAL_CALL_FUNCTION;
+                break;
+        }
+    }
+}
+
 /* Perform basic peephole optimizations to components of a code object.
    The consts object should still be in list form to allow new constants
    to be appended.
@@ -659,6 +696,8 @@ PyCode_Optimize(PyObject *code, PyObject* consts, PyObject *names,
     }
     assert(h + nops == codelen);
 
+    emit_superinstructions(codestr, h);
+
     code = PyString_FromStringAndSize((char *)codestr, h);
     PyMem_Free(addrmap);
     PyMem_Free(codestr);
@@ -183,6 +183,9 @@ new_threadstate(PyInterpreterState *interp, int init)
         tstate->curexc_type = NULL;
         tstate->curexc_value = NULL;
         tstate->curexc_traceback = NULL;
+        tstate->curexc_build = NULL;
+        tstate->curexc_args[0] = NULL;
+        tstate->curexc_args[1] = NULL;
 
         tstate->exc_type = NULL;
         tstate->exc_value = NULL;
@@ -240,6 +243,9 @@ PyThreadState_Clear(PyThreadState *tstate)
     Py_CLEAR(tstate->curexc_type);
     Py_CLEAR(tstate->curexc_value);
     Py_CLEAR(tstate->curexc_traceback);
+    tstate->curexc_build = NULL;
+    Py_CLEAR(tstate->curexc_args[0]);
+    Py_CLEAR(tstate->curexc_args[1]);
 
     Py_CLEAR(tstate->exc_type);
     Py_CLEAR(tstate->exc_value);
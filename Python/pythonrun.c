@@ -438,6 +438,9 @@ Py_Finalize(void)
     /* Clear type lookup cache */
     PyType_ClearCache();
 
+    /* Drop the code cache while the modules are still there */
+    _PyCodeCache_Clear();
+
     /* Collect garbage.  This may call finalizers; it's nice to call these
      * before all modules are destroyed.
      * XXX If a __del__ or weakref callback is triggered here, and tries to
@@ -522,6 +525,7 @@ Py_Finalize(void)
     PyInterpreterState_Delete(interp);
 
     /* Sundry finalizers */
+    _PyArg_Fini();
     PyMethod_Fini();
     PyFrame_Fini();
     PyCFunction_Fini();
@@ -533,6 +537,7 @@ Py_Finalize(void)
     PyInt_Fini();
     PyFloat_Fini();
     PyDict_Fini();
+    (void)_PyMem_ClearTableCache();
 
 #ifdef Py_USING_UNICODE
     /* Cleanup Unicode implementation */
@@ -1310,21 +1315,254 @@ PyErr_Display(PyObject *exception, PyObject *value, PyObject *tb)
         PyErr_Clear();
 }
 
-PyObject *
-PyRun_StringFlags(const char *str, int start, PyObject *globals,
-                  PyObject *locals, PyCompilerFlags *flags)
+/* Code cache.
+
+   Template engines and rule engines compile and exec the same generated
+   source strings over and over.  Code objects are immutable, so the code
+   compiled from a string can be handed out again for the same source,
+   filename, start symbol, compiler flags and optimization level.  Entries
+   live in a hash table keyed by the string hash of the source, and on an
+   LRU list that bounds their number and the bytes of source they keep.
+
+   Source whose compilation issued a warning is not cached, so that the
+   warning is issued again the next time.
+*/
+
+typedef struct _codecache_entry {
+    struct _codecache_entry *next;      /* hash chain */
+    struct _codecache_entry *lru_prev;  /* LRU list, most recent first */
+    struct _codecache_entry *lru_next;
+    long hash;
+    PyObject *source;                   /* str */
+    PyObject *filename;                 /* str */
+    int start;
+    int flags;
+    int optimize;
+    PyCodeObject *code;
+} codecache_entry;
+
+#define CODECACHE_MAX_ENTRIES 256
+#define CODECACHE_MAX_BYTES (1024*1024)
+#define CODECACHE_MAX_TABLE (1 << 16)
+
+static codecache_entry **codecache_table = NULL;
+static size_t codecache_mask = 0;
+static codecache_entry codecache_lru = {NULL, &codecache_lru, &codecache_lru};
+static Py_ssize_t codecache_max_entries = CODECACHE_MAX_ENTRIES;
+static Py_ssize_t codecache_max_bytes = CODECACHE_MAX_BYTES;
+static Py_ssize_t codecache_entries = 0;
+static Py_ssize_t codecache_bytes = 0;
+static Py_ssize_t codecache_hits = 0;
+static Py_ssize_t codecache_misses = 0;
+static Py_ssize_t codecache_evictions = 0;
+
+static codecache_entry *
+codecache_find(PyObject *source, long hash, const char *filename,
+               int start, int flags)
+{
+    codecache_entry *e;
+
+    if (codecache_table == NULL)
+        return NULL;
+    for (e = codecache_table[hash & codecache_mask]; e != NULL; e = e->next) {
+        if (e->hash == hash && e->start == start && e->flags == flags &&
+            e->optimize == Py_OptimizeFlag &&
+            _PyString_Eq(e->source, source) &&
+            strcmp(PyString_AS_STRING(e->filename), filename) == 0)
+            return e;
+    }
+    return NULL;
+}
+
+static void
+codecache_lru_unlink(codecache_entry *e)
+{
+    e->lru_prev->lru_next = e->lru_next;
+    e->lru_next->lru_prev = e->lru_prev;
+}
+
+static void
+codecache_lru_push(codecache_entry *e)
 {
-    PyObject *ret = NULL;
+    e->lru_prev = &codecache_lru;
+    e->lru_next = codecache_lru.lru_next;
+    codecache_lru.lru_next->lru_prev = e;
+    codecache_lru.lru_next = e;
+}
+
+/* Take e out of the cache and free it.  The references are dropped last,
+   once the cache is consistent again, since freeing a code object may run
+   weakref callbacks. */
+static void
+codecache_remove(codecache_entry *e)
+{
+    codecache_entry **pe = &codecache_table[e->hash & codecache_mask];
+    PyObject *source = e->source, *filename = e->filename;
+    PyCodeObject *code = e->code;
+
+    while (*pe != e)
+        pe = &(*pe)->next;
+    *pe = e->next;
+    codecache_lru_unlink(e);
+    codecache_entries--;
+    codecache_bytes -= PyString_GET_SIZE(source);
+    PyMem_FREE(e);
+    Py_DECREF(code);
+    Py_DECREF(source);
+    Py_DECREF(filename);
+}
+
+static void
+codecache_store(PyObject *source, long hash, const char *filename,
+                int start, int flags, PyCodeObject *code)
+{
+    codecache_entry *e;
+
+    if (PyString_GET_SIZE(source) > codecache_max_bytes)
+        return;
+    if (codecache_table == NULL) {
+        size_t size = 8;
+        while (size < CODECACHE_MAX_TABLE &&
+               size < 2 * (size_t)codecache_max_entries)
+            size <<= 1;
+        codecache_table = PyMem_NEW(codecache_entry *, size);
+        if (codecache_table == NULL)
+            return;
+        memset(codecache_table, 0, size * sizeof(codecache_entry *));
+        codecache_mask = size - 1;
+    }
+    if (codecache_find(source, hash, filename, start, flags) != NULL)
+        return;
+    e = PyMem_NEW(codecache_entry, 1);
+    if (e == NULL)
+        return;
+    e->filename = PyString_FromString(filename);
+    if (e->filename == NULL) {
+        PyErr_Clear();
+        PyMem_FREE(e);
+        return;
+    }
+    e->hash = hash;
+    Py_INCREF(source);
+    e->source = source;
+    e->start = start;
+    e->flags = flags;
+    e->optimize = Py_OptimizeFlag;
+    Py_INCREF(code);
+    e->code = code;
+    e->next = codecache_table[hash & codecache_mask];
+    codecache_table[hash & codecache_mask] = e;
+    codecache_lru_push(e);
+    codecache_entries++;
+    codecache_bytes += PyString_GET_SIZE(source);
+
+    while ((codecache_entries > codecache_max_entries ||
+            codecache_bytes > codecache_max_bytes) &&
+           codecache_lru.lru_prev != e) {
+        codecache_remove(codecache_lru.lru_prev);
+        codecache_evictions++;
+    }
+}
+
+static PyCodeObject *
+compile_string(const char *str, const char *filename, int start,
+               PyCompilerFlags *flags)
+{
+    PyCodeObject *co = NULL;
     mod_ty mod;
     PyArena *arena = PyArena_New();
     if (arena == NULL)
         return NULL;
 
-    mod = PyParser_ASTFromString(str, "<string>", start, flags, arena);
+    mod = PyParser_ASTFromString(str, filename, start, flags, arena);
     if (mod != NULL)
-        ret = run_mod(mod, "<string>", globals, locals, flags, arena);
+        co = PyAST_Compile(mod, filename, flags, arena);
     PyArena_Free(arena);
-    return ret;
+    return co;
+}
+
+/* Compile str like compile_string(), going through the code cache. */
+static PyCodeObject *
+compile_string_cached(const char *str, const char *filename, int start,
+                      PyCompilerFlags *flags)
+{
+    PyObject *source;
+    PyCodeObject *co;
+    codecache_entry *e;
+    int cflags = flags ? flags->cf_flags : 0;
+    long hash, nwarnings;
+
+    if (codecache_max_entries == 0)
+        return compile_string(str, filename, start, flags);
+    source = PyString_FromString(str);
+    if (source == NULL)
+        return NULL;
+    hash = PyObject_Hash(source);
+    e = codecache_find(source, hash, filename, start, cflags);
+    if (e != NULL) {
+        codecache_hits++;
+        codecache_lru_unlink(e);
+        codecache_lru_push(e);
+        co = e->code;
+        Py_INCREF(co);
+        Py_DECREF(source);
+        /* Report the future features like a fresh compile would */
+        if (flags)
+            flags->cf_flags |= co->co_flags & PyCF_MASK;
+        return co;
+    }
+    codecache_misses++;
+    nwarnings = _PyErr_WarnCount;
+    co = compile_string(str, filename, start, flags);
+    if (co != NULL && _PyErr_WarnCount == nwarnings)
+        codecache_store(source, hash, filename, start, cflags, co);
+    Py_DECREF(source);
+    return co;
+}
+
+void
+_PyCodeCache_Clear(void)
+{
+    while (codecache_lru.lru_next != &codecache_lru)
+        codecache_remove(codecache_lru.lru_next);
+}
+
+void
+_PyCodeCache_SetLimits(Py_ssize_t max_entries, Py_ssize_t max_bytes)
+{
+    _PyCodeCache_Clear();
+    PyMem_FREE(codecache_table);
+    codecache_table = NULL;
+    codecache_max_entries = max_entries;
+    codecache_max_bytes = max_bytes;
+}
+
+PyObject *
+_PyCodeCache_Stats(void)
+{
+    return Py_BuildValue("{snsnsnsnsnsnsn}",
+                         "entries", codecache_entries,
+                         "max_entries", codecache_max_entries,
+                         "bytes", codecache_bytes,
+                         "max_bytes", codecache_max_bytes,
+                         "hits", codecache_hits,
+                         "misses", codecache_misses,
+                         "evictions", codecache_evictions);
+}
+
+PyObject *
+PyRun_StringFlags(const char *str, int start, PyObject *globals,
+                  PyObject *locals, PyCompilerFlags *flags)
+{
+    PyCodeObject *co;
+    PyObject *v;
+
+    co = compile_string_cached(str, "<string>", start, flags);
+    if (co == NULL)
+        return NULL;
+    v = PyEval_EvalCode(co, globals, locals);
+    Py_DECREF(co);
+    return v;
 }
 
 PyObject *
@@ -1400,25 +1638,21 @@ PyObject *
 Py_CompileStringFlags(const char *str, const char *filename, int start,
                       PyCompilerFlags *flags)
 {
-    PyCodeObject *co;
+    PyObject *result = NULL;
     mod_ty mod;
-    PyArena *arena = PyArena_New();
+    PyArena *arena;
+
+    if (!flags || !(flags->cf_flags & PyCF_ONLY_AST))
+        return (PyObject *)compile_string_cached(str, filename, start, flags);
+
+    arena = PyArena_New();
     if (arena == NULL)
         return NULL;
-
     mod = PyParser_ASTFromString(str, filename, start, flags, arena);
-    if (mod == NULL) {
-        PyArena_Free(arena);
-        return NULL;
-    }
-    if (flags && (flags->cf_flags & PyCF_ONLY_AST)) {
-        PyObject *result = PyAST_mod2obj(mod);
-        PyArena_Free(arena);
-        return result;
-    }
-    co = PyAST_Compile(mod, filename, flags, arena);
+    if (mod != NULL)
+        result = PyAST_mod2obj(mod);
     PyArena_Free(arena);
-    return (PyObject *)co;
+    return result;
 }
 
 struct symtable *
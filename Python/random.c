@@ -245,17 +245,62 @@ _PyOS_URandom(void *buffer, Py_ssize_t size)
 #endif
 }
 
-void
-_PyRandom_Init(void)
+#ifdef TABULATION_SEEDED
+#ifndef TABULATION_MAIN
+#error "TABULATION_SEEDED requires TABULATION_MAIN"
+#endif
+
+/* Tabulation hash tables, generated from the hash secret at startup
+   instead of the fixed random.org bytes compiled in from randtable.c, so
+   that they can't be read from the source.  With PYTHONHASHSEED set the
+   tables are reproducible. */
+#ifdef __GNUC__
+static long tabulation_tables[_Py_TABULATION_SIZE] __attribute__((aligned(64)));
+#else
+static long tabulation_tables[_Py_TABULATION_SIZE];
+#endif
+long *randlongtable = tabulation_tables;
+int *randinttable = (int *)tabulation_tables;
+
+static PY_UINT64_T
+splitmix64(PY_UINT64_T *state)
+{
+    PY_UINT64_T z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/* Fill the tables with xorshift128+ output seeded from _Py_HashSecret
+   via splitmix64.  The default TABLE_MASK of 7 needs 2048 entries, which
+   takes a couple of microseconds. */
+static void
+init_tabulation_tables(void)
+{
+    PY_UINT64_T seed, s0, s1, x;
+    Py_ssize_t i;
+
+    seed = (PY_UINT64_T)_Py_HashSecret.prefix;
+    s0 = splitmix64(&seed);
+    seed ^= (PY_UINT64_T)_Py_HashSecret.suffix;
+    s1 = splitmix64(&seed);
+    for (i = 0; i < _Py_TABULATION_SIZE; i++) {
+        x = s0;
+        s0 = s1;
+        x ^= x << 23;
+        s1 = x ^ s0 ^ (x >> 17) ^ (s0 >> 26);
+        tabulation_tables[i] = (long)(s1 + s0);
+    }
+}
+#endif
+
+static void
+init_hash_secret(void)
 {
     char *env;
     void *secret = &_Py_HashSecret;
     Py_ssize_t secret_size = sizeof(_Py_HashSecret_t);
 
-    if (_Py_HashSecret_Initialized)
-        return;
-    _Py_HashSecret_Initialized = 1;
-
     /*
       By default, hash randomization is disabled, and only
       enabled if PYTHONHASHSEED is set to non-empty or if
@@ -304,3 +349,16 @@ _PyRandom_Init(void)
 #endif
     }
 }
+
+void
+_PyRandom_Init(void)
+{
+    if (_Py_HashSecret_Initialized)
+        return;
+    _Py_HashSecret_Initialized = 1;
+
+    init_hash_secret();
+#ifdef TABULATION_SEEDED
+    init_tabulation_tables();
+#endif
+}
@@ -184,7 +184,7 @@ static identifier top = NULL, lambda = NULL, genexpr = NULL, setcomp = NULL,
     dictcomp = NULL;
 
 #define GET_IDENTIFIER(VAR) \
-    ((VAR) ? (VAR) : ((VAR) = PyString_InternFromString(# VAR)))
+    ((VAR) ? (VAR) : ((VAR) = _PyString_InternImmortalFromString(# VAR)))
 
 #define DUPLICATE_ARGUMENT \
 "duplicate argument '%s' in function definition"
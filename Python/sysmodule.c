@@ -475,7 +475,7 @@ PyDoc_STRVAR(setcheckinterval_doc,
 "setcheckinterval(n)\n\
 \n\
 Tell the Python interpreter to check for asynchronous events every\n\
-n instructions.  This also affects how often thread switches occur."
+n instructions.  Thread switches are timed by setswitchinterval()."
 );
 
 static PyObject *
@@ -488,6 +488,62 @@ PyDoc_STRVAR(getcheckinterval_doc,
 "getcheckinterval() -> current check interval; see setcheckinterval()."
 );
 
+#ifdef WITH_THREAD
+static PyObject *
+sys_setswitchinterval(PyObject *self, PyObject *args)
+{
+    double d;
+    if (!PyArg_ParseTuple(args, "d:setswitchinterval", &d))
+        return NULL;
+    if (d <= 0.0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "switch interval must be strictly positive");
+        return NULL;
+    }
+    _PyEval_SetSwitchInterval((unsigned long) (1e6 * d));
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+PyDoc_STRVAR(setswitchinterval_doc,
+"setswitchinterval(n)\n\
+\n\
+Set the ideal thread switching delay inside the Python interpreter.\n\
+A thread waiting for the interpreter lock for n seconds asks the\n\
+running thread to hand it over; a thread coming back from a blocking\n\
+call asks at once.  The actual frequency of switching threads can be\n\
+lower if the interpreter executes long sequences of uninterruptible\n\
+code.  The default is 0.005 (5 milliseconds)."
+);
+
+static PyObject *
+sys_getswitchinterval(PyObject *self, PyObject *args)
+{
+    return PyFloat_FromDouble(1e-6 * _PyEval_GetSwitchInterval());
+}
+
+PyDoc_STRVAR(getswitchinterval_doc,
+"getswitchinterval() -> current thread switch interval; see setswitchinterval()."
+);
+
+/* Defined in ceval.c because it uses static globals of that file */
+extern PyObject *_Py_GetGILStats(PyObject *, PyObject *);
+
+PyDoc_STRVAR(getgilstats_doc,
+"getgilstats([reset]) -> dict\n\
+\n\
+Return statistics about the interpreter lock: 'switches' counts the\n\
+times it passed to another thread, 'drop_requests' the times a waiting\n\
+thread asked the running one to release it and 'forced_switches' the\n\
+times the running thread then waited for the other one to take it.\n\
+'waits' counts acquisitions that had to wait, 'wait_time' and\n\
+'max_wait_time' are the total and longest of those waits and\n\
+'hold_time' and 'max_hold_time' the total and longest time the lock was\n\
+held, in seconds.  If reset is true, the statistics are cleared\n\
+afterwards."
+);
+#endif
+
 #ifdef WITH_TSC
 static PyObject *
 sys_settscdump(PyObject *self, PyObject *args)
@@ -829,6 +885,156 @@ sys_current_frames(PyObject *self, PyObject *noargs)
     return _PyThread_CurrentFrames();
 }
 
+#ifdef WITH_PYMALLOC
+PyDoc_STRVAR(mallocstats_doc,
+"_mallocstats() -> dictionary\n\
+\n\
+Return the counters of the small object allocator (pymalloc): arenas,\n\
+pools and blocks of each size class allocated and freed, and requests\n\
+passed to the system allocator.  Cheap enough to be sampled often.\n\
+\n\
+This function should be used for specialized purposes only."
+);
+
+/* The dictionary of sys._mallocstats(), which sys._arenastats() extends */
+static PyObject *
+malloc_stats(void)
+{
+    _PyMallocStats st;
+    PyObject *classes;
+    int i;
+
+    _PyObject_GetMallocStats(&st);
+    classes = PyList_New(st.nclasses);
+    if (classes == NULL)
+        return NULL;
+    for (i = 0; i < st.nclasses; i++) {
+        PyObject *v = Py_BuildValue("{snsnsnsn}",
+            "size", (Py_ssize_t)st.class_size[i],
+            "allocated", (Py_ssize_t)st.class_mallocs[i],
+            "freed", (Py_ssize_t)st.class_frees[i],
+            "in_use", (Py_ssize_t)(st.class_mallocs[i] - st.class_frees[i]));
+        if (v == NULL) {
+            Py_DECREF(classes);
+            return NULL;
+        }
+        PyList_SET_ITEM(classes, i, v);
+    }
+    return Py_BuildValue("{snsnsnsnsnsnsnsnsnsnsnsnsnsN}",
+        "small_request_threshold", (Py_ssize_t)st.small_request_threshold,
+        "arena_size", (Py_ssize_t)st.arena_size,
+        "pool_size", (Py_ssize_t)st.pool_size,
+        "arenas", (Py_ssize_t)st.narenas,
+        "arenas_allocated", (Py_ssize_t)st.narenas_allocated,
+        "arenas_freed", (Py_ssize_t)(st.narenas_allocated - st.narenas),
+        "arenas_highwater", (Py_ssize_t)st.narenas_highwater,
+        "pools_initialized", (Py_ssize_t)st.npools_initialized,
+        "pools_emptied", (Py_ssize_t)st.npools_emptied,
+        "system_mallocs", (Py_ssize_t)st.system_mallocs,
+        "system_reallocs", (Py_ssize_t)st.system_reallocs,
+        "system_frees", (Py_ssize_t)st.system_frees,
+        "system_bytes", (Py_ssize_t)st.system_bytes,
+        "size_classes", classes);
+}
+
+static PyObject *
+sys_mallocstats(PyObject *self, PyObject *noargs)
+{
+    return malloc_stats();
+}
+
+PyDoc_STRVAR(arenastats_doc,
+"_arenastats() -> dictionary\n\
+\n\
+Return the counters of _mallocstats() plus the state of the arenas of\n\
+the small object allocator:  their virtual and resident size, and the\n\
+pools and bytes used per size class.  Walks all the arenas.\n\
+\n\
+This function should be used for specialized purposes only."
+);
+
+static PyObject *
+sys_arenastats(PyObject *self, PyObject *noargs)
+{
+    _PyArenaStats st;
+    PyObject *result, *classes, *v = NULL;
+    int i;
+
+    _PyObject_GetArenaStats(&st);
+    result = malloc_stats();
+    if (result == NULL)
+        return NULL;
+    classes = PyDict_GetItemString(result, "size_classes");
+    assert(classes != NULL && PyList_GET_SIZE(classes) == st.nclasses);
+    for (i = 0; i < st.nclasses; i++) {
+        v = Py_BuildValue("{snsnsn}",
+            "pools", (Py_ssize_t)st.class_pools[i],
+            "resident_bytes", (Py_ssize_t)(st.class_pools[i] * st.pool_size),
+            "used_bytes", (Py_ssize_t)(st.class_blocks[i] *
+                                       st.class_size[i]));
+        if (v == NULL || PyDict_Update(PyList_GET_ITEM(classes, i), v) < 0)
+            goto error;
+        Py_DECREF(v);
+    }
+    v = Py_BuildValue("{sNsNsnsnsnsnsnsn}",
+        "mmap", PyBool_FromLong(st.mmap),
+        "huge_pages", PyBool_FromLong(st.huge_pages),
+        "virtual_bytes", (Py_ssize_t)(st.narenas * st.arena_size),
+        "resident_bytes", (Py_ssize_t)(st.narenas * st.arena_size -
+            (st.untouched_pools + st.released_pools) * st.pool_size),
+        "cached_bytes", (Py_ssize_t)(st.cached_pools * st.pool_size),
+        "released_bytes", (Py_ssize_t)(st.released_pools * st.pool_size),
+        "untouched_bytes", (Py_ssize_t)(st.untouched_pools * st.pool_size),
+        "pools_released", (Py_ssize_t)st.ntimes_pool_released);
+    if (v == NULL || PyDict_Update(result, v) < 0)
+        goto error;
+    Py_DECREF(v);
+    return result;
+
+error:
+    Py_XDECREF(v);
+    Py_DECREF(result);
+    return NULL;
+}
+#endif
+
+PyDoc_STRVAR(tablecachestats_doc,
+"_tablecachestats() -> dictionary\n\
+\n\
+Return the statistics of the cache of dict and set hash tables.\n\
+\n\
+This function should be used for specialized purposes only."
+);
+
+static PyObject *
+sys_tablecachestats(PyObject *self, PyObject *noargs)
+{
+    _PyTableCacheStats st;
+
+    _PyMem_GetTableCacheStats(&st);
+    return Py_BuildValue("{snsnsnsnsnsn}",
+                         "hits", (Py_ssize_t)st.hits,
+                         "misses", (Py_ssize_t)st.misses,
+                         "discards", (Py_ssize_t)st.discards,
+                         "tables", (Py_ssize_t)st.ntables,
+                         "bytes", (Py_ssize_t)st.nbytes,
+                         "max_bytes", (Py_ssize_t)st.max_bytes);
+}
+
+PyDoc_STRVAR(intblockstats_doc,
+"_intblockstats() -> dictionary\n\
+\n\
+Return the statistics of the blocks that int objects are allocated from.\n\
+\n\
+This function should be used for specialized purposes only."
+);
+
+static PyObject *
+sys_intblockstats(PyObject *self, PyObject *noargs)
+{
+    return _PyInt_BlockStats();
+}
+
 PyDoc_STRVAR(call_tracing_doc,
 "call_tracing(func, args) -> object\n\
 \n\
@@ -883,6 +1089,27 @@ extern PyObject *_Py_GetObjects(PyObject *, PyObject *);
 extern PyObject *_Py_GetDXProfile(PyObject *,  PyObject *);
 #endif
 
+/* Defined in ceval.c because they use static globals of that file */
+extern PyObject *_Py_SetOpcodeProfile(PyObject *, PyObject *);
+extern PyObject *_Py_GetOpcodeProfile(PyObject *, PyObject *);
+
+PyDoc_STRVAR(setopcodeprofile_doc,
+"setopcodeprofile(flag)\n\
+\n\
+Turn counting of executed opcodes, opcode pairs and instruction\n\
+offsets on or off; see getopcodeprofile()."
+);
+
+PyDoc_STRVAR(getopcodeprofile_doc,
+"getopcodeprofile([reset]) -> dict\n\
+\n\
+Return the counts collected while setopcodeprofile() was on:\n\
+'opcodes' is a list of 256 execution counts, 'pairs' maps\n\
+(opcode, next opcode) to a count and 'offsets' maps each code object\n\
+to a dict of instruction offset -> count.  If reset is true, the\n\
+counts are cleared afterwards."
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -898,13 +1125,73 @@ PyDoc_STRVAR(sys_clear_type_cache__doc__,
 "_clear_type_cache() -> None\n\
 Clear the internal type lookup cache.");
 
+static PyObject *
+sys_clear_code_cache(PyObject* self, PyObject* args)
+{
+    _PyCodeCache_Clear();
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(sys_clear_code_cache__doc__,
+"_clear_code_cache() -> None\n\
+Clear the cache of code compiled from strings.");
+
+PyDoc_STRVAR(codecachestats_doc,
+"_codecachestats() -> dictionary\n\
+\n\
+Return the size, limits and hit statistics of the cache of code compiled\n\
+from strings by compile(), exec and eval().\n\
+\n\
+This function should be used for specialized purposes only."
+);
+
+static PyObject *
+sys_codecachestats(PyObject *self, PyObject *noargs)
+{
+    return _PyCodeCache_Stats();
+}
+
+PyDoc_STRVAR(setcodecachelimits_doc,
+"_setcodecachelimits(max_entries, max_bytes)\n\
+\n\
+Clear the cache of code compiled from strings and bound it to max_entries\n\
+entries holding max_bytes bytes of source.  A max_entries of 0 disables\n\
+the cache.\n\
+\n\
+This function should be used for specialized purposes only."
+);
+
+static PyObject *
+sys_setcodecachelimits(PyObject *self, PyObject *args)
+{
+    Py_ssize_t max_entries, max_bytes;
+
+    if (!PyArg_ParseTuple(args, "nn:_setcodecachelimits",
+                          &max_entries, &max_bytes))
+        return NULL;
+    if (max_entries < 0 || max_bytes < 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "code cache limits must be >= 0");
+        return NULL;
+    }
+    _PyCodeCache_SetLimits(max_entries, max_bytes);
+    Py_RETURN_NONE;
+}
+
 
 static PyMethodDef sys_methods[] = {
     /* Might as well keep this in alphabetic order */
+#ifdef WITH_PYMALLOC
+    {"_arenastats", sys_arenastats, METH_NOARGS, arenastats_doc},
+    {"_mallocstats", sys_mallocstats, METH_NOARGS, mallocstats_doc},
+#endif
     {"callstats", (PyCFunction)PyEval_GetCallStats, METH_NOARGS,
      callstats_doc},
     {"_clear_type_cache",       sys_clear_type_cache,     METH_NOARGS,
      sys_clear_type_cache__doc__},
+    {"_clear_code_cache",       sys_clear_code_cache,     METH_NOARGS,
+     sys_clear_code_cache__doc__},
+    {"_codecachestats", sys_codecachestats, METH_NOARGS, codecachestats_doc},
     {"_current_frames", sys_current_frames, METH_NOARGS,
      current_frames_doc},
     {"displayhook",     sys_displayhook, METH_O, displayhook_doc},
@@ -926,6 +1213,9 @@ static PyMethodDef sys_methods[] = {
 #ifdef DYNAMIC_EXECUTION_PROFILE
     {"getdxp",          _Py_GetDXProfile, METH_VARARGS},
 #endif
+#ifdef WITH_THREAD
+    {"getgilstats",     _Py_GetGILStats, METH_VARARGS, getgilstats_doc},
+#endif
 #ifdef Py_USING_UNICODE
     {"getfilesystemencoding", (PyCFunction)sys_getfilesystemencoding,
      METH_NOARGS, getfilesystemencoding_doc},
@@ -933,6 +1223,8 @@ static PyMethodDef sys_methods[] = {
 #ifdef Py_TRACE_REFS
     {"getobjects",      _Py_GetObjects, METH_VARARGS},
 #endif
+    {"getopcodeprofile", _Py_GetOpcodeProfile, METH_VARARGS,
+     getopcodeprofile_doc},
 #ifdef Py_REF_DEBUG
     {"gettotalrefcount", (PyCFunction)sys_gettotalrefcount, METH_NOARGS},
 #endif
@@ -953,10 +1245,20 @@ static PyMethodDef sys_methods[] = {
     {"setdefaultencoding", sys_setdefaultencoding, METH_VARARGS,
      setdefaultencoding_doc},
 #endif
+    {"_setcodecachelimits", sys_setcodecachelimits, METH_VARARGS,
+     setcodecachelimits_doc},
     {"setcheckinterval",        sys_setcheckinterval, METH_VARARGS,
      setcheckinterval_doc},
     {"getcheckinterval",        sys_getcheckinterval, METH_NOARGS,
      getcheckinterval_doc},
+#ifdef WITH_THREAD
+    {"setswitchinterval",       sys_setswitchinterval, METH_VARARGS,
+     setswitchinterval_doc},
+    {"getswitchinterval",       sys_getswitchinterval, METH_NOARGS,
+     getswitchinterval_doc},
+#endif
+    {"setopcodeprofile", _Py_SetOpcodeProfile, METH_VARARGS,
+     setopcodeprofile_doc},
 #ifdef HAVE_DLOPEN
     {"setdlopenflags", sys_setdlopenflags, METH_VARARGS,
      setdlopenflags_doc},
@@ -970,6 +1272,9 @@ static PyMethodDef sys_methods[] = {
 #endif
     {"settrace",        sys_settrace, METH_O, settrace_doc},
     {"gettrace",        sys_gettrace, METH_NOARGS, gettrace_doc},
+    {"_tablecachestats", sys_tablecachestats, METH_NOARGS,
+     tablecachestats_doc},
+    {"_intblockstats", sys_intblockstats, METH_NOARGS, intblockstats_doc},
     {"call_tracing", sys_call_tracing, METH_VARARGS, call_tracing_doc},
     {NULL,              NULL}           /* sentinel */
 };
@@ -1126,9 +1431,11 @@ getprofile() -- get the global profiling function\n\
 getrefcount() -- return the reference count for an object (plus one :-)\n\
 getrecursionlimit() -- return the max recursion depth for the interpreter\n\
 getsizeof() -- return the size of an object in bytes\n\
+getopcodeprofile() -- return the opcode execution counts\n\
 gettrace() -- get the global debug tracing function\n\
 setcheckinterval() -- control how often the interpreter checks for events\n\
 setdlopenflags() -- set the flags to be used for dlopen() calls\n\
+setopcodeprofile() -- turn counting of executed opcodes on or off\n\
 setprofile() -- set the global profiling function\n\
 setrecursionlimit() -- set the max recursion depth for the interpreter\n\
 settrace() -- set the global debug tracing function\n\
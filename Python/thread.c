@@ -151,6 +151,54 @@ static size_t _pythread_stacksize = 0;
 #endif
 */
 
+#ifndef Py_HAVE_NATIVE_TIMED_LOCK
+/* If the platform has no lock that can wait with a timeout, poll the
+   lock instead, sleeping a little longer each time (1 ms at first, never
+   more than 50 ms); threading.Condition.wait() used to do the same in
+   Python.  The timeout only counts the time spent sleeping.  intr_flag is
+   ignored: the wait is never interrupted.
+*/
+#if !defined(MS_WINDOWS) && defined(HAVE_SYS_SELECT_H)
+#include <sys/select.h>
+#endif
+
+static void
+lock_poll_sleep(PY_TIMEOUT_T microseconds)
+{
+#ifdef MS_WINDOWS
+    Sleep((DWORD)(microseconds / 1000));
+#else
+    struct timeval t;
+    t.tv_sec = (long)(microseconds / 1000000);
+    t.tv_usec = (long)(microseconds % 1000000);
+    select(0, (fd_set *)0, (fd_set *)0, (fd_set *)0, &t);
+#endif
+}
+
+PyLockStatus
+PyThread_acquire_lock_timed(PyThread_type_lock lock, PY_TIMEOUT_T microseconds,
+                            int intr_flag)
+{
+    PY_TIMEOUT_T delay = 500;
+
+    if (microseconds < 0)
+        return PyThread_acquire_lock(lock, WAIT_LOCK) ? PY_LOCK_ACQUIRED
+                                                      : PY_LOCK_FAILURE;
+    while (!PyThread_acquire_lock(lock, NOWAIT_LOCK)) {
+        if (microseconds <= 0)
+            return PY_LOCK_FAILURE;
+        delay *= 2;
+        if (delay > 50000)
+            delay = 50000;
+        if (delay > microseconds)
+            delay = microseconds;
+        lock_poll_sleep(delay);
+        microseconds -= delay;
+    }
+    return PY_LOCK_ACQUIRED;
+}
+#endif /* !Py_HAVE_NATIVE_TIMED_LOCK */
+
 /* return the current thread stack size */
 size_t
 PyThread_get_stacksize(void)
@@ -82,6 +82,52 @@
 #  undef USE_SEMAPHORES
 #endif
 
+/* On Linux a lock is a single int changed with atomic instructions; the
+ * kernel is only entered (futex(2)) to put a thread to sleep on a locked
+ * lock or to wake one up.  Compile with -DUSE_FUTEX_LOCKS=0 to use
+ * semaphores as on other POSIX systems.
+ */
+#ifndef USE_FUTEX_LOCKS
+#  if defined(__linux__) && defined(__GNUC__)
+#    define USE_FUTEX_LOCKS 1
+#  else
+#    define USE_FUTEX_LOCKS 0
+#  endif
+#endif
+
+#if USE_FUTEX_LOCKS
+#include <errno.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#ifndef FUTEX_WAIT_PRIVATE
+/* Linux < 2.6.22: use the process-shared operations */
+#define FUTEX_WAIT_PRIVATE FUTEX_WAIT
+#define FUTEX_WAKE_PRIVATE FUTEX_WAKE
+#endif
+#endif
+
+#ifdef GETTIMEOFDAY_NO_TZ
+#define GETTIMEOFDAY(ptv) gettimeofday(ptv)
+#else
+#define GETTIMEOFDAY(ptv) gettimeofday(ptv, (struct timezone *)NULL)
+#endif
+
+/* The absolute time (for sem_timedwait() and pthread_cond_timedwait())
+ * that is microseconds from now.
+ */
+#define MICROSECONDS_TO_TIMESPEC(microseconds, ts) \
+do { \
+    struct timeval tv; \
+    GETTIMEOFDAY(&tv); \
+    tv.tv_usec += microseconds % 1000000; \
+    tv.tv_sec += microseconds / 1000000; \
+    tv.tv_sec += tv.tv_usec / 1000000; \
+    tv.tv_usec %= 1000000; \
+    ts.tv_sec = tv.tv_sec; \
+    ts.tv_nsec = tv.tv_usec * 1000; \
+} while(0)
+
 
 /* On platforms that don't use standard POSIX threads pthread_sigmask()
  * isn't present.  DEC threads uses sigprocmask() instead as do most
@@ -246,7 +292,153 @@ PyThread_exit_thread(void)
     }
 }
 
-#ifdef USE_SEMAPHORES
+/* All three lock implementations below can wait with a timeout */
+#define Py_HAVE_NATIVE_TIMED_LOCK
+
+#if USE_FUTEX_LOCKS
+
+/*
+ * Lock support.
+ *
+ * The lock word is 0 (unlocked), 1 (locked) or 2 (locked, and threads
+ * may be sleeping on it); see Ulrich Drepper, "Futexes Are Tricky".
+ * An uncontended acquire is one compare-and-swap, an uncontended release
+ * one atomic decrement.  Only a release of a lock in state 2 has to make
+ * the futex system call that wakes a sleeper up.
+ */
+
+typedef struct {
+    int state;
+} futex_lock;
+
+static int
+futex_wait(int *addr, int val, const struct timespec *timeout)
+{
+    return syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, timeout,
+                   NULL, 0);
+}
+
+static void
+futex_wake(int *addr, int n)
+{
+    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, n, NULL, NULL, 0);
+}
+
+/* Store the time left until deadline in ts; return 0 if it has passed. */
+static int
+futex_time_left(const struct timeval *deadline, struct timespec *ts)
+{
+    struct timeval now;
+    long sec, usec;
+
+    GETTIMEOFDAY(&now);
+    sec = deadline->tv_sec - now.tv_sec;
+    usec = deadline->tv_usec - now.tv_usec;
+    if (usec < 0) {
+        usec += 1000000;
+        sec--;
+    }
+    if (sec < 0 || (sec == 0 && usec == 0))
+        return 0;
+    ts->tv_sec = sec;
+    ts->tv_nsec = usec * 1000;
+    return 1;
+}
+
+PyThread_type_lock
+PyThread_allocate_lock(void)
+{
+    futex_lock *lock;
+
+    dprintf(("PyThread_allocate_lock called\n"));
+    if (!initialized)
+        PyThread_init_thread();
+
+    lock = (futex_lock *)malloc(sizeof(futex_lock));
+    if (lock)
+        lock->state = 0;
+
+    dprintf(("PyThread_allocate_lock() -> %p\n", lock));
+    return (PyThread_type_lock)lock;
+}
+
+void
+PyThread_free_lock(PyThread_type_lock lock)
+{
+    dprintf(("PyThread_free_lock(%p) called\n", lock));
+
+    free(lock);
+}
+
+PyLockStatus
+PyThread_acquire_lock_timed(PyThread_type_lock lock, PY_TIMEOUT_T microseconds,
+                            int intr_flag)
+{
+    PyLockStatus success;
+    futex_lock *thelock = (futex_lock *)lock;
+    struct timeval deadline;
+    struct timespec ts, *timeout = NULL;
+    int c;
+
+    dprintf(("PyThread_acquire_lock_timed(%p, %lld, %d) called\n",
+             lock, microseconds, intr_flag));
+
+    c = __sync_val_compare_and_swap(&thelock->state, 0, 1);
+    if (c == 0)
+        success = PY_LOCK_ACQUIRED;
+    else if (microseconds == 0)
+        success = PY_LOCK_FAILURE;
+    else {
+        if (microseconds > 0) {
+            GETTIMEOFDAY(&deadline);
+            deadline.tv_sec += microseconds / 1000000;
+            deadline.tv_usec += microseconds % 1000000;
+            if (deadline.tv_usec >= 1000000) {
+                deadline.tv_usec -= 1000000;
+                deadline.tv_sec++;
+            }
+            timeout = &ts;
+        }
+        /* From here on the lock is marked contended, so whoever releases
+           it will wake a sleeper up.  An exchange that returns 0 means the
+           lock was free and is now ours. */
+        if (c != 2)
+            c = __sync_lock_test_and_set(&thelock->state, 2);
+        success = PY_LOCK_ACQUIRED;
+        while (c != 0) {
+            if (timeout != NULL && !futex_time_left(&deadline, timeout)) {
+                success = PY_LOCK_FAILURE;
+                break;
+            }
+            if (futex_wait(&thelock->state, 2, timeout) < 0 &&
+                errno == EINTR && intr_flag) {
+                success = PY_LOCK_INTR;
+                break;
+            }
+            c = __sync_lock_test_and_set(&thelock->state, 2);
+        }
+    }
+
+    dprintf(("PyThread_acquire_lock_timed(%p, %lld, %d) -> %d\n",
+             lock, microseconds, intr_flag, success));
+    return success;
+}
+
+void
+PyThread_release_lock(PyThread_type_lock lock)
+{
+    futex_lock *thelock = (futex_lock *)lock;
+
+    dprintf(("PyThread_release_lock(%p) called\n", lock));
+
+    if (__sync_fetch_and_sub(&thelock->state, 1) != 1) {
+        /* There may be sleepers: unlock and wake one of them */
+        __sync_lock_release(&thelock->state);
+        futex_wake(&thelock->state, 1);
+    }
+}
+
+#elif defined(USE_SEMAPHORES)
 
 /*
  * Lock support.
@@ -307,31 +499,55 @@ fix_status(int status)
     return (status == -1) ? errno : status;
 }
 
-int
-PyThread_acquire_lock(PyThread_type_lock lock, int waitflag)
+PyLockStatus
+PyThread_acquire_lock_timed(PyThread_type_lock lock, PY_TIMEOUT_T microseconds,
+                            int intr_flag)
 {
-    int success;
+    PyLockStatus success;
     sem_t *thelock = (sem_t *)lock;
     int status, error = 0;
+    struct timespec ts;
 
-    dprintf(("PyThread_acquire_lock(%p, %d) called\n", lock, waitflag));
+    dprintf(("PyThread_acquire_lock_timed(%p, %lld, %d) called\n",
+             lock, microseconds, intr_flag));
 
+    if (microseconds > 0)
+        MICROSECONDS_TO_TIMESPEC(microseconds, ts);
     do {
-        if (waitflag)
-            status = fix_status(sem_wait(thelock));
-        else
+        if (microseconds > 0)
+            status = fix_status(sem_timedwait(thelock, &ts));
+        else if (microseconds == 0)
             status = fix_status(sem_trywait(thelock));
-    } while (status == EINTR); /* Retry if interrupted by a signal */
-
-    if (waitflag) {
-        CHECK_STATUS("sem_wait");
-    } else if (status != EAGAIN) {
-        CHECK_STATUS("sem_trywait");
+        else
+            status = fix_status(sem_wait(thelock));
+        /* Retry if interrupted by a signal, unless the caller wants to be
+           notified.  */
+    } while (!intr_flag && status == EINTR);
+
+    /* Don't check the status if we're stopping because of an interrupt.  */
+    if (!(intr_flag && status == EINTR)) {
+        if (microseconds > 0) {
+            if (status != ETIMEDOUT)
+                CHECK_STATUS("sem_timedwait");
+        }
+        else if (microseconds == 0) {
+            if (status != EAGAIN)
+                CHECK_STATUS("sem_trywait");
+        }
+        else {
+            CHECK_STATUS("sem_wait");
+        }
     }
 
-    success = (status == 0) ? 1 : 0;
+    if (status == 0)
+        success = PY_LOCK_ACQUIRED;
+    else if (intr_flag && status == EINTR)
+        success = PY_LOCK_INTR;
+    else
+        success = PY_LOCK_FAILURE;
 
-    dprintf(("PyThread_acquire_lock(%p, %d) -> %d\n", lock, waitflag, success));
+    dprintf(("PyThread_acquire_lock_timed(%p, %lld, %d) -> %d\n",
+             lock, microseconds, intr_flag, success));
     return success;
 }
 
@@ -347,7 +563,7 @@ PyThread_release_lock(PyThread_type_lock lock)
     CHECK_STATUS("sem_post");
 }
 
-#else /* USE_SEMAPHORES */
+#else /* USE_FUTEX_LOCKS, USE_SEMAPHORES */
 
 /*
  * Lock support.
@@ -402,37 +618,69 @@ PyThread_free_lock(PyThread_type_lock lock)
     free((void *)thelock);
 }
 
-int
-PyThread_acquire_lock(PyThread_type_lock lock, int waitflag)
+PyLockStatus
+PyThread_acquire_lock_timed(PyThread_type_lock lock, PY_TIMEOUT_T microseconds,
+                            int intr_flag)
 {
-    int success;
+    PyLockStatus success;
     pthread_lock *thelock = (pthread_lock *)lock;
     int status, error = 0;
 
-    dprintf(("PyThread_acquire_lock(%p, %d) called\n", lock, waitflag));
+    dprintf(("PyThread_acquire_lock_timed(%p, %lld, %d) called\n",
+             lock, microseconds, intr_flag));
 
     status = pthread_mutex_lock( &thelock->mut );
     CHECK_STATUS("pthread_mutex_lock[1]");
-    success = thelock->locked == 0;
 
-    if ( !success && waitflag ) {
+    if (thelock->locked == 0) {
+        success = PY_LOCK_ACQUIRED;
+    } else if (microseconds == 0) {
+        success = PY_LOCK_FAILURE;
+    } else {
+        struct timespec ts;
+        if (microseconds > 0)
+            MICROSECONDS_TO_TIMESPEC(microseconds, ts);
         /* continue trying until we get the lock */
 
         /* mut must be locked by me -- part of the condition
          * protocol */
-        while ( thelock->locked ) {
-            status = pthread_cond_wait(&thelock->lock_released,
-                                       &thelock->mut);
-            CHECK_STATUS("pthread_cond_wait");
+        success = PY_LOCK_FAILURE;
+        while (success == PY_LOCK_FAILURE) {
+            if (microseconds > 0) {
+                status = pthread_cond_timedwait(
+                    &thelock->lock_released,
+                    &thelock->mut, &ts);
+                if (status == ETIMEDOUT)
+                    break;
+                CHECK_STATUS("pthread_cond_timed_wait");
+            }
+            else {
+                status = pthread_cond_wait(
+                    &thelock->lock_released,
+                    &thelock->mut);
+                CHECK_STATUS("pthread_cond_wait");
+            }
+
+            if (intr_flag && status == 0 && thelock->locked) {
+                /* We were woken up, but didn't get the lock.  We probably
+                 * received a signal.  Return PY_LOCK_INTR to allow the
+                 * caller to handle it and retry.  */
+                success = PY_LOCK_INTR;
+                break;
+            } else if (status == 0 && !thelock->locked) {
+                success = PY_LOCK_ACQUIRED;
+            } else {
+                success = PY_LOCK_FAILURE;
+            }
         }
-        success = 1;
     }
-    if (success) thelock->locked = 1;
+    if (success == PY_LOCK_ACQUIRED) thelock->locked = 1;
     status = pthread_mutex_unlock( &thelock->mut );
     CHECK_STATUS("pthread_mutex_unlock[1]");
 
-    if (error) success = 0;
-    dprintf(("PyThread_acquire_lock(%p, %d) -> %d\n", lock, waitflag, success));
+    if (error) success = PY_LOCK_FAILURE;
+    dprintf(("PyThread_acquire_lock_timed(%p, %lld, %d) -> %d\n",
+             lock, microseconds, intr_flag, success));
     return success;
 }
 
@@ -457,7 +705,13 @@ PyThread_release_lock(PyThread_type_lock lock)
     CHECK_STATUS("pthread_cond_signal");
 }
 
-#endif /* USE_SEMAPHORES */
+#endif /* USE_FUTEX_LOCKS, USE_SEMAPHORES */
+
+int
+PyThread_acquire_lock(PyThread_type_lock lock, int waitflag)
+{
+    return PyThread_acquire_lock_timed(lock, waitflag ? -1 : 0, 0);
+}
 
 /* set the thread stack size.
  * Return 0 if size is valid, -1 if size is invalid,
@@ -36,6 +36,9 @@ THROUGHPUT_DURATION = 2.0
 LATENCY_PING_INTERVAL = 0.1
 LATENCY_DURATION = 2.0
 
+WAKEUP_SLEEP = 0.001
+WAKEUP_DURATION = 2.0
+
 BANDWIDTH_PACKET_SIZE = 1024
 BANDWIDTH_DURATION = 2.0
 
@@ -398,6 +401,86 @@ def run_latency_tests(max_threads):
         print()
 
 
+def run_wakeup_test(func, args, nthreads):
+    # The main thread sleeps WAKEUP_SLEEP seconds at a time, as a thread
+    # waiting for I/O would, and measures how late it runs again.
+    duration = WAKEUP_DURATION
+    delay = WAKEUP_SLEEP
+
+    results = []
+    threads = []
+    end_event = []
+    start_cond = threading.Condition()
+    started = False
+    if nthreads > 0:
+        # Warm up
+        func(*args)
+
+        loop = TimedLoop(func, args)
+        ready = []
+        ready_cond = threading.Condition()
+
+        def run():
+            with ready_cond:
+                ready.append(None)
+                ready_cond.notify()
+            with start_cond:
+                while not started:
+                    start_cond.wait()
+            loop(start_time, duration * 1.5, end_event, do_yield=False)
+
+        for i in range(nthreads):
+            threads.append(threading.Thread(target=run))
+        for t in threads:
+            t.setDaemon(True)
+            t.start()
+        # Wait for threads to be ready
+        with ready_cond:
+            while len(ready) < nthreads:
+                ready_cond.wait()
+
+    _time = time.time
+    _sleep = time.sleep
+    with start_cond:
+        start_time = _time()
+        started = True
+        start_cond.notify(nthreads)
+
+    end_time = start_time + duration
+    t1 = _time()
+    while t1 < end_time:
+        _sleep(delay)
+        t2 = _time()
+        results.append(t2 - t1 - delay)
+        t1 = t2
+
+    # Tell the background threads to stop.
+    end_event.append(None)
+    for t in threads:
+        t.join()
+
+    return results
+
+def run_wakeup_tests(max_threads):
+    print("Sleeping thread: time.sleep(%g)" % WAKEUP_SLEEP)
+    print()
+    for task in latency_tasks:
+        print("Background CPU task:", task.__doc__)
+        print()
+        func, args = task()
+        nthreads = 0
+        while nthreads <= max_threads:
+            results = run_wakeup_test(func, args, nthreads)
+            n = len(results)
+            # We print out milliseconds
+            lats = sorted(1000 * x for x in results)
+            avg = sum(lats) / n
+            print("CPU threads=%d: %.2f ms. (median: %.2f ms., max: %.2f ms.)"
+                  % (nthreads, avg, lats[n // 2], lats[-1]))
+            nthreads += 1
+        print()
+
+
 BW_END = "END"
 
 def bandwidth_client(addr, packet_size, duration):
@@ -534,6 +617,9 @@ def main():
     parser.add_option("-l", "--latency",
                       action="store_true", dest="latency", default=False,
                       help="run latency tests")
+    parser.add_option("-w", "--wakeup",
+                      action="store_true", dest="wakeup", default=False,
+                      help="run wake-up latency tests")
     parser.add_option("-b", "--bandwidth",
                       action="store_true", dest="bandwidth", default=False,
                       help="run I/O bandwidth tests")
@@ -569,8 +655,10 @@ def main():
         bandwidth_client(**kwargs)
         return
 
-    if not options.throughput and not options.latency and not options.bandwidth:
-        options.throughput = options.latency = options.bandwidth = True
+    if (not options.throughput and not options.latency and
+        not options.wakeup and not options.bandwidth):
+        options.throughput = options.latency = True
+        options.wakeup = options.bandwidth = True
     if options.check_interval:
         sys.setcheckinterval(options.check_interval)
     if options.switch_interval:
@@ -600,6 +688,11 @@ def main():
         print()
         run_latency_tests(options.nthreads)
 
+    if options.wakeup:
+        print("--- Wake-up latency ---")
+        print()
+        run_wakeup_tests(options.nthreads)
+
     if options.bandwidth:
         print("--- I/O bandwidth ---")
         print()
@@ -0,0 +1,320 @@
+from pybench import Test
+
+# Dict and set tests with realistic key distributions. Unlike the
+# tests in Dict.py and Lookups.py, which use a handful of short
+# literal keys that never collide, these fill tables with a thousand
+# keys so that the string hash function and the probing strategy
+# (perturbation or LINEAR_PROBING, tabulation hashing) show up in the
+# timings.
+#
+# Keys are stored as (head, tail) pairs and rebuilt with head + tail
+# on every round, so that each round hashes fresh objects instead of
+# reusing the cached ob_shash. Lookups use a second set of fresh keys,
+# so they go through the hash comparison and _PyString_Eq() instead of
+# the identity shortcut. Building the keys is part of the measured
+# time; it is the same for all hash and probing variants.
+
+import random
+
+NKEYS = 1000
+
+def _baseconvert(n, base=36):
+
+    digits = '0123456789abcdefghijklmnopqrstuvwxyz'
+    s = ''
+    while 1:
+        n, r = divmod(n, base)
+        s = digits[r] + s
+        if n == 0:
+            return s
+
+def _split(keys):
+
+    return [(k[:len(k) // 2], k[len(k) // 2:]) for k in keys]
+
+_random = random.Random(42)
+
+# Sequential numeric strings (like testSeq.py)
+SEQUENTIAL_KEYS = _split([_baseconvert(i)
+                          for i in range(100000, 100000 + NKEYS)])
+
+# Random alphanumeric strings of 8-16 characters
+RANDOM_KEYS = _split([
+    ''.join([_random.choice('abcdefghijklmnopqrstuvwxyz0123456789_')
+             for j in range(_random.randint(8, 16))])
+    for i in range(NKEYS)])
+
+# Long shared prefix (URLs)
+PREFIX_KEYS = _split(['http://www.example.com/app/static/images/%d.png' % i
+                      for i in range(NKEYS)])
+
+# Long shared suffix (file system paths)
+SUFFIX_KEYS = _split(['/home/u%d/lib/python2.7/site-packages/__init__.py' % i
+                      for i in range(NKEYS)])
+
+# Ints whose low 10 bits are all zero; adding 0 creates a fresh int
+CLUSTERED_INT_KEYS = [(i << 10, 0) for i in range(NKEYS)]
+
+# Half str, half unicode keys
+MIXED_KEYS = [(a, b) for a, b in RANDOM_KEYS[:NKEYS // 2]] + \
+             [(unicode(a), unicode(b)) for a, b in RANDOM_KEYS[NKEYS // 2:]]
+
+def _dict_fill_lookup(keys, rounds):
+
+    for i in xrange(rounds):
+        d = {}
+        for a, b in keys:
+            d[a + b] = i
+        lookup = [a + b for a, b in keys]
+        for k in lookup:
+            d[k]
+        for k in lookup:
+            d[k]
+        for k in lookup:
+            d[k]
+
+def _set_fill_lookup(keys, rounds):
+
+    for i in xrange(rounds):
+        s = set()
+        for a, b in keys:
+            s.add(a + b)
+        lookup = [a + b for a, b in keys]
+        for k in lookup:
+            k in s
+        for k in lookup:
+            k in s
+        for k in lookup:
+            k in s
+
+def _dict_churn(keys, rounds):
+
+    # Delete every key and insert a different one (tail + head), which
+    # leaves dummy entries behind and forces resizes
+    for i in xrange(rounds):
+        d = {}
+        for a, b in keys:
+            d[a + b] = i
+        for a, b in keys:
+            del d[a + b]
+            d[b + a] = i
+
+def _set_churn(keys, rounds):
+
+    for i in xrange(rounds):
+        s = set()
+        for a, b in keys:
+            s.add(a + b)
+        for a, b in keys:
+            s.remove(a + b)
+            s.add(b + a)
+
+class DictSequentialStringKeys(Test):
+
+    version = 2.0
+    operations = 4 * NKEYS
+    rounds = 1000
+
+    def test(self):
+
+        _dict_fill_lookup(SEQUENTIAL_KEYS, self.rounds)
+
+    def calibrate(self):
+
+        for i in xrange(self.rounds):
+            pass
+
+class SetSequentialStringKeys(Test):
+
+    version = 2.0
+    operations = 4 * NKEYS
+    rounds = 1000
+
+    def test(self):
+
+        _set_fill_lookup(SEQUENTIAL_KEYS, self.rounds)
+
+    def calibrate(self):
+
+        for i in xrange(self.rounds):
+            pass
+
+class DictRandomStringKeys(Test):
+
+    version = 2.0
+    operations = 4 * NKEYS
+    rounds = 1000
+
+    def test(self):
+
+        _dict_fill_lookup(RANDOM_KEYS, self.rounds)
+
+    def calibrate(self):
+
+        for i in xrange(self.rounds):
+            pass
+
+class SetRandomStringKeys(Test):
+
+    version = 2.0
+    operations = 4 * NKEYS
+    rounds = 1000
+
+    def test(self):
+
+        _set_fill_lookup(RANDOM_KEYS, self.rounds)
+
+    def calibrate(self):
+
+        for i in xrange(self.rounds):
+            pass
+
+class DictSharedPrefixKeys(Test):
+
+    version = 2.0
+    operations = 4 * NKEYS
+    rounds = 1000
+
+    def test(self):
+
+        _dict_fill_lookup(PREFIX_KEYS, self.rounds)
+
+    def calibrate(self):
+
+        for i in xrange(self.rounds):
+            pass
+
+class SetSharedPrefixKeys(Test):
+
+    version = 2.0
+    operations = 4 * NKEYS
+    rounds = 1000
+
+    def test(self):
+
+        _set_fill_lookup(PREFIX_KEYS, self.rounds)
+
+    def calibrate(self):
+
+        for i in xrange(self.rounds):
+            pass
+
+class DictSharedSuffixKeys(Test):
+
+    version = 2.0
+    operations = 4 * NKEYS
+    rounds = 1000
+
+    def test(self):
+
+        _dict_fill_lookup(SUFFIX_KEYS, self.rounds)
+
+    def calibrate(self):
+
+        for i in xrange(self.rounds):
+            pass
+
+class SetSharedSuffixKeys(Test):
+
+    version = 2.0
+    operations = 4 * NKEYS
+    rounds = 1000
+
+    def test(self):
+
+        _set_fill_lookup(SUFFIX_KEYS, self.rounds)
+
+    def calibrate(self):
+
+        for i in xrange(self.rounds):
+            pass
+
+class DictClusteredIntKeys(Test):
+
+    version = 2.0
+    operations = 4 * NKEYS
+    rounds = 1000
+
+    def test(self):
+
+        _dict_fill_lookup(CLUSTERED_INT_KEYS, self.rounds)
+
+    def calibrate(self):
+
+        for i in xrange(self.rounds):
+            pass
+
+class SetClusteredIntKeys(Test):
+
+    version = 2.0
+    operations = 4 * NKEYS
+    rounds = 1000
+
+    def test(self):
+
+        _set_fill_lookup(CLUSTERED_INT_KEYS, self.rounds)
+
+    def calibrate(self):
+
+        for i in xrange(self.rounds):
+            pass
+
+class DictMixedStrUnicodeKeys(Test):
+
+    version = 2.0
+    operations = 4 * NKEYS
+    rounds = 1000
+
+    def test(self):
+
+        _dict_fill_lookup(MIXED_KEYS, self.rounds)
+
+    def calibrate(self):
+
+        for i in xrange(self.rounds):
+            pass
+
+class SetMixedStrUnicodeKeys(Test):
+
+    version = 2.0
+    operations = 4 * NKEYS
+    rounds = 1000
+
+    def test(self):
+
+        _set_fill_lookup(MIXED_KEYS, self.rounds)
+
+    def calibrate(self):
+
+        for i in xrange(self.rounds):
+            pass
+
+class DictDeleteReinsert(Test):
+
+    version = 2.0
+    operations = 3 * NKEYS
+    rounds = 1000
+
+    def test(self):
+
+        _dict_churn(RANDOM_KEYS, self.rounds)
+
+    def calibrate(self):
+
+        for i in xrange(self.rounds):
+            pass
+
+class SetDeleteReinsert(Test):
+
+    version = 2.0
+    operations = 3 * NKEYS
+    rounds = 1000
+
+    def test(self):
+
+        _set_churn(RANDOM_KEYS, self.rounds)
+
+    def calibrate(self):
+
+        for i in xrange(self.rounds):
+            pass
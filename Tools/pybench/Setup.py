@@ -29,6 +29,7 @@ except ImportError:
 from Lists import *
 from Tuples import *
 from Dict import *
+from Hashing import *
 from Exceptions import *
 try:
     from With import *
@@ -34,8 +34,9 @@ NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION
 WITH THE USE OR PERFORMANCE OF THIS SOFTWARE !
 """
 
-import sys, time, operator, string, platform
+import sys, os, time, operator, string, platform
 from CommandLine import *
+import significance
 
 try:
     import cPickle
@@ -43,6 +44,11 @@ try:
 except ImportError:
     import pickle
 
+try:
+    import json
+except ImportError:
+    json = None
+
 # Version number; version history: see README file !
 __version__ = '2.0'
 
@@ -70,6 +76,9 @@ CALIBRATION_LOOPS = 20
 # Allow skipping calibration ?
 ALLOW_SKIPPING_CALIBRATION = 1
 
+# Default significance level used for statistical comparisons
+SIGNIFICANCE_LEVEL = 0.05
+
 # Timer types
 TIMER_TIME_TIME = 'time.time'
 TIMER_TIME_CLOCK = 'time.clock'
@@ -131,6 +140,53 @@ def get_machine_details():
         'bits': bits,
         }
 
+def parse_cpu_list(spec):
+
+    """ Parse a CPU list like '0,2-3' into a list of CPU numbers.
+
+    """
+    cpus = []
+    for part in string.split(str(spec), ','):
+        part = string.strip(part)
+        if not part:
+            continue
+        if '-' in part:
+            first, last = string.split(part, '-', 1)
+            cpus.extend(range(int(first), int(last) + 1))
+        else:
+            cpus.append(int(part))
+    if not cpus:
+        raise ValueError('empty CPU list: %r' % spec)
+    return cpus
+
+def set_cpu_affinity(spec):
+
+    """ Pin the current process to the CPUs given in spec (see
+        parse_cpu_list()).
+
+        Uses sched_setaffinity() via ctypes, so this only works on
+        Linux. Raises NotImplementedError on other platforms.
+
+    """
+    cpus = parse_cpu_list(spec)
+    if sys.platform[:5] != 'linux':
+        raise NotImplementedError('CPU affinity is only supported on Linux')
+    try:
+        import ctypes, ctypes.util
+    except ImportError:
+        raise NotImplementedError('CPU affinity needs ctypes')
+    libc = ctypes.CDLL(ctypes.util.find_library('c') or 'libc.so.6',
+                       use_errno=True)
+    setsize = max(1024, max(cpus) + 1)
+    bits = 8 * ctypes.sizeof(ctypes.c_ulong)
+    mask = (ctypes.c_ulong * ((setsize + bits - 1) // bits))()
+    for cpu in cpus:
+        mask[cpu // bits] = mask[cpu // bits] | (1L << (cpu % bits))
+    if libc.sched_setaffinity(0, ctypes.sizeof(mask), ctypes.byref(mask)):
+        errno = ctypes.get_errno()
+        raise OSError(errno, os.strerror(errno))
+    return cpus
+
 def print_machine_details(d, indent=''):
 
     l = ['Machine Details:',
@@ -748,6 +804,262 @@ class Benchmark:
                                        compare_to.name)
         print
 
+    def print_significance(self, compare_to, alpha=SIGNIFICANCE_LEVEL,
+                           hidenoise=0, limitnames=None):
+
+        """ Compare the raw per-round timings of this benchmark with
+            compare_to and flag only the statistically significant
+            differences (see significance.py).
+
+            Timings are scaled by the warp factor, so benchmarks run
+            at different warp factors can be compared.
+
+        """
+        # Check benchmark versions
+        if compare_to.version != self.version:
+            print ('* Benchmark versions differ: '
+                   'cannot compare this benchmark to "%s" !' %
+                   compare_to.name)
+            print
+            self.print_benchmark(hidenoise=hidenoise,
+                                 limitnames=limitnames)
+            return
+
+        # Print header
+        compare_to.print_header('Comparing with')
+        print ('Test                          '
+               '   median run-time          %2i%% confidence' %
+               int((1.0 - alpha) * PERCENT + 0.5))
+        print ('                              '
+               '   this    other   diff     interval          p-value')
+        print '-' * LINE
+
+        tests = self.tests.items()
+        tests.sort()
+        benchmarks_compatible = self.compatible(compare_to)
+        this_totals = []
+        other_totals = []
+        significant = 0
+        for name, test in tests:
+            if (limitnames is not None and
+                limitnames.search(name) is None):
+                continue
+            other = compare_to.tests.get(name)
+            if (other is None or
+                not benchmarks_compatible or
+                not test.compatible(other) or
+                not test.times or not other.times):
+                print '%30s:   %s' % (name, 'n/a')
+                continue
+            this_times = [t * self.warp for t in test.times]
+            other_times = [t * compare_to.warp for t in other.times]
+            _add_round_times(this_totals, this_times)
+            _add_round_times(other_totals, other_times)
+            result = significance.compare(this_times, other_times, alpha)
+            if result.significant:
+                significant = significant + 1
+                flag = '*'
+            elif hidenoise:
+                continue
+            else:
+                flag = ''
+            print ('%30s: %5.0fms %5.0fms %+6.1f%% '
+                   '[%+6.1f%%, %+6.1f%%] %7.4f %s' %
+                   (name,
+                    result.this_median * MILLI_SECONDS / self.warp,
+                    result.other_median * MILLI_SECONDS / self.warp,
+                    result.diff * PERCENT,
+                    result.ci_low * PERCENT,
+                    result.ci_high * PERCENT,
+                    result.p,
+                    flag))
+        print '-' * LINE
+        if this_totals and other_totals:
+            result = significance.compare(this_totals, other_totals, alpha)
+            if result.significant:
+                flag = '*'
+            else:
+                flag = ''
+            print ('Totals:                        '
+                   ' %5.0fms %5.0fms %+6.1f%% '
+                   '[%+6.1f%%, %+6.1f%%] %7.4f %s' %
+                   (result.this_median * MILLI_SECONDS / self.warp,
+                    result.other_median * MILLI_SECONDS / self.warp,
+                    result.diff * PERCENT,
+                    result.ci_low * PERCENT,
+                    result.ci_high * PERCENT,
+                    result.p,
+                    flag))
+        print
+        print '%i significant change(s) at p < %s, marked with *' % (
+            significant, alpha)
+        print '(this=%s, other=%s)' % (self.name,
+                                       compare_to.name)
+        print
+
+    def merge(self, other):
+
+        """ Append the test timings of the benchmark other to the ones
+            of this benchmark. Used to combine the results of
+            interleaved runs.
+
+        """
+        for name, test in other.tests.items():
+            mine = self.tests.get(name)
+            if mine is None:
+                self.tests[name] = test
+            else:
+                mine.times.extend(test.times)
+                mine.overhead_times.extend(test.overhead_times)
+        self.roundtimes.extend(other.roundtimes)
+        self.rounds = len(self.roundtimes)
+
+    def as_json(self):
+
+        """ Return a dictionary with the raw timings of the benchmark,
+            suitable for json.dump().
+
+        """
+        tests = {}
+        for name, test in self.tests.items():
+            tests[name] = {
+                'version': test.version,
+                'rounds': test.rounds,
+                'operations': test.operations,
+                'warp': test.warp,
+                'times': test.times,
+                'overhead_times': test.overhead_times,
+                }
+        return {
+            'pybench': __version__,
+            'name': self.name,
+            'version': self.version,
+            'rounds': self.rounds,
+            'warp': self.warp,
+            'timer': self.timer,
+            'calibration_runs': self.calibration_runs,
+            'machine_details': self.machine_details,
+            'roundtimes': getattr(self, 'roundtimes', []),
+            'tests': tests,
+            }
+
+    def save_json(self, filename):
+
+        if json is None:
+            raise NotImplementedError('JSON output needs the json module')
+        f = open(filename, 'w')
+        try:
+            json.dump(self.as_json(), f, indent=1, sort_keys=True)
+            f.write('\n')
+        finally:
+            f.close()
+
+def _add_round_times(totals, times):
+
+    """ Add times to the per-round totals list, element-wise.
+
+    """
+    if not totals:
+        totals.extend(times)
+        return
+    del totals[len(times):]
+    for i in range(len(totals)):
+        totals[i] = totals[i] + times[i]
+
+def benchmark_from_json(data):
+
+    """ Create a Benchmark instance from a dictionary written by
+        Benchmark.as_json().
+
+    """
+    bench = Benchmark(data['name'])
+    bench.version = data['version']
+    bench.rounds = data['rounds']
+    bench.warp = data['warp']
+    bench.timer = str(data['timer'])
+    bench.calibration_runs = data['calibration_runs']
+    bench.machine_details = data['machine_details']
+    bench.roundtimes = data.get('roundtimes', [])
+    for name, d in data['tests'].items():
+        test = Test()
+        test.version = d['version']
+        test.rounds = d['rounds']
+        test.operations = d['operations']
+        test.warp = d['warp']
+        test.timer = bench.timer
+        test.times = d['times']
+        test.overhead_times = d['overhead_times']
+        if test.times:
+            test.last_timing = (test.times[-1], test.times[-1], 0.0)
+        bench.tests[str(name)] = test
+    return bench
+
+def load_benchmark(filename):
+
+    """ Load a benchmark saved with -f (pickle) or --json.
+
+    """
+    f = open(filename, 'rb')
+    try:
+        data = f.read()
+    finally:
+        f.close()
+    if data[:1] == '{':
+        if json is None:
+            raise NotImplementedError('JSON input needs the json module')
+        bench = benchmark_from_json(json.loads(data))
+    else:
+        bench = pickle.loads(data)
+    bench.name = filename
+    return bench
+
+def run_interleaved(interpreters, rounds, args, jsonfile=None):
+
+    """ Run the benchmark suite one round at a time, alternating
+        between the given interpreters in ABBA order so that slow
+        drifts of the machine state affect all of them alike.
+
+        args are passed to each child run. Returns the list of merged
+        Benchmark instances, one per interpreter.
+
+    """
+    import tempfile, subprocess
+    fd, tmpname = tempfile.mkstemp(suffix='.json', prefix='pybench-')
+    os.close(fd)
+    script = os.path.abspath(__file__)
+    if script[-4:] in ('.pyc', '.pyo'):
+        script = script[:-1]
+    devnull = open(os.devnull, 'w')
+    results = [None] * len(interpreters)
+    try:
+        for i in range(rounds):
+            order = range(len(interpreters))
+            if i % 2:
+                order.reverse()
+            for j in order:
+                cmd = [interpreters[j], script,
+                       '-n', '1', '--json', tmpname] + args
+                rc = subprocess.call(cmd, stdout=devnull)
+                if rc:
+                    raise SystemExit('* %s failed with exit status %i' %
+                                     (string.join(cmd), rc))
+                bench = load_benchmark(tmpname)
+                if results[j] is None:
+                    results[j] = bench
+                else:
+                    results[j].merge(bench)
+            print '* Round %i done.' % (i+1)
+            sys.stdout.flush()
+    finally:
+        devnull.close()
+        os.unlink(tmpname)
+    for j in range(len(interpreters)):
+        results[j].name = interpreters[j]
+        if jsonfile:
+            results[j].save_json('%s.%i' % (jsonfile, j))
+    print
+    return results
+
 class PyBenchCmdline(Application):
 
     header = ("PYBENCH - a benchmark test suite for Python "
@@ -793,6 +1105,22 @@ class PyBenchCmdline(Application):
                ArgumentOption('--timer',
                             'use given timer',
                             TIMER_PLATFORM_DEFAULT),
+               ArgumentOption('--json',
+                              'save raw test timings as JSON to file arg',
+                              ''),
+               SwitchOption('--stats',
+                            'use significance tests in comparisons',
+                            0),
+               ArgumentOption('--alpha',
+                              'significance level for --stats',
+                              SIGNIFICANCE_LEVEL),
+               ArgumentOption('--affinity',
+                              'pin the benchmark to CPU list arg',
+                              ''),
+               ArgumentOption('--interleave',
+                              'run interpreters arg=a,b alternately '
+                              'and compare',
+                              ''),
                ]
 
     about = """\
@@ -810,6 +1138,12 @@ Examples:
 python2.1 pybench.py -f p21.pybench
 python2.5 pybench.py -f p25.pybench
 python pybench.py -s p25.pybench -c p21.pybench
+
+Raw timings and significance tests:
+
+python pybench.py --json new.json
+python pybench.py --stats -s new.json -c old.json
+python pybench.py --affinity 2 --interleave python-clean,python-opt
 """
     copyright = __copyright__
 
@@ -834,6 +1168,11 @@ python pybench.py -s p25.pybench -c p21.pybench
         withsyscheck = self.values['--with-syscheck']
         calibration_runs = self.values['-C']
         timer = self.values['--timer']
+        jsonfile = self.values['--json']
+        withstats = self.values['--stats']
+        alpha = float(self.values['--alpha'])
+        affinity = self.values['--affinity']
+        interleave = self.values['--interleave']
 
         print '-' * LINE
         print 'PYBENCH %s' % __version__
@@ -874,15 +1213,47 @@ python pybench.py -s p25.pybench -c p21.pybench
         else:
             print '* using timer: %s' % timer
 
+        if affinity != '':
+            try:
+                cpus = set_cpu_affinity(affinity)
+            except (NotImplementedError, OSError, ValueError), reason:
+                print '* could not set CPU affinity: %s' % reason
+            else:
+                print '* pinned to CPU(s): %s' % string.join(map(str, cpus),
+                                                            ',')
+
         print
 
+        if interleave:
+            interpreters = string.split(interleave, ',')
+            if len(interpreters) != 2:
+                print '* --interleave needs exactly two interpreters'
+                return
+            args = ['-w', str(warp), '-C', str(calibration_runs),
+                    '--timer', timer]
+            if self.values['-t']:
+                args = args + ['-t', self.values['-t']]
+            if withgc:
+                args.append('--with-gc')
+            if withsyscheck:
+                args.append('--with-syscheck')
+            if affinity != '':
+                args = args + ['--affinity', str(affinity)]
+            print 'Running %i interleaved round(s) of %s:' % (
+                rounds, string.join(interpreters, ' and '))
+            print
+            other, bench = run_interleaved(interpreters, rounds, args,
+                                           jsonfile)
+            bench.print_header()
+            bench.print_significance(other,
+                                     alpha=alpha,
+                                     hidenoise=hidenoise,
+                                     limitnames=limitnames)
+            return
+
         if compare_to:
             try:
-                f = open(compare_to,'rb')
-                bench = pickle.load(f)
-                bench.name = compare_to
-                f.close()
-                compare_to = bench
+                compare_to = load_benchmark(compare_to)
             except IOError, reason:
                 print '* Error opening/reading file %s: %s' % (
                     repr(compare_to),
@@ -891,12 +1262,14 @@ python pybench.py -s p25.pybench -c p21.pybench
 
         if show_bench:
             try:
-                f = open(show_bench,'rb')
-                bench = pickle.load(f)
-                bench.name = show_bench
-                f.close()
+                bench = load_benchmark(show_bench)
                 bench.print_header()
-                if compare_to:
+                if compare_to and withstats:
+                    bench.print_significance(compare_to,
+                                             alpha=alpha,
+                                             hidenoise=hidenoise,
+                                             limitnames=limitnames)
+                elif compare_to:
                     bench.print_comparison(compare_to,
                                            hidenoise=hidenoise,
                                            limitnames=limitnames)
@@ -932,7 +1305,12 @@ python pybench.py -s p25.pybench -c p21.pybench
             print
             return
         bench.print_header()
-        if compare_to:
+        if compare_to and withstats:
+            bench.print_significance(compare_to,
+                                     alpha=alpha,
+                                     hidenoise=hidenoise,
+                                     limitnames=limitnames)
+        elif compare_to:
             bench.print_comparison(compare_to,
                                    hidenoise=hidenoise,
                                    limitnames=limitnames)
@@ -943,6 +1321,15 @@ python pybench.py -s p25.pybench -c p21.pybench
         # Ring bell
         sys.stderr.write('\007')
 
+        if jsonfile:
+            try:
+                bench.save_json(jsonfile)
+            except (IOError, NotImplementedError), reason:
+                print '* Error writing JSON file %s: %s' % (
+                    jsonfile,
+                    reason)
+                print
+
         if reportfile:
             try:
                 f = open(reportfile,'wb')
@@ -0,0 +1,153 @@
+#!/usr/bin/env python
+
+""" Statistical helpers used by pybench to decide whether the
+    difference between two sets of timings is real or just noise.
+
+    Two independent estimates are combined:
+
+    * the two-sided Mann-Whitney U test (normal approximation with
+      tie and continuity correction), which does not assume the
+      timings are normally distributed, and
+
+    * a percentile bootstrap confidence interval for the relative
+      difference of the medians, median(this) / median(other) - 1.
+
+    A change is only reported as significant if the U test rejects
+    the null hypothesis at the requested level *and* the confidence
+    interval does not contain 0.
+
+"""
+import math, random
+
+# Number of bootstrap resamples
+BOOTSTRAP_RESAMPLES = 2000
+
+# Seed used for the bootstrap, so that reports are reproducible
+BOOTSTRAP_SEED = 1234
+
+def median(values):
+
+    """ Return the median of the sequence values.
+
+    """
+    l = list(values)
+    l.sort()
+    n = len(l)
+    if n == 0:
+        raise ValueError('median of empty sequence')
+    if n % 2:
+        return l[n // 2]
+    return (l[n // 2 - 1] + l[n // 2]) / 2.0
+
+def _ranks(values):
+
+    """ Return the list of (1-based) ranks for values, averaging the
+        ranks of tied entries, and the tie correction term
+        sum(t**3 - t) over all groups of t tied values.
+
+    """
+    order = range(len(values))
+    order.sort(lambda i, j, values=values: cmp(values[i], values[j]))
+    ranks = [0.0] * len(values)
+    ties = 0.0
+    i = 0
+    while i < len(order):
+        j = i
+        while (j + 1 < len(order) and
+               values[order[j + 1]] == values[order[i]]):
+            j = j + 1
+        rank = (i + j) / 2.0 + 1.0
+        for k in range(i, j + 1):
+            ranks[order[k]] = rank
+        t = j - i + 1
+        ties = ties + (t ** 3 - t)
+        i = j + 1
+    return ranks, ties
+
+def mann_whitney_u(a, b):
+
+    """ Two-sided Mann-Whitney U test for the samples a and b.
+
+        Returns a tuple (U, p) where U is the statistic for sample a
+        and p the two-sided p-value. The p-value is based on the
+        normal approximation, which is reasonable from about 8
+        samples per group on; with fewer samples it is conservative
+        only in spirit, so use more rounds for small effects.
+
+    """
+    n1 = len(a)
+    n2 = len(b)
+    if n1 == 0 or n2 == 0:
+        raise ValueError('both samples must be non-empty')
+    ranks, ties = _ranks(list(a) + list(b))
+    r1 = 0.0
+    for r in ranks[:n1]:
+        r1 = r1 + r
+    u1 = r1 - n1 * (n1 + 1) / 2.0
+    n = n1 + n2
+    mean = n1 * n2 / 2.0
+    var = n1 * n2 / 12.0 * ((n + 1) - ties / float(n * (n - 1)))
+    if var <= 0.0:
+        # All values are identical
+        return u1, 1.0
+    z = (abs(u1 - mean) - 0.5) / math.sqrt(var)
+    if z < 0.0:
+        z = 0.0
+    p = math.erfc(z / math.sqrt(2.0))
+    return u1, min(p, 1.0)
+
+def bootstrap_ci(a, b, confidence=0.95, resamples=BOOTSTRAP_RESAMPLES,
+                 seed=BOOTSTRAP_SEED):
+
+    """ Percentile bootstrap confidence interval for the relative
+        difference median(a) / median(b) - 1.
+
+        Returns a tuple (low, high).
+
+    """
+    rng = random.Random(seed)
+    n1 = len(a)
+    n2 = len(b)
+    diffs = []
+    for i in range(resamples):
+        ra = [a[int(rng.random() * n1)] for j in range(n1)]
+        rb = [b[int(rng.random() * n2)] for j in range(n2)]
+        mb = median(rb)
+        if mb == 0.0:
+            continue
+        diffs.append(median(ra) / mb - 1.0)
+    if not diffs:
+        return 0.0, 0.0
+    diffs.sort()
+    tail = (1.0 - confidence) / 2.0
+    low = diffs[int(tail * (len(diffs) - 1))]
+    high = diffs[int((1.0 - tail) * (len(diffs) - 1) + 0.5)]
+    return low, high
+
+class Comparison:
+
+    """ Result of comparing the timings this against other.
+
+    """
+    def __init__(self, this, other, alpha=0.05,
+                 resamples=BOOTSTRAP_RESAMPLES):
+
+        self.this_median = median(this)
+        self.other_median = median(other)
+        if self.other_median:
+            self.diff = self.this_median / self.other_median - 1.0
+        else:
+            self.diff = 0.0
+        self.u, self.p = mann_whitney_u(this, other)
+        self.ci_low, self.ci_high = bootstrap_ci(this, other,
+                                                 1.0 - alpha, resamples)
+        self.significant = (self.p < alpha and
+                            (self.ci_low > 0.0 or self.ci_high < 0.0))
+
+def compare(this, other, alpha=0.05, resamples=BOOTSTRAP_RESAMPLES):
+
+    """ Compare the two timing samples this and other and return a
+        Comparison instance.
+
+    """
+    return Comparison(this, other, alpha, resamples)
@@ -0,0 +1,226 @@
+#!/usr/bin/env python
+# Runs the application benchmarks from benchmark/appBenchmark.txt (2to3,
+# django, slowpickle, spambayes, spitfire, ...) under a control and a test
+# interpreter and puts, per app and binary, the timings (min/avg/stddev),
+# the INSTRUMENT_DICT counters and the share of CPU time spent hashing and
+# probing (sampled with Linux perf, if installed) into one report.
+#
+#   python appbench.py --perf-dir ~/benchmarks python-clean python-opt
+#   python appbench.py --perf-dir ~/benchmarks -b django,spambayes \
+#       --json report.json python-clean python-opt
+#
+# The apps themselves live in a checkout of the perf.py benchmark suite
+# (--perf-dir); the command lines are the ones recorded in
+# benchmark/appBenchmark.txt.  Build both binaries with -DINSTRUMENT_DICT
+# to get the probe counts and chain length.
+
+import os, sys, re, time, math, json, subprocess, tempfile, optparse
+
+SRCDIR = os.path.dirname(os.path.abspath(__file__))
+
+# Functions counted as "hash" and "lookup" time in the perf profile
+hash_symbols = ('string_hash', 'unicode_hash')
+lookup_symbols = ('lookdict', 'lookdict_string', 'insertdict',
+                  'insertdict_by_entry', 'insertdict_clean', 'dictresize',
+                  'set_lookkey', 'set_lookkey_string', 'set_insert_key',
+                  'set_table_resize')
+
+counter_names = ('slookupcount', 'sprobecount', 'nlookupcount',
+                 'nprobecount', 'chain-length')
+
+def read_app_benchmarks(filename=None):
+    """Return [(name, args)] for the runs listed in appBenchmark.txt."""
+    if filename is None:
+        filename = os.path.join(SRCDIR, 'benchmark', 'appBenchmark.txt')
+    apps = []
+    current = None
+    for line in open(filename):
+        m = re.match(r'Running (\S+)\.\.\.$', line.strip())
+        if m:
+            current = m.group(1)
+            continue
+        m = re.match(r'INFO:root:Running test/bin/python (.*)$', line.strip())
+        if m and current and current not in dict(apps):
+            apps.append((current, m.group(1).split()))
+    return apps
+
+def parse_counters(output):
+    """Return the last INSTRUMENT_DICT JSON line in output (or {})."""
+    counters = {}
+    for line in output.splitlines():
+        line = line.strip()
+        if line.startswith('{"nlookupcount"'):
+            try:
+                counters = json.loads(line)
+            except ValueError:
+                pass
+    return counters
+
+def parse_times(output):
+    """The bm_*.py scripts print one float per iteration."""
+    times = []
+    for line in output.splitlines():
+        if re.match(r'^\d+\.\d+$', line.strip()):
+            times.append(float(line))
+    return times
+
+def summarize(times):
+    n = len(times)
+    avg = sum(times) / n
+    if n > 1:
+        stddev = math.sqrt(sum([(t - avg) ** 2 for t in times]) / (n - 1))
+    else:
+        stddev = 0.0
+    return {'min': min(times), 'avg': avg, 'stddev': stddev, 'n': n}
+
+def run_app(python, args, cwd, runs=1):
+    """Run one app `runs` times; return timings and counters (or None)."""
+    times = []
+    counters = {}
+    for i in range(runs):
+        t = time.time()
+        proc = subprocess.Popen([python, '-E'] + args, cwd=cwd,
+                                stdout=subprocess.PIPE,
+                                stderr=open(os.devnull, 'w'))
+        output = proc.communicate()[0]
+        t = time.time() - t
+        if proc.returncode:
+            return None
+        # Use the per-iteration times if the script reports them,
+        # otherwise the wall time of the whole process.
+        times.extend(parse_times(output) or [t])
+        counters = parse_counters(output)
+    result = summarize(times)
+    result['counters'] = counters
+    return result
+
+def have_perf():
+    for d in os.environ.get('PATH', '').split(os.pathsep):
+        if os.access(os.path.join(d, 'perf'), os.X_OK):
+            return True
+    return False
+
+def profile_app(python, args, cwd, frequency=999):
+    """Sample one run with perf; return the percentage of samples in the
+    hash and dict/set lookup functions (or None without perf)."""
+    if not have_perf():
+        return None
+    fd, data = tempfile.mkstemp(prefix='appbench-', suffix='.data')
+    os.close(fd)
+    devnull = open(os.devnull, 'w')
+    try:
+        rc = subprocess.call(['perf', 'record', '-q', '-F', str(frequency),
+                              '-o', data, '--', python, '-E'] + args,
+                             cwd=cwd, stdout=devnull, stderr=devnull)
+        if rc:
+            return None
+        proc = subprocess.Popen(['perf', 'report', '-i', data, '--stdio',
+                                 '--no-children', '--sort', 'symbol'],
+                                stdout=subprocess.PIPE, stderr=devnull)
+        report = proc.communicate()[0]
+    finally:
+        devnull.close()
+        os.unlink(data)
+    hash_pct = lookup_pct = 0.0
+    for line in report.splitlines():
+        m = re.match(r'\s*([\d.]+)%\s+\[\.\]\s+(\S+)', line)
+        if not m:
+            continue
+        pct, symbol = float(m.group(1)), m.group(2)
+        if symbol in hash_symbols:
+            hash_pct += pct
+        elif symbol in lookup_symbols:
+            lookup_pct += pct
+    return {'hash_pct': hash_pct, 'lookup_pct': lookup_pct}
+
+def fmt(value, spec='%.4f'):
+    if value is None:
+        return 'n/a'
+    return spec % value
+
+def print_report(report, binaries):
+    for app in report['apps']:
+        name = app['name']
+        print '### %s ###' % name
+        rows = [('', 'min', 'avg', 'stddev', 'lookups', 'probes',
+                 'chain', 'hash%', 'hash s', 'lookup%')]
+        for label in binaries:
+            r = app['results'].get(label)
+            if r is None:
+                rows.append((label, 'failed') + ('',) * 8)
+                continue
+            c = r['counters']
+            p = r.get('profile') or {}
+            hash_time = None
+            if 'hash_pct' in p:
+                hash_time = r['avg'] * p['hash_pct'] / 100.0
+            rows.append((label, fmt(r['min']), fmt(r['avg']),
+                         fmt(r['stddev'], '%.5f'),
+                         fmt(c.get('slookupcount'), '%d'),
+                         fmt(c.get('sprobecount'), '%d'),
+                         fmt(c.get('chain-length'), '%.3f'),
+                         fmt(p.get('hash_pct'), '%.1f'),
+                         fmt(hash_time),
+                         fmt(p.get('lookup_pct'), '%.1f')))
+        widths = [max([len(r[i]) for r in rows]) for i in range(len(rows[0]))]
+        for row in rows:
+            print '  '.join([c.rjust(w) for c, w in zip(row, widths)])
+        control = app['results'].get(binaries[0])
+        test = app['results'].get(binaries[1])
+        if control and test:
+            print 'Min: %.6f -> %.6f: %.2fx %s' % (
+                control['min'], test['min'],
+                max(control['min'], test['min']) /
+                    min(control['min'], test['min']),
+                control['min'] >= test['min'] and 'faster' or 'slower')
+            cp = control['counters'].get('sprobecount')
+            tp = test['counters'].get('sprobecount')
+            if cp and tp:
+                print 'String probes: %d -> %d (%+.1f%%)' % (
+                    cp, tp, 100.0 * (tp - cp) / cp)
+        print
+
+def main():
+    parser = optparse.OptionParser(
+        usage='%prog [options] control_python test_python')
+    parser.add_option('--perf-dir',
+                      help='checkout of the perf.py benchmark suite')
+    parser.add_option('-b', '--benchmarks', default=None,
+                      help='comma separated list of apps (default: all '
+                           'listed in benchmark/appBenchmark.txt)')
+    parser.add_option('-r', '--runs', type='int', default=1,
+                      help='processes per app and binary')
+    parser.add_option('--no-profile', action='store_true', default=False,
+                      help='do not sample hash time with perf')
+    parser.add_option('--json', default=None, help='also write report here')
+    opts, args = parser.parse_args()
+    if len(args) != 2 or not opts.perf_dir:
+        parser.error('need --perf-dir and two interpreters')
+    binaries = [os.path.abspath(a) for a in args]
+
+    apps = read_app_benchmarks()
+    if opts.benchmarks:
+        wanted = opts.benchmarks.split(',')
+        apps = [(n, a) for n, a in apps if n in wanted]
+    if not opts.no_profile and not have_perf():
+        print '* perf not found, hash time will not be sampled'
+
+    report = {'binaries': binaries, 'apps': []}
+    for name, app_args in apps:
+        print 'Running %s...' % name
+        sys.stdout.flush()
+        entry = {'name': name, 'args': app_args, 'results': {}}
+        for python in binaries:
+            result = run_app(python, app_args, opts.perf_dir, opts.runs)
+            if result is not None and not opts.no_profile:
+                result['profile'] = profile_app(python, app_args,
+                                                opts.perf_dir)
+            entry['results'][python] = result
+        report['apps'].append(entry)
+    print
+    print_report(report, binaries)
+    if opts.json:
+        json.dump(report, open(opts.json, 'w'), indent=1, sort_keys=True)
+
+if __name__ == '__main__':
+    main()
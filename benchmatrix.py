@@ -0,0 +1,259 @@
+#!/usr/bin/env python
+# Builds a matrix of IFDEF variants out of tree (in parallel) and runs
+# pybench, the hash-table-shootout workloads and the application
+# benchmarks from benchmark/appBenchmark.txt against every variant.
+# All variants are built with -DINSTRUMENT_DICT, so the dict counters
+# end up in the report next to the timings.
+#
+#   python benchmatrix.py                         # variants from generateAll.py
+#   python benchmatrix.py -v lp=LINEAR_PROBING -v thm8=TABULATION_MAIN,TABLE_MASK=7
+#   python benchmatrix.py -a LINEAR_PROBING -a TABULATION_MAIN -a '|TABLE_MASK=3|TABLE_MASK=7'
+#   python benchmatrix.py --perf-dir ~/benchmarks  # also run the app benchmarks
+#
+# An axis "A" is off/on, an axis "A|B" picks one of A and B, and a
+# leading "|" adds an "off" choice.  Results are printed as one table and
+# written to <outdir>/results.json and <outdir>/results.csv.
+
+import os, sys, json, signal, subprocess, itertools, optparse
+from multiprocessing.pool import ThreadPool
+from appbench import read_app_benchmarks, parse_counters, run_app, \
+     counter_names
+
+SRCDIR = os.path.dirname(os.path.abspath(__file__))
+
+default_variants = {
+    'p0': [],
+    'lp': ['LINEAR_PROBING'],
+    'thm8': ['TABULATION_MAIN'],
+    'lpthm8': ['LINEAR_PROBING', 'TABULATION_MAIN', 'TABLE_MASK=7'],
+    'lpthm8pf': ['LINEAR_PROBING', 'TABULATION_MAIN', 'TABLE_MASK=7',
+                 'TABULATION_PREFETCH'],
+}
+
+shootout_benchtypes = ('sequential', 'random', 'delete',
+                       'sequentialstring', 'randomstring', 'deletestring')
+
+def short_name(flag):
+    name = flag.split('=')
+    short = ''.join([w[0] for w in name[0].lower().split('_')])
+    if len(name) > 1:
+        short += name[1]
+    return short
+
+def expand_axes(axes):
+    choices = []
+    for axis in axes:
+        alts = axis.split('|')
+        if len(alts) == 1:
+            alts = ['', axis]
+        choices.append(alts)
+    variants = {}
+    for combo in itertools.product(*choices):
+        flags = []
+        for c in combo:
+            flags.extend([f for f in c.split(',') if f])
+        name = ''.join([short_name(f) for f in flags]) or 'base'
+        variants[name] = flags
+    return variants
+
+def cflags(flags):
+    return ' '.join(['-DINSTRUMENT_DICT'] + ['-D' + f for f in flags])
+
+def run(cmd, cwd, log, env=None):
+    out = open(log, 'a')
+    try:
+        out.write('$ %s\n' % ' '.join(cmd))
+        out.flush()
+        return subprocess.call(cmd, cwd=cwd, stdout=out, stderr=out, env=env)
+    finally:
+        out.close()
+
+def build_variant(args):
+    name, flags, opts = args
+    builddir = os.path.join(opts.outdir, name)
+    log = os.path.join(builddir, 'build.log')
+    if not os.path.isdir(builddir):
+        os.makedirs(builddir)
+    if not os.path.exists(os.path.join(builddir, 'Makefile')):
+        if run([os.path.join(SRCDIR, 'configure')], builddir, log):
+            return name, 'configure failed, see %s' % log
+    env = dict(os.environ, EXTRA_CFLAGS=cflags(flags))
+    if run(['make', '-j%d' % opts.make_jobs], builddir, log, env):
+        return name, 'make failed, see %s' % log
+    shootout = os.path.join(SRCDIR, 'hash-table-shootout', 'src')
+    cmd = (['gcc'] + cflags(flags).split() +
+           ['-g', '-O2', '-I' + builddir,
+            '-I' + os.path.join(SRCDIR, 'Include'),
+            os.path.join(shootout, 'python_dict.c'),
+            os.path.join(builddir, 'libpython2.7.a'),
+            '-lutil', '-lpthread', '-ldl', '-lm',
+            '-o', os.path.join(builddir, 'python_dict')])
+    if run(cmd, builddir, log):
+        return name, 'python_dict build failed, see %s' % log
+    return name, None
+
+def run_pybench(name, opts):
+    builddir = os.path.join(opts.outdir, name)
+    jsonfile = os.path.join(builddir, 'pybench.json')
+    cmd = [os.path.join(builddir, 'python'), '-E',
+           os.path.join(SRCDIR, 'Tools', 'pybench', 'pybench.py'),
+           '-n', str(opts.pybench_rounds), '--json', jsonfile]
+    if opts.affinity:
+        cmd += ['--affinity', opts.affinity]
+    proc = subprocess.Popen(cmd, stdout=subprocess.PIPE,
+                            stderr=open(os.devnull, 'w'))
+    output = proc.communicate()[0]
+    open(os.path.join(builddir, 'pybench.out'), 'w').write(output)
+    result = {'counters': parse_counters(output)}
+    if proc.returncode == 0 and os.path.exists(jsonfile):
+        data = json.load(open(jsonfile))
+        total_min = total_avg = 0.0
+        for test in data['tests'].values():
+            if test['times']:
+                total_min += min(test['times'])
+                total_avg += sum(test['times']) / len(test['times'])
+        result['min'] = total_min
+        result['avg'] = total_avg
+    return result
+
+def run_shootout(name, benchtype, opts):
+    # python_dict prints the run time and the counters, then sleeps so
+    # that bench.py can measure its RSS; we kill it once we have both.
+    program = os.path.join(opts.outdir, name, 'python_dict')
+    best = None
+    for attempt in range(opts.best_out_of):
+        proc = subprocess.Popen([program, str(opts.nkeys), benchtype],
+                                stdout=subprocess.PIPE)
+        try:
+            runtime = float(proc.stdout.readline().strip())
+            counters = parse_counters(proc.stdout.readline())
+        except ValueError:
+            runtime, counters = None, {}
+        try:
+            os.kill(proc.pid, signal.SIGKILL)
+        except OSError:
+            pass
+        proc.wait()
+        if runtime is not None and (best is None or runtime < best['min']):
+            best = {'min': runtime, 'counters': counters}
+    return best
+
+def print_table(results, columns):
+    header = ['variant'] + columns
+    rows = [header]
+    for name in sorted(results):
+        row = [name]
+        for col in columns:
+            value = results[name].get(col)
+            if value is None:
+                row.append('-')
+            elif isinstance(value, float):
+                row.append('%.4f' % value)
+            else:
+                row.append(str(value))
+        rows.append(row)
+    widths = [max([len(r[i]) for r in rows]) for i in range(len(header))]
+    for row in rows:
+        print '  '.join([c.rjust(w) for c, w in zip(row, widths)])
+    return rows
+
+def main():
+    parser = optparse.OptionParser(usage='%prog [options]')
+    parser.add_option('-v', '--variant', action='append', default=[],
+                      help='NAME=FLAG1,FLAG2,... (repeatable)')
+    parser.add_option('-a', '--axis', action='append', default=[],
+                      help='matrix axis, e.g. LINEAR_PROBING or "|A|B"')
+    parser.add_option('-o', '--outdir', default='build-variants')
+    parser.add_option('-j', '--jobs', type='int', default=2,
+                      help='number of variants built in parallel')
+    parser.add_option('--make-jobs', type='int', default=1,
+                      help='make -j for each variant')
+    parser.add_option('--pybench-rounds', type='int', default=10)
+    parser.add_option('--nkeys', type='int', default=2 * 1000 * 1000)
+    parser.add_option('--best-out-of', type='int', default=3)
+    parser.add_option('--benchtypes', default=','.join(shootout_benchtypes))
+    parser.add_option('--perf-dir', default=None,
+                      help='checkout of the perf.py benchmarks used in '
+                           'benchmark/appBenchmark.txt')
+    parser.add_option('--app-runs', type='int', default=5)
+    parser.add_option('--affinity', default=None,
+                      help='CPU list to pin the benchmark runs to')
+    parser.add_option('--skip-build', action='store_true', default=False)
+    parser.add_option('--no-pybench', action='store_true', default=False)
+    parser.add_option('--no-shootout', action='store_true', default=False)
+    opts, args = parser.parse_args()
+
+    if os.path.exists(os.path.join(SRCDIR, 'pyconfig.h')):
+        parser.error('the source tree is configured in place; run '
+                     '"make distclean" first so out-of-tree builds work')
+    opts.outdir = os.path.abspath(opts.outdir)
+
+    variants = {}
+    if opts.axis:
+        variants.update(expand_axes(opts.axis))
+    for v in opts.variant:
+        name, _, flags = v.partition('=')
+        variants[name] = [f for f in flags.split(',') if f]
+    if not variants:
+        variants = default_variants
+
+    if not opts.skip_build:
+        print 'Building %d variant(s) in %s ...' % (len(variants), opts.outdir)
+        pool = ThreadPool(opts.jobs)
+        jobs = [(name, flags, opts) for name, flags in variants.items()]
+        for name, error in pool.imap_unordered(build_variant, jobs):
+            if error:
+                print '  %s: %s' % (name, error)
+                del variants[name]
+            else:
+                print '  %s: built with %s' % (name, cflags(variants[name]))
+        pool.close()
+
+    apps = []
+    if opts.perf_dir:
+        apps = read_app_benchmarks()
+
+    results = {}
+    columns = []
+    def record(name, prefix, result):
+        if result is None:
+            return
+        for key in ('min', 'avg'):
+            if key in result:
+                col = '%s.%s' % (prefix, key)
+                results[name][col] = result[key]
+                if col not in columns:
+                    columns.append(col)
+        for key in counter_names:
+            if key in result['counters']:
+                col = '%s.%s' % (prefix, key)
+                results[name][col] = result['counters'][key]
+                if col not in columns:
+                    columns.append(col)
+
+    # Run the benchmarks variant by variant (never in parallel, the
+    # timings would disturb each other).
+    for name in sorted(variants):
+        print 'Benchmarking %s ...' % name
+        results[name] = {'flags': cflags(variants[name])}
+        if not opts.no_pybench:
+            record(name, 'pybench', run_pybench(name, opts))
+        if not opts.no_shootout:
+            for benchtype in opts.benchtypes.split(','):
+                record(name, benchtype, run_shootout(name, benchtype, opts))
+        python = os.path.join(opts.outdir, name, 'python')
+        for app, args in apps:
+            record(name, app, run_app(python, args, opts.perf_dir,
+                                      opts.app_runs))
+
+    print
+    rows = print_table(results, columns)
+    json.dump(results, open(os.path.join(opts.outdir, 'results.json'), 'w'),
+              indent=1, sort_keys=True)
+    out = open(os.path.join(opts.outdir, 'results.csv'), 'w')
+    for row in rows:
+        out.write(','.join(row) + '\n')
+    out.close()
+
+if __name__ == '__main__':
+    main()
@@ -1,6 +1,8 @@
 #include <Python.h>
 typedef PyObject * hash_t;
 #define SETUP \
+    Py_NoSiteFlag = 1; \
+    Py_SetProgramName(argv[0]); \
     Py_Initialize(); \
     hash_t hash = PyDict_New(); \
     PyObject * py_int_value = PyInt_FromLong(0);